@@ -12,6 +12,7 @@
 #include "ofUtils.h"
 #include "ofImage.h"
 #include <algorithm>
+#include <atomic>
 #include <cstdlib>
 #include <fstream>
 
@@ -53,7 +54,7 @@ struct ParsedConfigMetadata {
     std::optional<PerformanceNavigator::GridCoord> explicitGrid;
     PerformanceNavigator::RgbColor color { 128, 128, 128 };
     bool hasExplicitColor { false };
-    std::shared_ptr<ofTexture> thumbnail;
+    std::optional<std::filesystem::path> thumbnailPath;
 };
 
 PerformanceNavigator::RgbColor parseHexColor(const std::string& hex) {
@@ -87,6 +88,25 @@ PerformanceNavigator::RgbColor parseHexColor(const std::string& hex) {
 
 constexpr int MAX_THUMBNAIL_DIM_PX = 256;
 
+// Decode on the encode pool; the texture upload happens in update() on the main thread
+void decodeThumbnail(const std::filesystem::path& path, std::shared_ptr<ofPixels> pixels) {
+    if (!ofLoadImage(*pixels, path)) {
+        ofLogError("PerformanceNavigator") << "Failed to load thumbnail: " << path;
+        pixels->clear();
+        return;
+    }
+    const int w = static_cast<int>(pixels->getWidth());
+    const int h = static_cast<int>(pixels->getHeight());
+    if (w <= 0 || h <= 0) {
+        ofLogError("PerformanceNavigator") << "Invalid thumbnail dimensions: " << path;
+        pixels->clear();
+    } else if (w > MAX_THUMBNAIL_DIM_PX || h > MAX_THUMBNAIL_DIM_PX) {
+        ofLogError("PerformanceNavigator") << "Thumbnail too large (max " << MAX_THUMBNAIL_DIM_PX << "px): "
+                                          << path << " (" << w << "x" << h << ")";
+        pixels->clear();
+    }
+}
+
 std::optional<std::filesystem::path> findThumbnailPath(const std::filesystem::path& configJsonPath) {
     const std::filesystem::path dir = configJsonPath.parent_path();
     const std::string stem = configJsonPath.stem().string();
@@ -136,31 +156,8 @@ ParsedConfigMetadata parseConfigMetadata(const std::filesystem::path& filepath)
             }
         }
 
-        // Optional thumbnail next to config JSON: <stem>.jpg or <stem>.jpeg
-        const auto thumbPathOpt = findThumbnailPath(filepath);
-        if (thumbPathOpt) {
-            ofImage img;
-            if (!img.load(thumbPathOpt->string())) {
-                ofLogError("PerformanceNavigator") << "Failed to load thumbnail: " << *thumbPathOpt;
-            } else {
-                const int w = static_cast<int>(img.getWidth());
-                const int h = static_cast<int>(img.getHeight());
-                if (w <= 0 || h <= 0) {
-                    ofLogError("PerformanceNavigator") << "Invalid thumbnail dimensions: " << *thumbPathOpt;
-                } else if (w > MAX_THUMBNAIL_DIM_PX || h > MAX_THUMBNAIL_DIM_PX) {
-                    ofLogError("PerformanceNavigator") << "Thumbnail too large (max " << MAX_THUMBNAIL_DIM_PX << "px): "
-                                                      << *thumbPathOpt << " (" << w << "x" << h << ")";
-                } else {
-                    auto tex = std::make_shared<ofTexture>();
-                    tex->loadData(img.getPixels());
-                    if (!tex->isAllocated()) {
-                        ofLogError("PerformanceNavigator") << "Failed to upload thumbnail texture: " << *thumbPathOpt;
-                    } else {
-                        meta.thumbnail = tex;
-                    }
-                }
-            }
-        }
+        // Optional thumbnail next to config JSON: <stem>.jpg or <stem>.jpeg (decoded lazily)
+        meta.thumbnailPath = findThumbnailPath(filepath);
     } catch (const std::exception& e) {
         ofLogVerbose("PerformanceNavigator") << "Failed to parse metadata from " << filepath << ": " << e.what();
     }
@@ -174,6 +171,7 @@ void PerformanceNavigator::loadFromFolder(const std::filesystem::path& folder) {
     configs.clear();
     configDescriptions.clear();
     configThumbnails.clear();
+    thumbnailLoads.clear();
     folderPath = folder;
     currentIndex = -1;
 
@@ -212,7 +210,8 @@ void PerformanceNavigator::loadFromFolder(const std::filesystem::path& folder) {
 
         auto meta = parseConfigMetadata(path);
         configDescriptions.push_back(meta.description);
-        configThumbnails.push_back(meta.thumbnail);
+        configThumbnails.push_back(nullptr);
+        thumbnailLoads.push_back({ meta.thumbnailPath.value_or(std::filesystem::path {}) });
         explicitGridCoords.push_back(meta.explicitGrid);
 
         if (meta.hasExplicitColor) {
@@ -335,10 +334,67 @@ const ofTexture* PerformanceNavigator::getConfigThumbnail(int index) const {
     if (index < 0 || index >= static_cast<int>(configThumbnails.size())) {
         return nullptr;
     }
+    requestThumbnail(index);
     const auto& tex = configThumbnails[index];
     return tex ? tex.get() : nullptr;
 }
 
+void PerformanceNavigator::requestThumbnail(int index) const {
+    if (index < 0 || index >= static_cast<int>(thumbnailLoads.size())) return;
+
+    ThumbnailLoad& load = thumbnailLoads[index];
+    if (load.requested || load.path.empty() || !synth || !synth->encodeWorkerPool) return;
+
+    load.requested = true;
+    load.pixels = std::make_shared<ofPixels>();
+    load.done = std::make_shared<std::atomic<bool>>(false);
+    synth->encodeWorkerPool->submit("decode " + load.path.filename().string(),
+                                    [path = load.path, pixels = load.pixels, done = load.done] {
+                                        decodeThumbnail(path, pixels);
+                                        done->store(true);
+                                    });
+}
+
+bool PerformanceNavigator::hasDecodedThumbnails() const {
+    return std::any_of(thumbnailLoads.begin(), thumbnailLoads.end(), [](const ThumbnailLoad& load) {
+        return load.done && load.done->load();
+    });
+}
+
+void PerformanceNavigator::uploadDecodedThumbnail() {
+    for (size_t i = 0; i < thumbnailLoads.size() && i < configThumbnails.size(); ++i) {
+        ThumbnailLoad& load = thumbnailLoads[i];
+        if (!load.done || !load.done->load()) continue;
+
+        if (load.pixels->isAllocated()) {
+            auto tex = std::make_shared<ofTexture>();
+            tex->loadData(*load.pixels);
+            if (!tex->isAllocated()) {
+                ofLogError("PerformanceNavigator") << "Failed to upload thumbnail texture: " << load.path;
+            } else {
+                configThumbnails[i] = tex;
+            }
+        }
+        load.pixels.reset();
+        load.done.reset();
+        return;
+    }
+}
+
+void PerformanceNavigator::reloadThumbnail(const std::filesystem::path& thumbnailPath) {
+    const auto configPath = std::filesystem::path(thumbnailPath).replace_extension(".json");
+    for (size_t i = 0; i < configs.size() && i < thumbnailLoads.size(); ++i) {
+        if (std::filesystem::path(configs[i]) != configPath) continue;
+
+        // Keep showing the old texture until the new one has decoded
+        ThumbnailLoad& load = thumbnailLoads[i];
+        load.path = thumbnailPath;
+        load.requested = false;
+        if (configThumbnails[i]) requestThumbnail(static_cast<int>(i));
+        return;
+    }
+}
+
 bool PerformanceNavigator::hasConfigThumbnail(int index) const {
     const ofTexture* tex = getConfigThumbnail(index);
     return tex != nullptr && tex->isAllocated();
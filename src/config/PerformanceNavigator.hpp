@@ -8,6 +8,7 @@
 #pragma once
 
 #include <array>
+#include <atomic>
 #include <cstdint>
 #include <filesystem>
 #include <memory>
@@ -18,6 +19,8 @@
 
 
 class ofTexture;
+template <typename PixelType> class ofPixels_;
+using ofPixels = ofPixels_<unsigned char>;
 
 namespace ofxMarkSynth {
 
@@ -63,8 +66,11 @@ public:
   std::string getCurrentConfigName() const;
   std::string getConfigName(int index) const;
   std::string getConfigDescription(int index) const;
+  /// Thumbnails are decoded off-thread on first request; nullptr until the texture is ready.
   const ::ofTexture* getConfigThumbnail(int index) const;
   bool hasConfigThumbnail(int index) const;
+  /// A thumbnail (<config stem>.jpg) was (re)written: decode it again
+  void reloadThumbnail(const std::filesystem::path& thumbnailPath);
   const std::filesystem::path& getFolderPath() const { return folderPath; }
 
   // Config grid (used by GUI + controllers)
@@ -91,6 +97,11 @@ public:
   void beginHold(HoldAction action, HoldSource source, int jumpIndex = -1);
   void endHold(HoldSource source);
   void update();  // Check timer, trigger if threshold met
+
+  /// Upload the next decoded thumbnail, if any (one per call, so the Synth can spread uploads
+  /// over frames with headroom)
+  void uploadDecodedThumbnail();
+  bool hasDecodedThumbnails() const;
   
   // For UI drawing
   float getHoldProgress() const;        // 0.0 to 1.0
@@ -134,6 +145,16 @@ private:
   std::vector<std::string> configDescriptions; // Parallel to configs
   std::vector<std::shared_ptr<::ofTexture>> configThumbnails; // Parallel to configs
 
+  // Lazy thumbnail decode state, parallel to configs (mutable: requested from const getters)
+  struct ThumbnailLoad {
+    std::filesystem::path path;             // Empty if the config has no thumbnail
+    bool requested { false };
+    std::shared_ptr<::ofPixels> pixels;     // Filled by the decode job
+    std::shared_ptr<std::atomic<bool>> done;
+  };
+  mutable std::vector<ThumbnailLoad> thumbnailLoads;
+  void requestThumbnail(int index) const;
+
   std::filesystem::path folderPath;
   int currentIndex = -1;                 // -1 means no config loaded
 
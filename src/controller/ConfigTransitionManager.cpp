@@ -4,31 +4,59 @@
 //
 
 #include "controller/ConfigTransitionManager.hpp"
+#include "rendering/FboCopy.hpp"
 
 #include "ofGraphics.h"
 #include "ofUtils.h"
 #include "glm/glm.hpp"
+#include <algorithm>
+#include <cmath>
 
 namespace ofxMarkSynth {
 
-void ConfigTransitionManager::captureSnapshot(const ofFbo& sourceFbo) {
-    float w = sourceFbo.getWidth();
-    float h = sourceFbo.getHeight();
-    
-    // Allocate snapshot FBO if needed
-    if (!snapshotFbo.isAllocated() ||
-        snapshotFbo.getWidth() != w ||
-        snapshotFbo.getHeight() != h) {
-        snapshotFbo.allocate(w, h, GL_RGB16F);
+void ConfigTransitionManager::allocate(glm::vec2 compositeSize) {
+    allocateSnapshot(compositeSize.x, compositeSize.y, GL_RGB16F);
+}
+
+bool ConfigTransitionManager::allocateSnapshot(float sourceWidth, float sourceHeight, GLint internalFormat) {
+    int w = std::max(1, static_cast<int>(std::lround(sourceWidth * SNAPSHOT_SCALE)));
+    int h = std::max(1, static_cast<int>(std::lround(sourceHeight * SNAPSHOT_SCALE)));
+
+    if (snapshotFbo.isAllocated() &&
+        snapshotFbo.getWidth() == w &&
+        snapshotFbo.getHeight() == h &&
+        snapshotFbo.getTexture().getTextureData().glInternalFormat == internalFormat) {
+        return true;
+    }
+
+    auto& registry = GpuMemoryRegistry::instance();
+    snapshotMemory.release();
+    const float budgetScale = registry.admit("ConfigTransitionManager", "snapshot",
+                                             GpuMemoryRegistry::estimateBytes(w, h, internalFormat), false);
+    if (budgetScale <= 0.0f) {
+        snapshotFbo.clear();
+        snapshotCaptured = false;
+        return false;
     }
-    
-    snapshotFbo.begin();
-    {
-        ofClear(0, 0, 0, 255);
-        ofSetColor(255);
-        sourceFbo.draw(0, 0);
+    w = std::max(1, static_cast<int>(w * budgetScale));
+    h = std::max(1, static_cast<int>(h * budgetScale));
+
+    // Blit requires matching color formats (both float here); linear filtering upsamples on output.
+    snapshotFbo.allocate(w, h, internalFormat);
+    snapshotMemory = registry.addFbo("ConfigTransitionManager", "snapshot", snapshotFbo);
+    snapshotCaptured = false;
+    return true;
+}
+
+void ConfigTransitionManager::captureSnapshot(const ofFbo& sourceFbo) {
+    if (!sourceFbo.isAllocated()) return;
+
+    if (!allocateSnapshot(sourceFbo.getWidth(), sourceFbo.getHeight(),
+                          sourceFbo.getTexture().getTextureData().glInternalFormat)) {
+        return;
     }
-    snapshotFbo.end();
+    fboCopyBlitScaled(sourceFbo, snapshotFbo);
+    snapshotCaptured = true;
 }
 
 void ConfigTransitionManager::beginTransition() {
@@ -114,7 +142,7 @@ const ofFbo& ConfigTransitionManager::getSnapshotFbo() const {
 }
 
 bool ConfigTransitionManager::hasValidSnapshot() const {
-    return snapshotFbo.isAllocated();
+    return snapshotCaptured && snapshotFbo.isAllocated();
 }
 
 ofParameter<float>& ConfigTransitionManager::getDurationParameter() {
@@ -5,8 +5,10 @@
 
 #pragma once
 
+#include "rendering/GpuMemoryRegistry.hpp"
 #include "ofFbo.h"
 #include "ofParameter.h"
+#include "glm/vec2.hpp"
 
 namespace ofxMarkSynth {
 
@@ -21,7 +23,11 @@ public:
 
     ConfigTransitionManager() = default;
 
-    /// Capture the current frame from source FBO before config switch
+    /// Pre-allocate the snapshot FBO so the first transition doesn't pay for allocation.
+    void allocate(glm::vec2 compositeSize);
+
+    /// Capture the current frame from source FBO before config switch.
+    /// Blits (no draw) into a snapshot at SNAPSHOT_SCALE of the source size.
     void captureSnapshot(const ofFbo& sourceFbo);
 
     /// Begin the crossfade transition
@@ -54,9 +60,17 @@ public:
     ofParameter<float>& getDelaySecParameter();
     const ofParameter<float>& getDelaySecParameter() const;
 
+    // The snapshot is only seen while fading out, so it doesn't need full resolution.
+    static constexpr float SNAPSHOT_SCALE { 0.5f };
+
 private:
+    /// Returns false if the GPU memory budget refused the snapshot (transitions then cut).
+    bool allocateSnapshot(float sourceWidth, float sourceHeight, GLint internalFormat);
+
     State state { State::NONE };
     ofFbo snapshotFbo;
+    GpuMemoryRegistry::Registration snapshotMemory;
+    bool snapshotCaptured { false };
     float startTime { 0.0f };
     float snapshotWeight { 1.0f };
     float liveWeight { 0.0f };
@@ -0,0 +1,97 @@
+//
+//  DeferredTaskScheduler.cpp
+//  ofxMarkSynth
+//
+
+#include "controller/DeferredTaskScheduler.hpp"
+#include <algorithm>
+#include <utility>
+
+namespace ofxMarkSynth {
+
+static float secondsBetween(std::chrono::steady_clock::time_point from, std::chrono::steady_clock::time_point to) {
+    return std::chrono::duration<float>(to - from).count();
+}
+
+void DeferredTaskScheduler::beginFrame() {
+    frameStart = Clock::now();
+}
+
+void DeferredTaskScheduler::defer(const std::string& name, float maxDelaySecs, Task task) {
+    if (isPending(name)) return;
+    const auto delay = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<float>(std::max(0.0f, maxDelaySecs)));
+    tasks.push_back({ name, Clock::now() + delay, std::move(task) });
+}
+
+bool DeferredTaskScheduler::isPending(const std::string& name) const {
+    return std::any_of(tasks.begin(), tasks.end(), [&name](const PendingTask& t) { return t.name == name; });
+}
+
+void DeferredTaskScheduler::cancel(const std::string& name) {
+    std::erase_if(tasks, [&name](const PendingTask& t) { return t.name == name; });
+}
+
+void DeferredTaskScheduler::run(float targetFrameRate) {
+    if (tasks.empty()) return;
+    if (targetFrameRate <= 0.0f) {
+        flush();
+        return;
+    }
+
+    // Move ready tasks out first: a task may defer() another
+    const auto now = Clock::now();
+    std::vector<PendingTask> ready;
+    for (auto it = tasks.begin(); it != tasks.end();) {
+        if (it->deadline <= now) {
+            ready.push_back(std::move(*it));
+            it = tasks.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    if (ready.empty() && !tasks.empty()) {
+        auto soonest = std::min_element(tasks.begin(), tasks.end(), [](const PendingTask& a, const PendingTask& b) {
+            return a.deadline < b.deadline;
+        });
+        const float budgetSecs = (1.0f - RESERVE_FRACTION) / targetFrameRate;
+        if (secondsBetween(frameStart, now) + getCostEstimate(soonest->name) <= budgetSecs) {
+            ready.push_back(std::move(*soonest));
+            tasks.erase(soonest);
+        }
+    }
+
+    runTasks(ready);
+}
+
+void DeferredTaskScheduler::flush() {
+    std::vector<PendingTask> ready = std::exchange(tasks, {});
+    runTasks(ready);
+}
+
+void DeferredTaskScheduler::flush(const std::string& name) {
+    auto it = std::find_if(tasks.begin(), tasks.end(), [&name](const PendingTask& t) { return t.name == name; });
+    if (it == tasks.end()) return;
+    std::vector<PendingTask> ready;
+    ready.push_back(std::move(*it));
+    tasks.erase(it);
+    runTasks(ready);
+}
+
+void DeferredTaskScheduler::runTasks(std::vector<PendingTask>& ready) {
+    for (auto& pending : ready) {
+        const auto start = Clock::now();
+        pending.task();
+        const float cost = secondsBetween(start, Clock::now());
+
+        auto [it, inserted] = costEstimateSecs.try_emplace(pending.name, cost);
+        if (!inserted) it->second += COST_SMOOTHING * (cost - it->second);
+    }
+}
+
+float DeferredTaskScheduler::getCostEstimate(const std::string& name) const {
+    auto it = costEstimateSecs.find(name);
+    return it == costEstimateSecs.end() ? 0.0f : it->second;
+}
+
+} // namespace ofxMarkSynth
@@ -0,0 +1,71 @@
+//
+//  DeferredTaskScheduler.hpp
+//  ofxMarkSynth
+//
+
+#pragma once
+
+#include <chrono>
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace ofxMarkSynth {
+
+/// Spreads occasional main-thread GL jobs (still saves, side-panel refreshes, memory auto-capture,
+/// thumbnail uploads) over frames that have headroom against the target frame time, instead of
+/// running them on whichever frame they come due. Each job has a deadline after which it runs
+/// regardless, so nothing is dropped unless cancelled. Only one job that is not yet overdue runs per frame.
+/// Costs are measured as CPU time around the job, which understates any GPU work it queues; the
+/// one-per-frame limit keeps that bounded.
+class DeferredTaskScheduler {
+public:
+    using Task = std::function<void()>;
+
+    /// Share of the frame kept back for work after run() (GUI, buffer swap)
+    static constexpr float RESERVE_FRACTION = 0.25f;
+    /// Weight of the newest sample in each task's cost estimate
+    static constexpr float COST_SMOOTHING = 0.25f;
+
+    DeferredTaskScheduler() = default;
+    DeferredTaskScheduler(const DeferredTaskScheduler&) = delete;
+    DeferredTaskScheduler& operator=(const DeferredTaskScheduler&) = delete;
+
+    /// Call at the start of each frame, before any of its work
+    void beginFrame();
+
+    /// Queue `task` to run on a frame with headroom, or once `maxDelaySecs` have passed.
+    /// Ignored while a task with the same name is queued (that one keeps its deadline).
+    void defer(const std::string& name, float maxDelaySecs, Task task);
+    bool isPending(const std::string& name) const;
+    /// Drop the queued task with this name, if any, without running it
+    void cancel(const std::string& name);
+
+    /// Run overdue tasks; if there are none, run the task due soonest when its recent cost fits
+    /// in what is left of the frame. With no target frame rate (<= 0) every queued task runs.
+    void run(float targetFrameRate);
+
+    /// Run every queued task now
+    void flush();
+    /// Run the queued task with this name now, if any (for shutdown, where only some jobs matter)
+    void flush(const std::string& name);
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct PendingTask {
+        std::string name;
+        Clock::time_point deadline;
+        Task task;
+    };
+
+    std::vector<PendingTask> tasks;
+    std::unordered_map<std::string, float> costEstimateSecs;
+    Clock::time_point frameStart { Clock::now() };
+
+    void runTasks(std::vector<PendingTask>& ready);
+    float getCostEstimate(const std::string& name) const;
+};
+
+} // namespace ofxMarkSynth
@@ -14,8 +14,17 @@ DrawingLayerPtr LayerController::addLayer(const std::string& name, const std::st
                                           bool useStencil, int numSamples,
                                           bool isDrawn, bool isOverlay,
                                           const std::string& description) {
+    // PingPongFbo: two buffers, each multisampled when numSamples > 0
+    const int copies = 2 * std::max(1, numSamples);
+    auto& registry = GpuMemoryRegistry::instance();
+    layerMemory.erase(name);
+    const float budgetScale = registry.admit("Layer " + name, "fbo",
+                                             GpuMemoryRegistry::estimateBytes(size.x, size.y, internalFormat, copies), true);
+    size = glm::max(glm::floor(size * budgetScale), glm::vec2 { 1.0f });
+
     auto fboPtr = std::make_shared<PingPongFbo>();
     fboPtr->allocate(size, internalFormat, wrap, useStencil, numSamples);
+    layerMemory[name] = registry.add("Layer " + name, "fbo", size.x, size.y, internalFormat, copies);
     fboPtr->clearFloat(ofFloatColor(0, 0, 0, 0));
     
     auto layerPtr = std::make_shared<DrawingLayer>(name, tag, fboPtr, clearOnUpdate,
@@ -100,9 +109,23 @@ void LayerController::updatePauseStates() {
     }
 }
 
+void LayerController::updateVisibility() {
+    // Alpha parameters exist only for drawn layers, in layer order
+    size_t i = 0;
+    for (auto& [name, layerPtr] : layers) {
+        if (!layerPtr->isDrawn || i >= alphaParamPtrs.size()) {
+            layerPtr->isVisible = true;
+            continue;
+        }
+        layerPtr->isVisible = alphaParamPtrs[i]->get() > 0.0f;
+        ++i;
+    }
+}
+
 void LayerController::clearActiveLayers(const ofFloatColor& clearColor) {
     for (auto& [name, layerPtr] : layers) {
-        if (layerPtr->clearOnUpdate && layerPtr->pauseState != DrawingLayer::PauseState::PAUSED) {
+        if (layerPtr->clearOnUpdate && layerPtr->pauseState != DrawingLayer::PauseState::PAUSED
+            && layerPtr->isVisible) {
             layerPtr->fboPtr->getSource().begin();
             ofClear(clearColor);
             layerPtr->fboPtr->getSource().end();
@@ -112,6 +135,7 @@ void LayerController::clearActiveLayers(const ofFloatColor& clearColor) {
 
 void LayerController::clear() {
     layers.clear();
+    layerMemory.clear();
     initialAlphas.clear();
     initialPaused.clear();
     alphaParamPtrs.clear();
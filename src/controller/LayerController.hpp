@@ -7,6 +7,7 @@
 
 #include "core/Mod.hpp"
 #include "util/OrderedMap.h"
+#include "rendering/GpuMemoryRegistry.hpp"
 #include "ofParameter.h"
 #include <unordered_map>
 
@@ -19,7 +20,8 @@ class LayerController {
 public:
     LayerController() = default;
 
-    /// Create and add a new drawing layer
+    /// Create and add a new drawing layer. Under a GPU memory budget with the Downscale policy the
+    /// layer may be allocated smaller than `size`.
     DrawingLayerPtr addLayer(const std::string& name, const std::string& tag, glm::vec2 size,
                              GLint internalFormat, int wrap,
                              bool clearOnUpdate, ofBlendMode blendMode,
@@ -42,7 +44,11 @@ public:
     /// Update layer pause states from parameters (call each frame)
     void updatePauseStates();
 
-    /// Clear FBOs for active (non-paused) layers with clearOnUpdate flag
+    /// Mark drawn layers with zero alpha invisible, so Mods skip drawing on them (call each frame,
+    /// then let Mods that read layers mark theirs visible again)
+    void updateVisibility();
+
+    /// Clear FBOs for active (non-paused, visible) layers with clearOnUpdate flag
     void clearActiveLayers(const ofFloatColor& clearColor);
 
     /// Clear all layers and parameters (for config unload)
@@ -63,6 +69,7 @@ public:
 
 private:
     DrawingLayerPtrMap layers;
+    std::unordered_map<std::string, GpuMemoryRegistry::Registration> layerMemory;
     std::unordered_map<std::string, float> initialAlphas;
     std::unordered_map<std::string, bool> initialPaused;
 
@@ -8,6 +8,8 @@
 #include "controller/MemoryBankController.hpp"
 
 #include "core/Intent.hpp"
+#include "rendering/DensityMetrics.hpp"
+#include "rendering/DensityReducer.hpp"
 #include "ofGraphics.h"
 #include "ofLog.h"
 #include "ofMath.h"
@@ -29,53 +31,9 @@ namespace {
 static constexpr int AUTO_CAPTURE_MIN_FRAMES_TO_WAIT = 2;
 static constexpr int AUTO_CAPTURE_MAX_FRAMES_BEFORE_ABANDON = 60;
 
-struct DensityMetrics {
-    float variance { 0.0f };
-    float activeFraction { 0.0f };
-};
-
-static float computeLuma01(unsigned char r, unsigned char g, unsigned char b) {
-    // Rec. 709 luma
-    return (0.2126f * (static_cast<float>(r) / 255.0f))
-        + (0.7152f * (static_cast<float>(g) / 255.0f))
-        + (0.0722f * (static_cast<float>(b) / 255.0f));
-}
-
-static DensityMetrics computeDensityMetricsRgb(const std::vector<unsigned char>& rgb, int size, float activeEpsilon) {
-    const int nPix = size * size;
-    if (nPix <= 0 || static_cast<int>(rgb.size()) < nPix * 3) {
-        return {};
-    }
-
-    double mean = 0.0;
-    for (int i = 0; i < nPix; ++i) {
-        const unsigned char r = rgb[i * 3 + 0];
-        const unsigned char g = rgb[i * 3 + 1];
-        const unsigned char b = rgb[i * 3 + 2];
-        mean += computeLuma01(r, g, b);
-    }
-    mean /= static_cast<double>(nPix);
-
-    double var = 0.0;
-    int activeCount = 0;
-    for (int i = 0; i < nPix; ++i) {
-        const unsigned char r = rgb[i * 3 + 0];
-        const unsigned char g = rgb[i * 3 + 1];
-        const unsigned char b = rgb[i * 3 + 2];
-        float y = computeLuma01(r, g, b);
-        float d = y - static_cast<float>(mean);
-        var += static_cast<double>(d) * static_cast<double>(d);
-
-        if (std::abs(d) > activeEpsilon) {
-            activeCount++;
-        }
-    }
-
-    DensityMetrics out;
-    out.variance = static_cast<float>(var / static_cast<double>(nPix));
-    out.activeFraction = static_cast<float>(activeCount) / static_cast<float>(nPix);
-    return out;
-}
+// Per-pixel luma deviation needed to count as "active". Keep this fairly low so sparse-but-visible
+// content still counts.
+static constexpr float AUTO_CAPTURE_ACTIVE_EPSILON = 0.02f;
 
 static float computeQualityScore(const DensityMetrics& metrics) {
     // Simple but effective: rewards both coverage (activeFraction) and texture (variance).
@@ -87,14 +45,34 @@ static float jitteredInterval(float intervalSec, float jitterFraction = 0.15f) {
     return std::max(0.0f, intervalSec + ofRandom(-jitter, jitter));
 }
 
+// Slot layout: the first 3/8 of the bank is the long band, the next 3/8 mid, the rest recent
+// (0-2 long, 3-5 mid, 6-7 recent for an 8-slot bank).
+static int getBandForSlot(int slot, int slotCount) {
+    if (slot < slotCount * 3 / 8) return 0;
+    if (slot < slotCount * 6 / 8) return 1;
+    return 2;
+}
+
+static int getBandSlotCount(int band, int slotCount) {
+    const int longCount = slotCount * 3 / 8;
+    const int midCount = slotCount * 6 / 8 - longCount;
+    if (band == 0) return longCount;
+    if (band == 1) return midCount;
+    return slotCount - longCount - midCount;
+}
+
 static float getTimeBandIntervalSec(int slot,
+                                   int slotCount,
                                    float recentIntervalSec,
                                    float midIntervalSec,
                                    float longIntervalSec) {
-    // Slot layout: 0-2 long, 3-5 mid, 6-7 recent.
-    if (slot <= 2) return longIntervalSec;
-    if (slot <= 5) return midIntervalSec;
-    return recentIntervalSec;
+    const int band = getBandForSlot(slot, slotCount);
+    const float interval = (band == 0) ? longIntervalSec : (band == 1) ? midIntervalSec : recentIntervalSec;
+
+    // The intervals are tuned for 3/3/2 slots per band. Larger bands revisit each slot proportionally
+    // less often, so the capture rate stays the same and the extra slots reach further back instead.
+    constexpr int referenceBandSlotCounts[3] = { 3, 3, 2 };
+    return interval * static_cast<float>(getBandSlotCount(band, slotCount)) / static_cast<float>(referenceBandSlotCounts[band]);
 }
 
 } // namespace
@@ -113,6 +91,13 @@ struct MemoryBankAutoCaptureState {
 
     std::vector<unsigned char> pixels;
 
+    // GPU reduction (MemoryAutoCaptureGpuMetricsSize > 0): only the metrics are read back
+    DensityReducer gpuReducer;
+    int gpuReducerRequestedSize { 0 };
+    bool analysisOnGpu { false };  // Whether the analysis in flight is a GPU reduction
+    DensityMetrics gpuMetrics;
+    uint64_t gpuHash { 0 };
+
     float nextAttemptTimeSec { 0.0f };
     std::vector<float> nextSlotDueTimeSec;
 
@@ -120,27 +105,30 @@ struct MemoryBankAutoCaptureState {
     glm::vec2 pendingCropTopLeft { 0.0f, 0.0f };
     glm::vec2 pendingCropSize { 0.0f, 0.0f };
 
-    std::array<float, MemoryBank::NUM_SLOTS> slotCaptureTimeSec;
-    std::array<float, MemoryBank::NUM_SLOTS> slotVariance;
-    std::array<float, MemoryBank::NUM_SLOTS> slotActiveFraction;
-    std::array<float, MemoryBank::NUM_SLOTS> slotQualityScore;
+    int slotCount { 0 };
+    std::vector<float> slotCaptureTimeSec;
+    std::vector<float> slotVariance;
+    std::vector<float> slotActiveFraction;
+    std::vector<float> slotQualityScore;
+    std::vector<uint64_t> slotHash;
+    std::vector<bool> slotHashKnown;  // False for manual saves, promotions and loaded memories
+    int dedupedCaptureCount { 0 };
 
     int lockedAnchorSlot { -1 };
 
-    MemoryBankAutoCaptureState() {
-        slotCaptureTimeSec.fill(-1.0f);
-        slotVariance.fill(-1.0f);
-        slotActiveFraction.fill(-1.0f);
-        slotQualityScore.fill(-1.0f);
-    }
+    explicit MemoryBankAutoCaptureState(int slotCount_)
+        : slotCount(slotCount_),
+          slotCaptureTimeSec(slotCount_, -1.0f),
+          slotVariance(slotCount_, -1.0f),
+          slotActiveFraction(slotCount_, -1.0f),
+          slotQualityScore(slotCount_, -1.0f),
+          slotHash(slotCount_, 0),
+          slotHashKnown(slotCount_, false) {}
+
+    /// True once the steady (post-warmup) schedule has been initialised
+    bool hasSteadySchedule() const { return static_cast<int>(nextSlotDueTimeSec.size()) == slotCount; }
 };
 
-int MemoryBankController::getBandForSlot(int slot) {
-    if (slot <= 2) return 0;
-    if (slot <= 5) return 1;
-    return 2;
-}
-
 MemoryBankController::MemoryBankController() = default;
 
 MemoryBankController::~MemoryBankController() {
@@ -150,9 +138,9 @@ MemoryBankController::~MemoryBankController() {
     }
 }
 
-void MemoryBankController::allocate(glm::vec2 memorySize) {
+void MemoryBankController::allocate(glm::vec2 memorySize, int slotCount) {
     // Memories should be opaque; store as RGB to avoid alpha channel artifacts.
-    memoryBank.allocate(memorySize, GL_RGB8);
+    memoryBank.allocate(memorySize, slotCount, GL_RGB8);
 
     autoCaptureState.reset();
 }
@@ -187,6 +175,8 @@ void MemoryBankController::buildParameterGroup() {
 
     parameters.add(autoCaptureWarmupBurstCountParameter);
     parameters.add(autoCaptureAnalysisSizeParameter);
+    parameters.add(autoCaptureGpuMetricsSizeParameter);
+    parameters.add(autoCaptureDedupeDistanceParameter);
 }
 
 MemoryBankController::EmitResult MemoryBankController::emitWithRateLimit(const ofTexture* tex) {
@@ -215,18 +205,20 @@ void MemoryBankController::noteManualSaveSlot(int slot) {
     // We still record capture time so tooltips/debug make sense, but leave quality unknown so
     // the auto-capture upgrader can replace low-quality placeholders when denser moments arrive.
     if (!autoCaptureState) {
-        autoCaptureState = std::make_unique<MemoryBankAutoCaptureState>();
+        autoCaptureState = std::make_unique<MemoryBankAutoCaptureState>(memoryBank.getSlotCount());
     }
 
-    if (slot < 0 || slot >= MemoryBank::NUM_SLOTS) return;
+    if (slot < 0 || slot >= autoCaptureState->slotCount) return;
 
     MemoryBankAutoCaptureState& state = *autoCaptureState;
     state.slotCaptureTimeSec[slot] = lastSynthRunningTimeSec;
     state.slotVariance[slot] = -1.0f;
     state.slotActiveFraction[slot] = -1.0f;
     state.slotQualityScore[slot] = -1.0f;
+    state.slotHashKnown[slot] = false;
+    memoryBank.setSlotInfo(slot, lastSynthRunningTimeSec, -1.0f);
 
-    if (state.nextSlotDueTimeSec.size() == MemoryBank::NUM_SLOTS) {
+    if (state.hasSteadySchedule()) {
         // Encourage an upgrade pass sooner rather than waiting for the full band cadence.
         state.nextSlotDueTimeSec[slot] = std::min(state.nextSlotDueTimeSec[slot],
                                                  lastSynthRunningTimeSec + autoCaptureLowQualityRetrySecParameter);
@@ -245,7 +237,7 @@ MemoryBankController::EmitResult MemoryBankController::handleSink(int sinkId,
             return { nullptr, false };
 
         case SINK_MEMORY_SAVE_SLOT: {
-            int slot = static_cast<int>(value) % MemoryBank::NUM_SLOTS;
+            int slot = static_cast<int>(value) % memoryBank.getSlotCount();
             memoryBank.saveToSlot(compositeFbo, slot);
             noteManualSaveSlot(slot);
             return { nullptr, false };
@@ -258,7 +250,7 @@ MemoryBankController::EmitResult MemoryBankController::handleSink(int sinkId,
             return { nullptr, false };
 
         case SINK_MEMORY_EMIT_SLOT: {
-            int slot = static_cast<int>(value) % MemoryBank::NUM_SLOTS;
+            int slot = static_cast<int>(value) % memoryBank.getSlotCount();
             return emitWithRateLimit(memoryBank.get(slot));
         }
 
@@ -372,6 +364,12 @@ MemoryBankController::EmitResult MemoryBankController::handleSink(int sinkId,
             autoCaptureRelImproveLongParameter.set(std::max(0.0f, value));
             return { nullptr, false };
 
+        case SINK_MEMORY_RECALL_ARCHIVED:
+            if (value > 0.5f) {
+                recallArchived();
+            }
+            return { nullptr, false };
+
         default:
             return { nullptr, false };
     }
@@ -401,36 +399,104 @@ void MemoryBankController::update(const ofFbo& compositeFbo,
         noteManualSaveSlot(pendingSlot);
     }
 
-    updateAutoCapture(compositeFbo, synthRunningTimeSec);
+    memoryBank.updateLoadAll();
+    memoryBank.updateArchive();
+    memoryBank.updateMips();
+    applyPromotedSlots();
+
+    if (auto result = memoryBank.updateSaveAll()) {
+        lastSaveAllResult = std::move(result);
+    }
 
-    if (memorySaveAllRequested) {
+    // A request made while a save is still encoding waits for it, so the newer state is what ends up on disk.
+    // It also waits for any load, which would otherwise delete the PNGs of slots that haven't arrived yet.
+    if (memorySaveAllRequested && !memoryBank.isSaveAllInProgress() && !memoryBank.isLoadAllInProgress()) {
         memorySaveAllRequested = false;
         if (configRootPath.empty()) {
             ofLogWarning("MemoryBankController") << "Cannot save global memory bank: config root not set";
         } else {
             const std::filesystem::path folder = configRootPath / "memory" / "global";
-            memoryBank.saveAllToFolder(folder);
+            memoryBank.beginSaveAllToFolder(folder, encodePool);
         }
     }
 }
 
+void MemoryBankController::setupArchive(const std::filesystem::path& spillFolder, size_t ramBudgetBytes, int maxDiskEntries) {
+    memoryBank.setupArchive(spillFolder, ramBudgetBytes, maxDiskEntries, encodePool);
+}
+
+bool MemoryBankController::recallArchived() {
+    const std::vector<MemoryArchive::EntryInfo> entries = memoryBank.getArchive().getEntries();
+    if (entries.empty()) return false;
+
+    // Centre 0 = oldest capture, 1 = newest
+    const int maxIndex = static_cast<int>(entries.size()) - 1;
+    const float halfSpread = emitWidthController.value * 0.5f;
+    const float selected = (emitCentreController.value + ofRandom(-halfSpread, halfSpread)) * static_cast<float>(maxIndex);
+    const int index = std::clamp(static_cast<int>(std::round(selected)), 0, maxIndex);
+
+    // Replace the weakest long-band memory (empty slots first); the anchor stays.
+    const int slotCount = memoryBank.getSlotCount();
+    int targetSlot = -1;
+    float targetQuality = std::numeric_limits<float>::infinity();
+    for (int slot = 0; slot < slotCount && getBandForSlot(slot, slotCount) == 0; ++slot) {
+        if (autoCaptureState && autoCaptureState->lockedAnchorSlot == slot) continue;
+
+        float q = -2.0f;
+        if (memoryBank.isOccupied(slot)) {
+            q = autoCaptureState ? autoCaptureState->slotQualityScore[slot] : -1.0f;
+        }
+        if (targetSlot < 0 || q < targetQuality) {
+            targetSlot = slot;
+            targetQuality = q;
+        }
+    }
+    if (targetSlot < 0) return false;
+
+    return memoryBank.requestPromotion(entries[index].id, targetSlot);
+}
+
+void MemoryBankController::applyPromotedSlots() {
+    const std::vector<MemoryBank::PromotedSlot> promoted = memoryBank.takePromotedSlots();
+    if (promoted.empty()) return;
+
+    if (!autoCaptureState) {
+        autoCaptureState = std::make_unique<MemoryBankAutoCaptureState>(memoryBank.getSlotCount());
+    }
+    MemoryBankAutoCaptureState& state = *autoCaptureState;
+    for (const auto& p : promoted) {
+        if (p.slot < 0 || p.slot >= state.slotCount) continue;
+        state.slotCaptureTimeSec[p.slot] = p.captureTimeSec;
+        state.slotVariance[p.slot] = -1.0f;
+        state.slotActiveFraction[p.slot] = -1.0f;
+        state.slotQualityScore[p.slot] = p.qualityScore;
+        state.slotHashKnown[p.slot] = false;
+    }
+}
+
+void MemoryBankController::flushSaveAll() {
+    if (auto result = memoryBank.flushSaveAll()) {
+        lastSaveAllResult = std::move(result);
+    }
+}
+
 static void initSteadyDueTimes(MemoryBankAutoCaptureState& state,
                               float nowSec,
                               float recentIntervalSec,
                               float midIntervalSec,
                               float longIntervalSec) {
-    if (state.nextSlotDueTimeSec.size() != MemoryBank::NUM_SLOTS) {
-        state.nextSlotDueTimeSec.assign(MemoryBank::NUM_SLOTS, 0.0f);
+    if (!state.hasSteadySchedule()) {
+        state.nextSlotDueTimeSec.assign(state.slotCount, 0.0f);
     }
 
-    for (int slot = 0; slot < MemoryBank::NUM_SLOTS; ++slot) {
-        float interval = getTimeBandIntervalSec(slot, recentIntervalSec, midIntervalSec, longIntervalSec);
+    for (int slot = 0; slot < state.slotCount; ++slot) {
+        float interval = getTimeBandIntervalSec(slot, state.slotCount, recentIntervalSec, midIntervalSec, longIntervalSec);
         state.nextSlotDueTimeSec[slot] = nowSec + jitteredInterval(interval);
     }
 }
 
 static bool ensureAnalysisAllocated(MemoryBankAutoCaptureState& state, int analysisSize) {
-    analysisSize = std::clamp(analysisSize, 8, 128);
+    analysisSize = std::clamp(analysisSize, 8, 256);
 
     if (state.analysisSize == analysisSize && state.analysisFbo.isAllocated()) {
         return true;
@@ -446,35 +512,57 @@ static bool ensureAnalysisAllocated(MemoryBankAutoCaptureState& state, int analy
     return state.analysisFbo.isAllocated();
 }
 
+// Reallocate (and revalidate) the GPU reduction when its size changes; 0 uses the CPU readback.
+// A size that fails validation isn't retried until the parameter changes.
+static void ensureGpuReducerAllocated(MemoryBankAutoCaptureState& state, int gpuSize) {
+    if (state.state != MemoryBankAutoCaptureState::State::IDLE) return;
+    if (state.gpuReducerRequestedSize == gpuSize) return;
+
+    state.gpuReducerRequestedSize = gpuSize;
+    if (gpuSize <= 0) {
+        state.gpuReducer.release();
+        return;
+    }
+    if (!state.gpuReducer.allocate(gpuSize, AUTO_CAPTURE_ACTIVE_EPSILON)) {
+        ofLogWarning("MemoryBankController") << "GPU auto-capture metrics unavailable; using the "
+                                             << state.analysisSize << "px CPU readback";
+    }
+}
+
 static void beginAnalysis(MemoryBankAutoCaptureState& state,
                          const ofFbo& compositeFbo,
                          glm::vec2 cropTopLeft,
                          glm::vec2 cropSize) {
-    if (!state.analysisFbo.isAllocated()) return;
-
-    const int sz = state.analysisSize;
-
-    state.analysisFbo.begin();
-    ofClear(0, 0, 0, 255);
-    ofPushStyle();
-    ofEnableBlendMode(OF_BLENDMODE_DISABLED);
-    ofSetColor(255);
-    compositeFbo.getTexture().drawSubsection(0,
-                                            0,
-                                            static_cast<float>(sz),
-                                            static_cast<float>(sz),
-                                            cropTopLeft.x,
-                                            cropTopLeft.y,
-                                            cropSize.x,
-                                            cropSize.y);
-    ofPopStyle();
-    state.analysisFbo.end();
-
-    glBindFramebuffer(GL_READ_FRAMEBUFFER, state.analysisFbo.getId());
-    glBindBuffer(GL_PIXEL_PACK_BUFFER, state.pbo.getId());
-    glReadPixels(0, 0, sz, sz, GL_RGB, GL_UNSIGNED_BYTE, 0);
-    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
-    glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+    state.analysisOnGpu = state.gpuReducer.isAllocated();
+    if (state.analysisOnGpu) {
+        state.gpuReducer.reduce(compositeFbo.getTexture(), cropTopLeft, cropSize, AUTO_CAPTURE_ACTIVE_EPSILON);
+    } else {
+        if (!state.analysisFbo.isAllocated()) return;
+
+        const int sz = state.analysisSize;
+
+        state.analysisFbo.begin();
+        ofClear(0, 0, 0, 255);
+        ofPushStyle();
+        ofEnableBlendMode(OF_BLENDMODE_DISABLED);
+        ofSetColor(255);
+        compositeFbo.getTexture().drawSubsection(0,
+                                                0,
+                                                static_cast<float>(sz),
+                                                static_cast<float>(sz),
+                                                cropTopLeft.x,
+                                                cropTopLeft.y,
+                                                cropSize.x,
+                                                cropSize.y);
+        ofPopStyle();
+        state.analysisFbo.end();
+
+        glBindFramebuffer(GL_READ_FRAMEBUFFER, state.analysisFbo.getId());
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, state.pbo.getId());
+        glReadPixels(0, 0, sz, sz, GL_RGB, GL_UNSIGNED_BYTE, 0);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+        glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+    }
 
     if (state.fence) {
         glDeleteSync(state.fence);
@@ -498,6 +586,14 @@ static bool pollAnalysis(MemoryBankAutoCaptureState& state) {
 
     GLenum result = glClientWaitSync(state.fence, 0, 0);
     if (result == GL_ALREADY_SIGNALED || result == GL_CONDITION_SATISFIED) {
+        if (state.analysisOnGpu) {
+            state.gpuMetrics = state.gpuReducer.readMetrics(&state.gpuHash);
+            glDeleteSync(state.fence);
+            state.fence = nullptr;
+            state.state = MemoryBankAutoCaptureState::State::IDLE;
+            return true;
+        }
+
         const int sz = state.analysisSize;
         size_t bytes = static_cast<size_t>(sz) * static_cast<size_t>(sz) * 3;
 
@@ -528,6 +624,42 @@ static bool pollAnalysis(MemoryBankAutoCaptureState& state) {
     return false;
 }
 
+static DensityMetrics computeDensityMetrics(MemoryBankAutoCaptureState& state, float activeEpsilon) {
+    if (state.analysisOnGpu) {
+        return state.gpuMetrics;
+    }
+
+    const size_t pixelCount = static_cast<size_t>(state.analysisSize) * static_cast<size_t>(state.analysisSize);
+    if (pixelCount == 0 || state.pixels.size() < pixelCount * 3) {
+        return {};
+    }
+
+    return computeDensityMetricsRgb8(state.pixels.data(), pixelCount, activeEpsilon);
+}
+
+static uint64_t computeAnalysisHash(const MemoryBankAutoCaptureState& state) {
+    if (state.analysisOnGpu) {
+        return state.gpuHash;
+    }
+    return computePerceptualHashRgb8(state.pixels.data(), state.analysisSize);
+}
+
+// The occupied slot whose hash is closest to `hash`, if it's within `maxDistance` bits; -1 otherwise.
+static int findDuplicateSlot(const MemoryBankAutoCaptureState& state, const MemoryBank& memoryBank,
+                             uint64_t hash, int maxDistance) {
+    int bestSlot = -1;
+    int bestDistance = maxDistance + 1;
+    for (int slot = 0; slot < state.slotCount; ++slot) {
+        if (!state.slotHashKnown[slot] || !memoryBank.isOccupied(slot)) continue;
+        const int distance = getPerceptualHashDistance(hash, state.slotHash[slot]);
+        if (distance < bestDistance) {
+            bestSlot = slot;
+            bestDistance = distance;
+        }
+    }
+    return bestSlot;
+}
+
 static float getRelImproveForBand(int band,
                                  float relRecent,
                                  float relMid,
@@ -545,7 +677,7 @@ static void tryLockAnchor(MemoryBankAutoCaptureState& state, float anchorQuality
     float bestTime = std::numeric_limits<float>::infinity();
     int bestSlot = -1;
 
-    for (int slot = 0; slot <= 2; ++slot) {
+    for (int slot = 0; slot < state.slotCount && getBandForSlot(slot, state.slotCount) == 0; ++slot) {
         float q = state.slotQualityScore[slot];
         float t = state.slotCaptureTimeSec[slot];
         if (q >= anchorQualityFloor && t >= 0.0f) {
@@ -566,12 +698,12 @@ bool MemoryBankController::getAutoCaptureSlotDebug(int slot,
                                                   float synthRunningTimeSec,
                                                   AutoCaptureSlotDebug& out) const {
     if (!autoCaptureState) return false;
-    if (slot < 0 || slot >= MemoryBank::NUM_SLOTS) return false;
+    if (slot < 0 || slot >= autoCaptureState->slotCount) return false;
 
     const MemoryBankAutoCaptureState& state = *autoCaptureState;
 
     out.isOccupied = memoryBank.isOccupied(slot);
-    out.band = getBandForSlot(slot);
+    out.band = getBandForSlot(slot, state.slotCount);
     out.isAnchorLocked = (state.lockedAnchorSlot == slot);
 
     out.captureTimeSec = state.slotCaptureTimeSec[slot];
@@ -579,7 +711,7 @@ bool MemoryBankController::getAutoCaptureSlotDebug(int slot,
     out.activeFraction = state.slotActiveFraction[slot];
     out.qualityScore = state.slotQualityScore[slot];
 
-    if (state.nextSlotDueTimeSec.size() == MemoryBank::NUM_SLOTS) {
+    if (state.hasSteadySchedule()) {
         out.nextDueTimeSec = state.nextSlotDueTimeSec[slot];
     } else {
         out.nextDueTimeSec = -1.0f;
@@ -589,12 +721,23 @@ bool MemoryBankController::getAutoCaptureSlotDebug(int slot,
     return true;
 }
 
+int MemoryBankController::getDedupedCaptureCount() const {
+    return autoCaptureState ? autoCaptureState->dedupedCaptureCount : 0;
+}
+
+bool MemoryBankController::isAutoCaptureDue(float synthRunningTimeSec) const {
+    if (!autoCaptureEnabledParameter) return false;
+    if (!autoCaptureState) return true;
+    return autoCaptureState->state != MemoryBankAutoCaptureState::State::IDLE
+        || synthRunningTimeSec >= autoCaptureState->nextAttemptTimeSec;
+}
+
 void MemoryBankController::updateAutoCapture(const ofFbo& compositeFbo, float synthRunningTimeSec) {
     if (!autoCaptureEnabledParameter) return;
     if (!compositeFbo.isAllocated()) return;
 
     if (!autoCaptureState) {
-        autoCaptureState = std::make_unique<MemoryBankAutoCaptureState>();
+        autoCaptureState = std::make_unique<MemoryBankAutoCaptureState>(memoryBank.getSlotCount());
         autoCaptureState->nextAttemptTimeSec = synthRunningTimeSec;
     }
 
@@ -604,15 +747,13 @@ void MemoryBankController::updateAutoCapture(const ofFbo& compositeFbo, float sy
     if (!ensureAnalysisAllocated(state, analysisSize)) {
         return;
     }
+    ensureGpuReducerAllocated(state, autoCaptureGpuMetricsSizeParameter);
 
-    const bool warmupFillMode = memoryBank.getFilledCount() < MemoryBank::NUM_SLOTS;
+    const bool warmupFillMode = memoryBank.getFilledCount() < state.slotCount;
 
     // If analysis completed this frame, decide whether to save.
     if (pollAnalysis(state)) {
-        // Active epsilon is the per-pixel luma deviation needed to count as "active".
-        // Keep this fairly low so sparse-but-visible content still counts.
-        constexpr float activeEpsilon = 0.02f;
-        DensityMetrics metrics = computeDensityMetricsRgb(state.pixels, state.analysisSize, activeEpsilon);
+        DensityMetrics metrics = computeDensityMetrics(state, AUTO_CAPTURE_ACTIVE_EPSILON);
         float newScore = computeQualityScore(metrics);
 
         float minVar = autoCaptureMinVarianceParameter;
@@ -631,9 +772,28 @@ void MemoryBankController::updateAutoCapture(const ofFbo& compositeFbo, float sy
 
         bool pass = (metrics.variance >= minVar) && (metrics.activeFraction >= minActive);
 
+        const uint64_t hash = computeAnalysisHash(state);
+        const int dedupeDistance = autoCaptureDedupeDistanceParameter;
+
         bool savedAny = false;
         if (pass && !state.pendingSaveSlots.empty()) {
             for (int slot : state.pendingSaveSlots) {
+                // Near-duplicate of another slot (including one saved earlier in this burst): only
+                // that slot may take it, as a refresh within its own band; otherwise skip the copy.
+                if (dedupeDistance > 0) {
+                    const int duplicateSlot = findDuplicateSlot(state, memoryBank, hash, dedupeDistance - 1);
+                    if (duplicateSlot >= 0 && duplicateSlot != slot) {
+                        if (getBandForSlot(duplicateSlot, state.slotCount) != getBandForSlot(slot, state.slotCount)
+                            || state.lockedAnchorSlot == duplicateSlot) {
+                            state.dedupedCaptureCount++;
+                            ofLogVerbose("MemoryBankController") << "Skipped capture for slot " << slot
+                                                                 << ": duplicate of slot " << duplicateSlot;
+                            continue;
+                        }
+                        slot = duplicateSlot;
+                    }
+                }
+
                 bool shouldSave = false;
 
                 if (warmupFillMode) {
@@ -641,7 +801,7 @@ void MemoryBankController::updateAutoCapture(const ofFbo& compositeFbo, float sy
                     shouldSave = !memoryBank.isOccupied(slot);
                 } else {
                     float oldScore = state.slotQualityScore[slot];
-                    int band = getBandForSlot(slot);
+                    int band = getBandForSlot(slot, state.slotCount);
                     float relImprove = getRelImproveForBand(band,
                                                            autoCaptureRelImproveRecentParameter,
                                                            autoCaptureRelImproveMidParameter,
@@ -666,11 +826,15 @@ void MemoryBankController::updateAutoCapture(const ofFbo& compositeFbo, float sy
                 state.slotVariance[slot] = metrics.variance;
                 state.slotActiveFraction[slot] = metrics.activeFraction;
                 state.slotQualityScore[slot] = newScore;
+                state.slotHash[slot] = hash;
+                state.slotHashKnown[slot] = true;
+                memoryBank.setSlotInfo(slot, synthRunningTimeSec, newScore);
 
                 savedAny = true;
 
-                if (!warmupFillMode && state.nextSlotDueTimeSec.size() == MemoryBank::NUM_SLOTS) {
+                if (!warmupFillMode && state.hasSteadySchedule()) {
                     float interval = getTimeBandIntervalSec(slot,
+                                                           state.slotCount,
                                                            autoCaptureRecentIntervalSecParameter,
                                                            autoCaptureMidIntervalSecParameter,
                                                            autoCaptureLongIntervalSecParameter);
@@ -747,9 +911,9 @@ void MemoryBankController::updateAutoCapture(const ofFbo& compositeFbo, float sy
 
     if (warmupFillMode) {
         // Fill empty slots quickly. We fill lower indices first so that long-term slots
-        // (0-2) naturally capture early performance content.
+        // naturally capture early performance content.
         int burst = std::clamp(autoCaptureWarmupBurstCountParameter.get(), 1, 4);
-        for (int slot = 0; slot < MemoryBank::NUM_SLOTS && static_cast<int>(state.pendingSaveSlots.size()) < burst; ++slot) {
+        for (int slot = 0; slot < state.slotCount && static_cast<int>(state.pendingSaveSlots.size()) < burst; ++slot) {
             if (!memoryBank.isOccupied(slot)) {
                 state.pendingSaveSlots.push_back(slot);
             }
@@ -769,7 +933,7 @@ void MemoryBankController::updateAutoCapture(const ofFbo& compositeFbo, float sy
         std::array<float, 3> bandDue;
         bandDue.fill(std::numeric_limits<float>::infinity());
 
-        for (int slot = 0; slot < MemoryBank::NUM_SLOTS; ++slot) {
+        for (int slot = 0; slot < state.slotCount; ++slot) {
             if (state.lockedAnchorSlot == slot) continue;
 
             float due = state.nextSlotDueTimeSec[slot];
@@ -778,7 +942,7 @@ void MemoryBankController::updateAutoCapture(const ofFbo& compositeFbo, float sy
                 due = std::min(due, synthRunningTimeSec);
             }
 
-            int band = getBandForSlot(slot);
+            int band = getBandForSlot(slot, state.slotCount);
             bandDue[band] = std::min(bandDue[band], due);
         }
 
@@ -805,8 +969,8 @@ void MemoryBankController::updateAutoCapture(const ofFbo& compositeFbo, float sy
         int bestSlot = -1;
         float bestQuality = std::numeric_limits<float>::infinity();
 
-        for (int slot = 0; slot < MemoryBank::NUM_SLOTS; ++slot) {
-            if (getBandForSlot(slot) != selectedBand) continue;
+        for (int slot = 0; slot < state.slotCount; ++slot) {
+            if (getBandForSlot(slot, state.slotCount) != selectedBand) continue;
             if (state.lockedAnchorSlot == slot) continue;
 
             float q = state.slotQualityScore[slot];
@@ -852,7 +1016,7 @@ bool MemoryBankController::loadGlobalMemories(const std::filesystem::path& confi
     }
 
     const std::filesystem::path folder = configRootPath / "memory" / "global";
-    memoryBank.loadAllFromFolder(folder);
+    memoryBank.beginLoadAllFromFolder(folder, encodePool);
     globalMemoryBankLoaded = true;
     return true;
 }
@@ -892,7 +1056,9 @@ std::map<std::string, int> MemoryBankController::getSinkNameIdMap() const {
         { autoCaptureAbsImproveParameter.getName(), SINK_MEMORY_AUTO_CAPTURE_ABS_IMPROVE },
         { autoCaptureRelImproveRecentParameter.getName(), SINK_MEMORY_AUTO_CAPTURE_REL_IMPROVE_RECENT },
         { autoCaptureRelImproveMidParameter.getName(), SINK_MEMORY_AUTO_CAPTURE_REL_IMPROVE_MID },
-        { autoCaptureRelImproveLongParameter.getName(), SINK_MEMORY_AUTO_CAPTURE_REL_IMPROVE_LONG }
+        { autoCaptureRelImproveLongParameter.getName(), SINK_MEMORY_AUTO_CAPTURE_REL_IMPROVE_LONG },
+
+        { "MemoryRecallArchived", SINK_MEMORY_RECALL_ARCHIVED }
     };
 }
 
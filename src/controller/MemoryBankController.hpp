@@ -15,6 +15,7 @@
 #include <filesystem>
 #include <map>
 #include <memory>
+#include <optional>
 #include <string>
 
 namespace ofxMarkSynth {
@@ -61,6 +62,9 @@ public:
     static constexpr int SINK_MEMORY_AUTO_CAPTURE_REL_IMPROVE_MID = 326;
     static constexpr int SINK_MEMORY_AUTO_CAPTURE_REL_IMPROVE_LONG = 327;
 
+    // Archive recall
+    static constexpr int SINK_MEMORY_RECALL_ARCHIVED = 328;
+
     /// Result of handling an emit-type sink
     struct EmitResult {
         const ofTexture* texture { nullptr };
@@ -83,8 +87,8 @@ public:
     MemoryBankController();
     ~MemoryBankController();
 
-    /// Allocate the memory bank FBOs
-    void allocate(glm::vec2 memorySize);
+    /// Allocate the memory bank's slot array
+    void allocate(glm::vec2 memorySize, int slotCount = MemoryBank::DEFAULT_SLOT_COUNT);
 
     /// Build the parameter group (call after allocation)
     void buildParameterGroup();
@@ -100,7 +104,7 @@ public:
     /// Apply intent to memory parameters
     void applyIntent(const Intent& intent, float intentStrength);
 
-    /// Update: process pending saves, auto-capture, and save-all requests
+    /// Update: process pending saves and save-all requests (auto-capture is updateAutoCapture())
     /// @param compositeFbo The current composite FBO
     /// @param configRootPath Root path for saving global memories (empty to skip save-all)
     /// @param synthRunningTimeSec Time since performance start (pauses with synth)
@@ -108,13 +112,34 @@ public:
                 const std::filesystem::path& configRootPath,
                 float synthRunningTimeSec);
 
-    /// Load global memories from disk (call once after first config load)
+    /// Auto-capture: start a density analysis when one is due, and save the capture once it completes
+    void updateAutoCapture(const ofFbo& compositeFbo, float synthRunningTimeSec);
+    /// Whether updateAutoCapture() has work: an attempt is due or an analysis is in flight
+    bool isAutoCaptureDue(float synthRunningTimeSec) const;
+
+    /// Start loading global memories from disk (call once after first config load).
+    /// Slots fill in over the following updates as they are decoded and uploaded.
     /// @return true if loading was attempted (regardless of success)
     bool loadGlobalMemories(const std::filesystem::path& configRootPath);
 
-    /// Request saving all memories to disk (processed in next update)
+    /// Request saving all memories to disk (started in the next update once any previous save has finished)
     void requestSaveAll();
 
+    /// Pool for PNG encoding/decoding of saved memories (null works on the main thread)
+    void setEncodeWorkerPool(EncodeWorkerPool* encodePool_) { encodePool = encodePool_; }
+
+    /// Archive overwritten memories to compressed RAM then disk (call after setEncodeWorkerPool)
+    void setupArchive(const std::filesystem::path& spillFolder, size_t ramBudgetBytes, int maxDiskEntries);
+
+    /// True from requestSaveAll() until the PNGs have been written
+    bool isSaveAllInProgress() const { return memorySaveAllRequested || memoryBank.isSaveAllInProgress(); }
+
+    /// Result of the most recently completed save-all, if any
+    const std::optional<MemoryBank::SaveAllResult>& getLastSaveAllResult() const { return lastSaveAllResult; }
+
+    /// Finish any in-progress save-all, blocking (for shutdown)
+    void flushSaveAll();
+
     /// Get sink name -> ID mapping for Mod system registration
     std::map<std::string, int> getSinkNameIdMap() const;
 
@@ -130,10 +155,15 @@ public:
     /// Debug-only: returns false if no state exists yet.
     bool getAutoCaptureSlotDebug(int slot, float synthRunningTimeSec, AutoCaptureSlotDebug& out) const;
 
+    /// Auto-captures skipped as near-duplicates of another slot this session
+    int getDedupedCaptureCount() const;
+
 private:
     MemoryBank memoryBank;
     bool globalMemoryBankLoaded { false };
     bool memorySaveAllRequested { false };
+    EncodeWorkerPool* encodePool { nullptr };
+    std::optional<MemoryBank::SaveAllResult> lastSaveAllResult;
 
     bool legacySaveSelectionWarningLogged { false };
 
@@ -191,18 +221,26 @@ private:
     // Warmup behavior (fill fast)
     ofParameter<int> autoCaptureWarmupBurstCountParameter { "MemoryAutoCaptureWarmupBurstCount", 2, 1, 4 };
 
-    // Analysis resolution (lower == cheaper)
-    ofParameter<int> autoCaptureAnalysisSizeParameter { "MemoryAutoCaptureAnalysisSize", 32, 8, 128 };
+    // CPU readback resolution, used when the GPU reduction is off or unavailable (lower == cheaper)
+    ofParameter<int> autoCaptureAnalysisSizeParameter { "MemoryAutoCaptureAnalysisSize", 32, 8, 256 };
+    // GPU reduction resolution, rounded down to a power of two; 0 uses the CPU readback
+    ofParameter<int> autoCaptureGpuMetricsSizeParameter { "MemoryAutoCaptureGpuMetricsSize", 512, 0, 2048 };
+
+    // Captures whose perceptual hash differs from an occupied slot's in fewer than this many of 64 bits
+    // are near-duplicates: they may only refresh that slot. 0 disables.
+    ofParameter<int> autoCaptureDedupeDistanceParameter { "MemoryAutoCaptureDedupeDistance", 6, 0, 32 };
 
     /// Check rate limit and return texture if emit is allowed
     EmitResult emitWithRateLimit(const ofTexture* tex);
 
-    void updateAutoCapture(const ofFbo& compositeFbo, float synthRunningTimeSec);
-
     void noteManualSaveSlot(int slot);
-    void logLegacySaveSelectionWarningOnce();
 
-    static int getBandForSlot(int slot);
+    /// Promote an archived memory (chosen by the emit centre/width over capture time) into the
+    /// lowest-quality long-band slot. Returns false if the archive is empty.
+    bool recallArchived();
+
+    void applyPromotedSlots();
+    void logLegacySaveSelectionWarningOnce();
 };
 
 } // namespace ofxMarkSynth
@@ -0,0 +1,288 @@
+//
+//  ModTelemetry.cpp
+//  ofxMarkSynth
+//
+
+#include "controller/ModTelemetry.hpp"
+
+#include "ofLog.h"
+#include "nlohmann/json.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <numeric>
+
+namespace ofxMarkSynth {
+
+// RFC 4180: quote fields containing a delimiter, quote or line break, doubling embedded quotes
+static std::string csvField(const std::string& value) {
+    if (value.find_first_of(",\"\r\n") == std::string::npos) return value;
+    std::string quoted = "\"";
+    for (char c : value) {
+        if (c == '"') quoted += '"';
+        quoted += c;
+    }
+    quoted += '"';
+    return quoted;
+}
+
+ModTelemetry::~ModTelemetry() {
+    deleteQueries();
+}
+
+void ModTelemetry::setEnabled(bool enabled_) {
+    if (enabled == enabled_) return;
+    enabled = enabled_;
+    if (enabled) {
+        // Start a fresh ring; stale GPU queries from a previous run are ignored.
+        frameIndex = -1;
+        pendingGpuFrames = {};
+    }
+    inFrame = false;
+}
+
+void ModTelemetry::setMods(std::vector<std::pair<int, std::string>> modIdNames) {
+    if (static_cast<int>(modIdNames.size()) > MAX_MODS) {
+        ofLogWarning("ModTelemetry") << "Tracking only the first " << MAX_MODS << " of " << modIdNames.size() << " Mods";
+        modIdNames.resize(MAX_MODS);
+    }
+    mods = std::move(modIdNames);
+    frameIndex = -1;
+    pendingGpuFrames = {};
+    inFrame = false;
+}
+
+void ModTelemetry::ensureQueries() {
+    if (queriesCreated) return;
+    for (int i = 0; i < GPU_QUERY_LATENCY_FRAMES; ++i) {
+        timestampQueries[i].resize(MAX_MODS * 2);
+        primitivesQueries[i].resize(MAX_MODS);
+        glGenQueries(static_cast<GLsizei>(timestampQueries[i].size()), timestampQueries[i].data());
+        glGenQueries(static_cast<GLsizei>(primitivesQueries[i].size()), primitivesQueries[i].data());
+    }
+    queriesCreated = true;
+}
+
+void ModTelemetry::deleteQueries() {
+    if (!queriesCreated) return;
+    for (int i = 0; i < GPU_QUERY_LATENCY_FRAMES; ++i) {
+        glDeleteQueries(static_cast<GLsizei>(timestampQueries[i].size()), timestampQueries[i].data());
+        glDeleteQueries(static_cast<GLsizei>(primitivesQueries[i].size()), primitivesQueries[i].data());
+        timestampQueries[i].clear();
+        primitivesQueries[i].clear();
+    }
+    queriesCreated = false;
+}
+
+const ModTelemetry::Sample& ModTelemetry::sampleAt(int64_t frame, int slot) const {
+    return samples[static_cast<size_t>((frame % RING_FRAMES) * MAX_MODS + slot)];
+}
+
+ModTelemetry::Sample& ModTelemetry::sampleAt(int64_t frame, int slot) {
+    return samples[static_cast<size_t>((frame % RING_FRAMES) * MAX_MODS + slot)];
+}
+
+int64_t ModTelemetry::oldestFrameIndex() const {
+    return std::max<int64_t>(0, frameIndex - RING_FRAMES + 1);
+}
+
+int ModTelemetry::getFrameCount() const {
+    if (frameIndex < 0) return 0;
+    return static_cast<int>(std::min<int64_t>(frameIndex + 1, RING_FRAMES));
+}
+
+void ModTelemetry::resolveGpuFrame(int latencySlot) {
+    PendingGpuFrame& pending = pendingGpuFrames[latencySlot];
+    if (pending.frameIndex < 0) return;
+
+    // Results not ready after GPU_QUERY_LATENCY_FRAMES stay unavailable (gpuMs < 0); never wait.
+    if (pending.frameIndex >= oldestFrameIndex()) {
+        for (int slot = 0; slot < pending.modCount; ++slot) {
+            GLuint endQuery = timestampQueries[latencySlot][slot * 2 + 1];
+            GLuint available = 0;
+            glGetQueryObjectuiv(endQuery, GL_QUERY_RESULT_AVAILABLE, &available);
+            if (!available) continue;
+
+            GLuint64 startNs = 0;
+            GLuint64 endNs = 0;
+            GLuint primitives = 0;
+            glGetQueryObjectui64v(timestampQueries[latencySlot][slot * 2], GL_QUERY_RESULT, &startNs);
+            glGetQueryObjectui64v(endQuery, GL_QUERY_RESULT, &endNs);
+            glGetQueryObjectuiv(primitivesQueries[latencySlot][slot], GL_QUERY_RESULT, &primitives);
+
+            Sample& sample = sampleAt(pending.frameIndex, slot);
+            sample.gpuMs = endNs >= startNs ? static_cast<float>(endNs - startNs) * 1.0e-6f : 0.0f;
+            sample.primitives = primitives;
+        }
+    }
+    pending = {};
+}
+
+void ModTelemetry::beginFrame() {
+    if (!enabled || mods.empty()) return;
+
+    ensureQueries();
+    ++frameIndex;
+    inFrame = true;
+
+    const int latencySlot = static_cast<int>(frameIndex % GPU_QUERY_LATENCY_FRAMES);
+    resolveGpuFrame(latencySlot);
+
+    for (int slot = 0; slot < MAX_MODS; ++slot) {
+        sampleAt(frameIndex, slot) = Sample {};
+    }
+    frameStart = Clock::now();
+}
+
+void ModTelemetry::beginMod(int slot) {
+    if (!inFrame || slot < 0 || slot >= getModCount()) return;
+
+    const int latencySlot = static_cast<int>(frameIndex % GPU_QUERY_LATENCY_FRAMES);
+    glQueryCounter(timestampQueries[latencySlot][slot * 2], GL_TIMESTAMP);
+    glBeginQuery(GL_PRIMITIVES_GENERATED, primitivesQueries[latencySlot][slot]);
+    modStart = Clock::now();
+}
+
+void ModTelemetry::endMod(int slot, uint32_t emitCount) {
+    if (!inFrame || slot < 0 || slot >= getModCount()) return;
+
+    const auto modEnd = Clock::now();
+    const int latencySlot = static_cast<int>(frameIndex % GPU_QUERY_LATENCY_FRAMES);
+    glEndQuery(GL_PRIMITIVES_GENERATED);
+    glQueryCounter(timestampQueries[latencySlot][slot * 2 + 1], GL_TIMESTAMP);
+
+    Sample& sample = sampleAt(frameIndex, slot);
+    sample.cpuMs = std::chrono::duration<float, std::milli>(modEnd - modStart).count();
+    sample.emitCount = emitCount;
+}
+
+void ModTelemetry::endFrame() {
+    if (!inFrame) return;
+
+    const int latencySlot = static_cast<int>(frameIndex % GPU_QUERY_LATENCY_FRAMES);
+    frameCpuMs[static_cast<size_t>(frameIndex % RING_FRAMES)] =
+        std::chrono::duration<float, std::milli>(Clock::now() - frameStart).count();
+    pendingGpuFrames[latencySlot] = { frameIndex, getModCount() };
+    inFrame = false;
+}
+
+ModTelemetry::Percentiles ModTelemetry::computePercentiles(std::vector<float>& values) {
+    Percentiles p;
+    if (values.empty()) return p;
+
+    auto at = [&values](float q) {
+        size_t k = static_cast<size_t>(q * static_cast<float>(values.size() - 1) + 0.5f);
+        std::nth_element(values.begin(), values.begin() + k, values.end());
+        return values[k];
+    };
+    p.p50 = at(0.50f);
+    p.p95 = at(0.95f);
+    p.p99 = at(0.99f);
+    p.max = *std::max_element(values.begin(), values.end());
+    return p;
+}
+
+ModTelemetry::Percentiles ModTelemetry::getFrameCpuPercentiles() const {
+    std::vector<float> values;
+    const int64_t lastComplete = inFrame ? frameIndex - 1 : frameIndex;
+    for (int64_t f = oldestFrameIndex(); f <= lastComplete; ++f) {
+        values.push_back(frameCpuMs[static_cast<size_t>(f % RING_FRAMES)]);
+    }
+    return computePercentiles(values);
+}
+
+std::vector<ModTelemetry::ModSummary> ModTelemetry::summarize() const {
+    std::vector<ModSummary> summaries;
+    const int64_t lastComplete = inFrame ? frameIndex - 1 : frameIndex;
+    if (lastComplete < 0) return summaries;
+
+    std::vector<float> cpuValues;
+    std::vector<float> gpuValues;
+    for (int slot = 0; slot < getModCount(); ++slot) {
+        cpuValues.clear();
+        gpuValues.clear();
+        double emitSum = 0.0;
+        double primitiveSum = 0.0;
+        int primitiveFrames = 0;
+
+        for (int64_t f = oldestFrameIndex(); f <= lastComplete; ++f) {
+            const Sample& sample = sampleAt(f, slot);
+            cpuValues.push_back(sample.cpuMs);
+            emitSum += sample.emitCount;
+            if (sample.gpuMs >= 0.0f) {
+                gpuValues.push_back(sample.gpuMs);
+                primitiveSum += sample.primitives;
+                primitiveFrames++;
+            }
+        }
+
+        ModSummary summary;
+        summary.slot = slot;
+        summary.modId = mods[slot].first;
+        summary.name = mods[slot].second;
+        summary.cpuMs = computePercentiles(cpuValues);
+        summary.gpuMs = computePercentiles(gpuValues);
+        summary.meanEmitCount = cpuValues.empty() ? 0.0f : static_cast<float>(emitSum / cpuValues.size());
+        summary.meanPrimitives = primitiveFrames == 0 ? 0.0f : static_cast<float>(primitiveSum / primitiveFrames);
+        summaries.push_back(std::move(summary));
+    }
+
+    std::sort(summaries.begin(), summaries.end(), [](const ModSummary& a, const ModSummary& b) {
+        return a.cpuMs.p95 > b.cpuMs.p95;
+    });
+    return summaries;
+}
+
+bool ModTelemetry::exportCsv(const std::filesystem::path& path) const {
+    std::ofstream out(path);
+    if (!out.is_open()) {
+        ofLogError("ModTelemetry") << "exportCsv: failed to open " << path;
+        return false;
+    }
+
+    out << "frame,slot,modId,modName,cpuMs,gpuMs,emitCount,primitives\n";
+    const int64_t lastComplete = inFrame ? frameIndex - 1 : frameIndex;
+    for (int64_t f = oldestFrameIndex(); f <= lastComplete; ++f) {
+        for (int slot = 0; slot < getModCount(); ++slot) {
+            const Sample& sample = sampleAt(f, slot);
+            out << f << ',' << slot << ',' << mods[slot].first << ',' << csvField(mods[slot].second) << ','
+                << sample.cpuMs << ',' << sample.gpuMs << ',' << sample.emitCount << ',' << sample.primitives << '\n';
+        }
+    }
+
+    ofLogNotice("ModTelemetry") << "Exported " << getFrameCount() << " frames to " << path;
+    return true;
+}
+
+bool ModTelemetry::exportJson(const std::filesystem::path& path) const {
+    auto percentilesJson = [](const Percentiles& p) {
+        return nlohmann::ordered_json { { "p50", p.p50 }, { "p95", p.p95 }, { "p99", p.p99 }, { "max", p.max } };
+    };
+
+    nlohmann::ordered_json j;
+    j["frames"] = getFrameCount();
+    j["frameCpuMs"] = percentilesJson(getFrameCpuPercentiles());
+    j["mods"] = nlohmann::ordered_json::array();
+    for (const auto& summary : summarize()) {
+        j["mods"].push_back({
+            { "modId", summary.modId },
+            { "name", summary.name },
+            { "cpuMs", percentilesJson(summary.cpuMs) },
+            { "gpuMs", percentilesJson(summary.gpuMs) },
+            { "meanEmitCount", summary.meanEmitCount },
+            { "meanPrimitives", summary.meanPrimitives }
+        });
+    }
+
+    std::ofstream out(path);
+    if (!out.is_open()) {
+        ofLogError("ModTelemetry") << "exportJson: failed to open " << path;
+        return false;
+    }
+    out << j.dump(2);
+
+    ofLogNotice("ModTelemetry") << "Exported telemetry summary to " << path;
+    return true;
+}
+
+} // namespace ofxMarkSynth
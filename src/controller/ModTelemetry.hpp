@@ -0,0 +1,115 @@
+//
+//  ModTelemetry.hpp
+//  ofxMarkSynth
+//
+
+#pragma once
+
+#include "ofGLUtils.h"
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace ofxMarkSynth {
+
+/// Per-Mod frame telemetry ring: CPU time, GPU time (timestamp queries), emit count and
+/// primitives generated for each Mod::update(), keyed by a dense integer slot per Mod.
+/// Reports p50/p95/p99 and exports CSV/JSON on demand.
+/// When disabled, Synth skips every call, so the only cost is one bool test per Mod.
+class ModTelemetry {
+public:
+    static constexpr int RING_FRAMES = 900;              // ~30s @ 30fps
+    static constexpr int MAX_MODS = 64;
+    static constexpr int GPU_QUERY_LATENCY_FRAMES = 4;   // Read GPU results this many frames later (never stall)
+
+    struct Sample {
+        float cpuMs { 0.0f };
+        float gpuMs { -1.0f };       // < 0: not (yet) available
+        uint32_t emitCount { 0 };
+        uint32_t primitives { 0 };   // GL_PRIMITIVES_GENERATED: proxy for draw work
+    };
+
+    struct Percentiles {
+        float p50 { 0.0f };
+        float p95 { 0.0f };
+        float p99 { 0.0f };
+        float max { 0.0f };
+    };
+
+    struct ModSummary {
+        int slot { 0 };
+        int modId { 0 };
+        std::string name;
+        Percentiles cpuMs;
+        Percentiles gpuMs;
+        float meanEmitCount { 0.0f };
+        float meanPrimitives { 0.0f };
+    };
+
+    ModTelemetry() = default;
+    ~ModTelemetry();
+    ModTelemetry(const ModTelemetry&) = delete;
+    ModTelemetry& operator=(const ModTelemetry&) = delete;
+
+    void setEnabled(bool enabled_);
+    bool isEnabled() const { return enabled; }
+
+    /// Assign slots (index in the vector) to Mods and clear the ring. Call after a config load.
+    void setMods(std::vector<std::pair<int, std::string>> modIdNames);
+    int getModCount() const { return static_cast<int>(mods.size()); }
+
+    void beginFrame();
+    void beginMod(int slot);
+    void endMod(int slot, uint32_t emitCount);
+    void endFrame();
+
+    /// Number of frames currently held in the ring.
+    int getFrameCount() const;
+
+    /// Whole-frame CPU time across all Mod updates.
+    Percentiles getFrameCpuPercentiles() const;
+
+    /// Summaries sorted by descending p95 CPU time.
+    std::vector<ModSummary> summarize() const;
+
+    bool exportCsv(const std::filesystem::path& path) const;
+    bool exportJson(const std::filesystem::path& path) const;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct PendingGpuFrame {
+        int64_t frameIndex { -1 };
+        int modCount { 0 };
+    };
+
+    void ensureQueries();
+    void deleteQueries();
+    void resolveGpuFrame(int latencySlot);
+    const Sample& sampleAt(int64_t frameIndex, int slot) const;
+    Sample& sampleAt(int64_t frameIndex, int slot);
+    int64_t oldestFrameIndex() const;
+    static Percentiles computePercentiles(std::vector<float>& values);
+
+    bool enabled { false };
+    std::vector<std::pair<int, std::string>> mods;
+
+    std::vector<Sample> samples = std::vector<Sample>(static_cast<size_t>(RING_FRAMES * MAX_MODS));
+    std::vector<float> frameCpuMs = std::vector<float>(RING_FRAMES, 0.0f);
+    int64_t frameIndex { -1 };      // Current (or last) frame
+    bool inFrame { false };
+    Clock::time_point frameStart;
+    Clock::time_point modStart;
+
+    // Per latency slot: [mod][start, end] timestamp queries and a primitives query per mod
+    std::array<std::vector<GLuint>, GPU_QUERY_LATENCY_FRAMES> timestampQueries;
+    std::array<std::vector<GLuint>, GPU_QUERY_LATENCY_FRAMES> primitivesQueries;
+    std::array<PendingGpuFrame, GPU_QUERY_LATENCY_FRAMES> pendingGpuFrames;
+    bool queriesCreated { false };
+};
+
+} // namespace ofxMarkSynth
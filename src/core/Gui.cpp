@@ -365,6 +365,7 @@ void Gui::drawSynthControls() {
   drawDisplayControls();
   drawInternalState();
   drawMemoryBank();
+  drawTelemetry();
 
   ImGui::End();
 }
@@ -855,28 +856,40 @@ void Gui::drawMemoryBank() {
   constexpr float spacing = 4.0f;
   constexpr float slotHeight = 100.0f; // thumbnail + label + button
   
+  const MemoryArchive& archive = synthPtr->getMemoryBankController().getMemoryBank().getArchive();
+  if (archive.isEnabled()) {
+    ImGui::Text("Archive: %d in RAM (%.1f MB), %d on disk", archive.getRamCount(),
+                static_cast<double>(archive.getRamBytes()) / (1024.0 * 1024.0), archive.getDiskCount());
+  }
+  if (const int deduped = synthPtr->getMemoryBankController().getDedupedCaptureCount(); deduped > 0) {
+    ImGui::Text("Duplicate captures skipped: %d", deduped);
+  }
+
   // Scrollable horizontal region for thumbnails (no vertical scroll)
   ImGui::BeginChild("MemoryBankSlots", ImVec2(0, slotHeight), false, 
       ImGuiWindowFlags_HorizontalScrollbar | ImGuiWindowFlags_NoScrollbar);
   
   // Horizontal layout of slots
-  for (int i = 0; i < MemoryBank::NUM_SLOTS; i++) {
+  MemoryBank& memoryBank = synthPtr->getMemoryBankController().getMemoryBank();
+  const int slotCount = memoryBank.getSlotCount();
+  const ImTextureID atlasTexId = (ImTextureID)(uintptr_t)memoryBank.getThumbnailAtlas().getTextureData().textureID;
+  for (int i = 0; i < slotCount; i++) {
     ImGui::PushID(i);
     
     ImGui::BeginGroup();
     {
-      // Thumbnail or empty box
-      const ofTexture* tex = synthPtr->getMemoryBankController().getMemoryBank().get(i);
-      if (tex && tex->isAllocated()) {
-        const auto& textureData = tex->getTextureData();
-        ImTextureID imguiTexId = (ImTextureID)(uintptr_t)textureData.textureID;
-        ImGui::Image(imguiTexId, ImVec2(memThumbW, memThumbW));
+      // Thumbnail (a tile of the bank's atlas) or empty box
+      if (memoryBank.isOccupied(i)) {
+        glm::vec2 uv0, uv1;
+        memoryBank.getThumbnailTexCoords(i, uv0, uv1);
+        ImGui::Image(atlasTexId, ImVec2(memThumbW, memThumbW), ImVec2(uv0.x, uv0.y), ImVec2(uv1.x, uv1.y));
         
-        // Tooltip with larger preview on hover
-        if (ImGui::IsItemHovered()) {
+        // Tooltip with larger preview on hover (copies this one slot out of the array)
+        const ofTexture* tex = ImGui::IsItemHovered() ? memoryBank.get(i) : nullptr;
+        if (tex && tex->isAllocated()) {
           ImGui::BeginTooltip();
           constexpr float tooltipSize = 256.0f;
-          ImGui::Image(imguiTexId, ImVec2(tooltipSize, tooltipSize));
+          ImGui::Image((ImTextureID)(uintptr_t)tex->getTextureData().textureID, ImVec2(tooltipSize, tooltipSize));
 
           MemoryBankController::AutoCaptureSlotDebug dbg;
           if (synthPtr->getMemoryBankController().getAutoCaptureSlotDebug(i, synthPtr->getSynthRunningTime(), dbg)) {
@@ -929,14 +942,14 @@ void Gui::drawMemoryBank() {
       // Save button - deferred to avoid GL state issues during ImGui rendering
       const std::string saveLabel = "Save " + std::to_string(i);
       if (ImGui::Button(saveLabel.c_str(), ImVec2(memThumbW, 0))) {
-        synthPtr->getMemoryBankController().getMemoryBank().requestSaveToSlot(i);
+        memoryBank.requestSaveToSlot(i);
       }
     }
     ImGui::EndGroup();
     
     ImGui::PopID();
     
-    if (i < MemoryBank::NUM_SLOTS - 1) {
+    if (i < slotCount - 1) {
       ImGui::SameLine(0, spacing);
     }
   }
@@ -958,15 +971,77 @@ void Gui::drawMemoryBank() {
 
     ImGui::Dummy(ImVec2(0.0f, ImGui::GetStyle().ItemSpacing.y));
 
-    if (ImGui::Button("Save All", ImVec2(memThumbW, 0))) {
+    const bool savingAll = synthPtr->getMemoryBankController().isSaveAllInProgress();
+    if (savingAll) ImGui::BeginDisabled();
+    if (ImGui::Button(savingAll ? "Saving..." : "Save All", ImVec2(memThumbW, 0))) {
       synthPtr->requestSaveAllMemories();
     }
+    if (savingAll) ImGui::EndDisabled();
   }
   ImGui::EndGroup();
   
   ImGui::EndChild();
 }
 
+void Gui::drawTelemetry() {
+  if (!ImGui::CollapsingHeader("Telemetry")) return;
+
+  ModTelemetry& telemetry = synthPtr->getModTelemetry();
+  bool enabled = telemetry.isEnabled();
+  if (ImGui::Checkbox("Record per-Mod timings", &enabled)) {
+    telemetry.setEnabled(enabled);
+    telemetrySummaryTimeSec = -1.0f;
+  }
+  ImGui::SameLine();
+  ImGui::BeginDisabled(telemetry.getFrameCount() == 0);
+  if (ImGui::Button("Export")) {
+    synthPtr->exportTelemetry();
+  }
+  ImGui::EndDisabled();
+
+  const float now = ofGetElapsedTimef();
+  if (telemetrySummaryTimeSec < 0.0f || now - telemetrySummaryTimeSec >= TELEMETRY_SUMMARY_INTERVAL_SEC) {
+    telemetrySummaries = telemetry.summarize();
+    telemetryFramePercentiles = telemetry.getFrameCpuPercentiles();
+    telemetrySummaryTimeSec = now;
+  }
+
+  if (telemetry.getFrameCount() == 0) {
+    ImGui::TextColored(GREY_COLOR, "No frames recorded");
+    return;
+  }
+
+  ImGui::TextColored(GREY_COLOR, "%d frames  Mod updates p50 %.2fms  p95 %.2fms  p99 %.2fms",
+                     telemetry.getFrameCount(), telemetryFramePercentiles.p50,
+                     telemetryFramePercentiles.p95, telemetryFramePercentiles.p99);
+
+  if (ImGui::BeginTable("##telemetryMods", 5, ImGuiTableFlags_RowBg | ImGuiTableFlags_SizingStretchProp)) {
+    ImGui::TableSetupColumn("Mod");
+    ImGui::TableSetupColumn("CPU p95");
+    ImGui::TableSetupColumn("GPU p95");
+    ImGui::TableSetupColumn("Emits");
+    ImGui::TableSetupColumn("Prims");
+    ImGui::TableHeadersRow();
+
+    int rows = std::min(TELEMETRY_TOP_MODS, static_cast<int>(telemetrySummaries.size()));
+    for (int i = 0; i < rows; ++i) {
+      const auto& summary = telemetrySummaries[i];
+      ImGui::TableNextRow();
+      ImGui::TableNextColumn();
+      ImGui::TextUnformatted(summary.name.c_str());
+      ImGui::TableNextColumn();
+      ImGui::Text("%.2f", summary.cpuMs.p95);
+      ImGui::TableNextColumn();
+      ImGui::Text("%.2f", summary.gpuMs.p95);
+      ImGui::TableNextColumn();
+      ImGui::Text("%.1f", summary.meanEmitCount);
+      ImGui::TableNextColumn();
+      ImGui::Text("%.0f", summary.meanPrimitives);
+    }
+    ImGui::EndTable();
+  }
+}
+
 void Gui::drawStatus() {
   if (!synthPtr->currentConfigPath.empty()) {
     std::filesystem::path p(synthPtr->currentConfigPath);
@@ -1044,7 +1119,7 @@ void Gui::drawStatus() {
   // Status indicator: hibernation state takes priority over pause state
   auto hibernationState = synthPtr->getHibernationState();
   if (hibernationState == HibernationController::State::HIBERNATED) {
-    ImGui::TextColored(YELLOW_COLOR, "Hibernated");
+    ImGui::TextColored(YELLOW_COLOR, synthPtr->isDeepIdle() ? "Hibernated (deep idle)" : "Hibernated");
   } else if (hibernationState == HibernationController::State::FADING_OUT) {
     ImGui::TextColored(YELLOW_COLOR, "Hibernating...");
   } else if (synthPtr->paused) {
@@ -1053,9 +1128,24 @@ void Gui::drawStatus() {
     ImGui::TextColored(GREY_COLOR, "%s Playing", PLAY_ICON);
   }
   
-#ifdef TARGET_MAC
+#ifdef OFXMARKSYNTH_VIDEO_RECORDING
   if (synthPtr->isRecording()) {
     ImGui::TextColored(RED_COLOR, "%s Recording", RECORD_ICON);
+    const RecordingStats stats = synthPtr->videoRecorderPtr->getStats();
+    const ImVec4 color = stats.framesDropped > 0 ? RED_COLOR
+        : (stats.framesDuplicated > 0 || stats.framesBlocked > 0) ? YELLOW_COLOR : GREY_COLOR;
+    ImGui::TextColored(color, "   q %d (max %d), %.1f ms encode", stats.queueDepth, stats.maxQueueDepth, stats.meanEncodeLatencyMs);
+    ImGui::TextColored(color, "   %llu dropped, %llu dup, %llu blocked",
+                       static_cast<unsigned long long>(stats.framesDropped),
+                       static_cast<unsigned long long>(stats.framesDuplicated),
+                       static_cast<unsigned long long>(stats.framesBlocked));
+    if (ImGui::IsItemHovered()) {
+      ImGui::SetTooltip("Backpressure policy: %s\n%llu of %llu frames written, max encode %.1f ms, %.0f ms blocked",
+                        getRecordingBackpressurePolicyName(stats.policy),
+                        static_cast<unsigned long long>(stats.framesWritten),
+                        static_cast<unsigned long long>(stats.framesCaptured),
+                        stats.maxEncodeLatencyMs, stats.blockedMs);
+    }
   } else {
     ImGui::TextColored(GREY_COLOR, "   Not Recording");
   }
@@ -1067,6 +1157,40 @@ void Gui::drawStatus() {
   } else {
     ImGui::TextColored(YELLOW_COLOR, "%s %d Image Save%s", SAVE_ICON, saveCount, saveCount > 1 ? "s" : "");
   }
+  if (synthPtr->imageSaver) {
+    const int queuedCount = synthPtr->imageSaver->getQueuedSaveCount();
+    const int backpressureCount = synthPtr->imageSaver->getBackpressureCount();
+    if (backpressureCount > 0) {
+      ImGui::TextColored(RED_COLOR, "   %d queued, %d refused (backpressure)", queuedCount, backpressureCount);
+    } else if (queuedCount > 0) {
+      ImGui::TextColored(YELLOW_COLOR, "   %d queued", queuedCount);
+    }
+  }
+
+  drawGpuMemoryStatus();
+}
+
+void Gui::drawGpuMemoryStatus() {
+  constexpr double BYTES_PER_MB = 1024.0 * 1024.0;
+  const auto& registry = GpuMemoryRegistry::instance();
+  const double totalMB = registry.getTotalBytes() / BYTES_PER_MB;
+  const double budgetMB = registry.getBudgetBytes() / BYTES_PER_MB;
+
+  if (budgetMB <= 0.0) {
+    ImGui::TextColored(GREY_COLOR, "   GPU %.0f MB", totalMB);
+  } else {
+    const double fraction = totalMB / budgetMB;
+    const ImVec4 color = fraction > 1.0 ? RED_COLOR : fraction > 0.9 ? YELLOW_COLOR : GREY_COLOR;
+    ImGui::TextColored(color, "   GPU %.0f / %.0f MB", totalMB, budgetMB);
+  }
+
+  if (ImGui::IsItemHovered()) {
+    ImGui::BeginTooltip();
+    for (const auto& [owner, bytes] : registry.getBytesByOwner()) {
+      ImGui::Text("%-32s %7.1f MB", owner.c_str(), bytes / BYTES_PER_MB);
+    }
+    ImGui::EndTooltip();
+  }
 }
 
 constexpr int FBO_PARAMETER_ID = 0;
@@ -2036,6 +2160,20 @@ void Gui::drawDebugView() {
       ImGuiTabItemFlags fboFlags =
           (selectRequestedTab && requestedMode == Synth::DebugViewMode::Fbo) ? ImGuiTabItemFlags_SetSelected : 0;
       if (ImGui::BeginTabItem("FBO", nullptr, fboFlags)) {
+        // Tell the Synth the FBO is on screen; it skips rendering the debug view otherwise.
+        synthPtr->markDebugViewShown();
+
+        float refreshHz = synthPtr->getDebugViewRefreshHz();
+        ImGui::SetNextItemWidth(120.0f);
+        if (ImGui::SliderFloat("Refresh Hz", &refreshHz, 0.0f, 30.0f, refreshHz <= 0.0f ? "Every frame" : "%.1f")) {
+          synthPtr->setDebugViewRefreshHz(refreshHz);
+        }
+        ImGui::SameLine();
+        bool roundRobin = synthPtr->isDebugViewRoundRobin();
+        if (ImGui::Checkbox("One Mod per refresh", &roundRobin)) {
+          synthPtr->setDebugViewRoundRobin(roundRobin);
+        }
+
         if (!fbo.isAllocated()) {
           ImGui::TextUnformatted("Debug FBO not allocated.");
         } else {
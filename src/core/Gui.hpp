@@ -13,6 +13,8 @@
 #include "nodeEditor/NodeEditorModel.hpp"
 #include "config/ModSnapshotManager.hpp"
 #include "controller/AudioInspectorModel.hpp"
+#include "controller/ModTelemetry.hpp"
+#include "rendering/GpuMemoryRegistry.hpp"
 #include <algorithm>
 #include <array>
 #include <memory>
@@ -65,7 +67,9 @@ private:
   void drawDisplayControls();
   void drawInternalState();
   void drawMemoryBank();
+  void drawTelemetry();
   void drawStatus();
+  void drawGpuMemoryStatus();
   void drawAgencyControllerNodeTitleBar(AgencyControllerMod* agencyControllerPtr);
   void drawAgencyControllerNodeTooltip(AgencyControllerMod* agencyControllerPtr);
   void drawNode(const ModPtr& modPtr, bool highlight = false);
@@ -182,6 +186,13 @@ private:
   VideoSamplingPlotState videoSamplingPlotState;
   std::unordered_map<std::string, MotionMagnitudePlotState> motionMagnitudePlotStates;
 
+  // Telemetry summary is recomputed at a low rate; percentiles over the full ring are not free
+  std::vector<ModTelemetry::ModSummary> telemetrySummaries;
+  ModTelemetry::Percentiles telemetryFramePercentiles;
+  float telemetrySummaryTimeSec { -1.0f };
+  static constexpr float TELEMETRY_SUMMARY_INTERVAL_SEC { 0.5f };
+  static constexpr int TELEMETRY_TOP_MODS { 8 };
+
   // Help window
   bool showHelpWindow { false };
   ImFont* monoFont { nullptr };
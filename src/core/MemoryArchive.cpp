@@ -0,0 +1,239 @@
+//
+//  MemoryArchive.cpp
+//  ofxMarkSynth
+//
+
+#include "core/MemoryArchive.hpp"
+#include "rendering/EncodeWorkerPool.hpp"
+#include "ofImage.h"
+#include "ofLog.h"
+#include <algorithm>
+
+namespace ofxMarkSynth {
+
+static std::filesystem::path getSpillPath(const std::filesystem::path& folder, uint64_t id) {
+    return folder / ("memory-" + std::to_string(id) + ".jpg");
+}
+
+// Lowest quality first (unknown counts as lowest), then oldest
+static bool isWorseThan(const MemoryArchive::EntryInfo& a, const MemoryArchive::EntryInfo& b) {
+    if (a.qualityScore != b.qualityScore) return a.qualityScore < b.qualityScore;
+    return a.captureTimeSec < b.captureTimeSec;
+}
+
+void MemoryArchive::run(const std::shared_ptr<State>& state, const std::string& label, std::function<void()> job) {
+    if (state->pool) {
+        state->pool->submit(label, std::move(job));
+    } else {
+        job();
+    }
+}
+
+void MemoryArchive::runAll(const std::shared_ptr<State>& state, std::vector<std::function<void()>> jobs) {
+    for (auto& job : jobs) {
+        run(state, "memory archive", std::move(job));
+    }
+}
+
+void MemoryArchive::setup(const std::filesystem::path& spillFolder, size_t ramBudgetBytes, int maxDiskEntries, EncodeWorkerPool* pool) {
+    clear();
+
+    // Jobs still running against the old state keep it alive; new ones get the new settings.
+    state = std::make_shared<State>();
+    state->spillFolder = spillFolder;
+    state->ramBudgetBytes = ramBudgetBytes;
+    state->maxDiskEntries = std::max(0, maxDiskEntries);
+    state->pool = pool;
+    if (!isEnabled()) return;
+
+    std::error_code ec;
+    std::filesystem::remove_all(spillFolder, ec);
+    std::filesystem::create_directories(spillFolder, ec);
+    if (ec) {
+        ofLogError("MemoryArchive") << "Failed to create spill folder: " << spillFolder << " (" << ec.message() << ")";
+    }
+}
+
+void MemoryArchive::add(ofPixels&& pixels, float captureTimeSec, float qualityScore) {
+    if (!isEnabled()) return;
+
+    auto sharedPixels = std::make_shared<ofPixels>(std::move(pixels));
+    std::shared_ptr<State> s = state;
+    run(s, "memory archive", [s, sharedPixels, captureTimeSec, qualityScore] {
+        sharedPixels->setImageType(OF_IMAGE_COLOR);  // JPEG has no alpha
+        auto jpeg = std::make_shared<ofBuffer>();
+        if (!ofSaveImage(*sharedPixels, *jpeg, OF_IMAGE_FORMAT_JPEG, OF_IMAGE_QUALITY_HIGH)) {
+            ofLogError("MemoryArchive") << "Failed to compress memory";
+            return;
+        }
+
+        std::vector<std::function<void()>> jobs;
+        {
+            std::lock_guard<std::mutex> lock(s->mutex);
+            Entry& entry = s->entries.emplace_back();
+            entry.info = { s->nextId++, captureTimeSec, qualityScore, Tier::Ram };
+            entry.jpeg = std::move(jpeg);
+            s->ramBytes += entry.jpeg->size();
+            jobs = enforceBudgetsLocked(s);
+        }
+        runAll(s, std::move(jobs));
+    });
+}
+
+std::vector<std::function<void()>> MemoryArchive::enforceBudgetsLocked(const std::shared_ptr<State>& s) {
+    std::vector<std::function<void()>> jobs;
+
+    while (s->ramBytes - s->spillingBytes > s->ramBudgetBytes) {
+        auto worst = s->entries.end();
+        for (auto it = s->entries.begin(); it != s->entries.end(); ++it) {
+            if (it->info.tier != Tier::Ram || it->spilling) continue;
+            if (worst == s->entries.end() || isWorseThan(it->info, worst->info)) worst = it;
+        }
+        if (worst == s->entries.end()) break;
+
+        worst->spilling = true;
+        s->spillingBytes += worst->jpeg->size();
+
+        const uint64_t id = worst->info.id;
+        std::shared_ptr<const ofBuffer> jpeg = worst->jpeg;
+        const std::filesystem::path path = getSpillPath(s->spillFolder, id);
+        jobs.push_back([s, id, jpeg, path] {
+            const bool written = ofBufferToFile(path, *jpeg, true);
+
+            std::vector<std::function<void()>> moreJobs;
+            {
+                std::lock_guard<std::mutex> lock(s->mutex);
+                auto it = std::find_if(s->entries.begin(), s->entries.end(), [id](const Entry& e) { return e.info.id == id; });
+                if (it == s->entries.end()) {
+                    // Taken or cleared while spilling
+                    std::error_code ec;
+                    std::filesystem::remove(path, ec);
+                    return;
+                }
+
+                it->spilling = false;
+                s->spillingBytes -= jpeg->size();
+                if (!written) {
+                    ofLogError("MemoryArchive") << "Failed to spill memory to " << path << "; keeping it in RAM";
+                    return;
+                }
+                it->info.tier = Tier::Disk;
+                it->path = path;
+                it->jpeg.reset();
+                s->ramBytes -= jpeg->size();
+                s->diskCount++;
+                moreJobs = enforceBudgetsLocked(s);
+            }
+            runAll(s, std::move(moreJobs));
+        });
+    }
+
+    while (s->diskCount > s->maxDiskEntries) {
+        auto worst = s->entries.end();
+        for (auto it = s->entries.begin(); it != s->entries.end(); ++it) {
+            if (it->info.tier != Tier::Disk) continue;
+            if (worst == s->entries.end() || isWorseThan(it->info, worst->info)) worst = it;
+        }
+        if (worst == s->entries.end()) break;
+
+        const std::filesystem::path path = worst->path;
+        s->entries.erase(worst);
+        s->diskCount--;
+        jobs.push_back([path] {
+            std::error_code ec;
+            std::filesystem::remove(path, ec);
+        });
+    }
+
+    return jobs;
+}
+
+bool MemoryArchive::take(uint64_t id, std::function<void(ofPixels&& pixels, const EntryInfo& info)> onDecoded) {
+    std::shared_ptr<State> s = state;
+    Entry entry;
+    {
+        std::lock_guard<std::mutex> lock(s->mutex);
+        auto it = std::find_if(s->entries.begin(), s->entries.end(), [id](const Entry& e) { return e.info.id == id; });
+        if (it == s->entries.end()) return false;
+
+        entry = std::move(*it);
+        s->entries.erase(it);
+        if (entry.info.tier == Tier::Ram) {
+            s->ramBytes -= entry.jpeg->size();
+            if (entry.spilling) s->spillingBytes -= entry.jpeg->size();
+        } else {
+            s->diskCount--;
+        }
+    }
+
+    run(s, "memory promote", [entry = std::move(entry), onDecoded = std::move(onDecoded)] {
+        ofPixels pixels;
+        bool ok;
+        if (entry.info.tier == Tier::Ram) {
+            ok = ofLoadImage(pixels, *entry.jpeg);
+        } else {
+            ok = ofLoadImage(pixels, entry.path);
+            std::error_code ec;
+            std::filesystem::remove(entry.path, ec);
+        }
+        if (!ok) {
+            ofLogError("MemoryArchive") << "Failed to decode archived memory " << entry.info.id;
+            pixels.clear();
+        }
+        onDecoded(std::move(pixels), entry.info);
+    });
+    return true;
+}
+
+std::vector<MemoryArchive::EntryInfo> MemoryArchive::getEntries() const {
+    std::vector<EntryInfo> infos;
+    {
+        std::lock_guard<std::mutex> lock(state->mutex);
+        infos.reserve(state->entries.size());
+        for (const auto& entry : state->entries) {
+            infos.push_back(entry.info);
+        }
+    }
+    std::sort(infos.begin(), infos.end(), [](const EntryInfo& a, const EntryInfo& b) { return a.captureTimeSec < b.captureTimeSec; });
+    return infos;
+}
+
+int MemoryArchive::getRamCount() const {
+    std::lock_guard<std::mutex> lock(state->mutex);
+    return static_cast<int>(state->entries.size()) - state->diskCount;
+}
+
+int MemoryArchive::getDiskCount() const {
+    std::lock_guard<std::mutex> lock(state->mutex);
+    return state->diskCount;
+}
+
+size_t MemoryArchive::getRamBytes() const {
+    std::lock_guard<std::mutex> lock(state->mutex);
+    return state->ramBytes;
+}
+
+void MemoryArchive::clear() {
+    std::shared_ptr<State> s = state;
+    std::vector<std::filesystem::path> spilled;
+    {
+        std::lock_guard<std::mutex> lock(s->mutex);
+        for (const auto& entry : s->entries) {
+            if (entry.info.tier == Tier::Disk) spilled.push_back(entry.path);
+        }
+        s->entries.clear();
+        s->ramBytes = 0;
+        s->spillingBytes = 0;
+        s->diskCount = 0;
+    }
+    if (spilled.empty()) return;
+
+    run(s, "memory archive clear", [spilled = std::move(spilled)] {
+        for (const auto& path : spilled) {
+            std::error_code ec;
+            std::filesystem::remove(path, ec);
+        }
+    });
+}
+
+} // namespace ofxMarkSynth
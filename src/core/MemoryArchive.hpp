@@ -0,0 +1,101 @@
+//
+//  MemoryArchive.hpp
+//  ofxMarkSynth
+//
+//  Memories evicted from the MemoryBank's GPU slots. Entries are JPEG-compressed into RAM and,
+//  once the RAM tier is over budget, spilled to disk lowest-quality first; when the disk tier is
+//  full the lowest-quality entries are dropped. Each entry keeps the capture time and quality
+//  score it had on the GPU, so recall can prefer old or good material.
+//
+
+#pragma once
+
+#include "ofFileUtils.h"
+#include "ofPixels.h"
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace ofxMarkSynth {
+
+class EncodeWorkerPool;
+
+class MemoryArchive {
+public:
+    enum class Tier { Ram, Disk };
+
+    struct EntryInfo {
+        uint64_t id { 0 };
+        float captureTimeSec { -1.0f };
+        float qualityScore { -1.0f };  // < 0 when unknown (manual or loaded memories)
+        Tier tier { Tier::Ram };
+    };
+
+    MemoryArchive() = default;
+
+    MemoryArchive(const MemoryArchive&) = delete;
+    MemoryArchive& operator=(const MemoryArchive&) = delete;
+
+    /// Enable the archive. The spill folder is emptied: archives only live for one session.
+    /// @param ramBudgetBytes Compressed bytes kept in RAM before spilling (0 disables the archive)
+    /// @param maxDiskEntries Spilled entries kept before the lowest-quality ones are dropped
+    /// @param pool Compression, decompression and file I/O run here (inline when null)
+    void setup(const std::filesystem::path& spillFolder, size_t ramBudgetBytes, int maxDiskEntries, EncodeWorkerPool* pool);
+
+    bool isEnabled() const { return state->ramBudgetBytes > 0; }
+
+    /// Compress and add a memory (asynchronously when there's a pool). Thread-safe.
+    void add(ofPixels&& pixels, float captureTimeSec, float qualityScore);
+
+    /// Remove an entry and decode it; `onDecoded` runs on the pool with the pixels (empty on failure).
+    /// @return false if the entry no longer exists
+    bool take(uint64_t id, std::function<void(ofPixels&& pixels, const EntryInfo& info)> onDecoded);
+
+    /// Snapshot of the entries, oldest capture first
+    std::vector<EntryInfo> getEntries() const;
+
+    int getRamCount() const;
+    int getDiskCount() const;
+    size_t getRamBytes() const;
+
+    /// Drop every entry (and its spill file)
+    void clear();
+
+private:
+    struct Entry {
+        EntryInfo info;
+        std::shared_ptr<const ofBuffer> jpeg;  // Null once written to disk
+        std::filesystem::path path;           // Set once written to disk
+        bool spilling { false };
+    };
+
+    // Shared with pool jobs, which may outlive the archive
+    struct State {
+        mutable std::mutex mutex;
+        std::vector<Entry> entries;
+        size_t ramBytes { 0 };
+        size_t spillingBytes { 0 };
+        int diskCount { 0 };
+        uint64_t nextId { 1 };
+
+        std::filesystem::path spillFolder;
+        size_t ramBudgetBytes { 0 };
+        int maxDiskEntries { 0 };
+        EncodeWorkerPool* pool { nullptr };
+    };
+    std::shared_ptr<State> state { std::make_shared<State>() };
+
+    static void run(const std::shared_ptr<State>& state, const std::string& label, std::function<void()> job);
+
+    /// Pick RAM entries to spill and disk entries to drop until both tiers are within budget. Call with
+    /// the lock held; returns the file I/O jobs to run() once it's released.
+    static std::vector<std::function<void()>> enforceBudgetsLocked(const std::shared_ptr<State>& state);
+
+    static void runAll(const std::shared_ptr<State>& state, std::vector<std::function<void()>> jobs);
+};
+
+} // namespace ofxMarkSynth
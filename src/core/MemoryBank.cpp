@@ -7,7 +7,10 @@
 //
 
 #include "core/MemoryBank.hpp"
+#include "rendering/EncodeWorkerPool.hpp"
+#include "rendering/RenderingConstants.h"
 
+#include "ofGLUtils.h"
 #include "ofGraphics.h"
 #include "ofImage.h"
 #include "ofLog.h"
@@ -15,6 +18,7 @@
 
 #include <algorithm>
 #include <cmath>
+#include <utility>
 
 
 
@@ -35,76 +39,263 @@ static void updateOrderMostRecent(std::vector<int>& order, int slot) {
     order.push_back(slot);
 }
 
-static int findFirstFreeSlot(const std::array<bool, MemoryBank::NUM_SLOTS>& occupied) {
-    for (int i = 0; i < MemoryBank::NUM_SLOTS; ++i) {
+// Decoded memories are uploaded as RGBA at the slot size, with a thumbnail for the atlas
+static void prepareDecodedPixels(ofPixels& pixels, ofPixels& thumbnail, int width, int height, int thumbnailSize) {
+    pixels.setImageType(OF_IMAGE_COLOR_ALPHA);
+    if (pixels.getWidth() != static_cast<size_t>(width) || pixels.getHeight() != static_cast<size_t>(height)) {
+        pixels.resize(width, height, OF_INTERPOLATE_BICUBIC);
+    }
+    thumbnail = pixels;
+    thumbnail.resize(thumbnailSize, thumbnailSize, OF_INTERPOLATE_BICUBIC);
+}
+
+static void removeStaleSlotFile(const std::filesystem::path& folder, int slot) {
+    const std::filesystem::path path = getSlotFilePath(folder, slot);
+    std::error_code ec;
+    if (std::filesystem::exists(path, ec)) {
+        std::filesystem::remove(path, ec);
+        if (ec) {
+            ofLogWarning("MemoryBank") << "Failed to remove stale memory PNG: " << path << " (" << ec.message() << ")";
+        }
+    }
+}
+
+static int findFirstFreeSlot(const std::vector<bool>& occupied) {
+    for (int i = 0; i < static_cast<int>(occupied.size()); ++i) {
         if (!occupied[i]) return i;
     }
     return -1;
 }
 
-static bool isValidSlotIndex(int slot) {
-    return slot >= 0 && slot < MemoryBank::NUM_SLOTS;
+MemoryBank::~MemoryBank() {
+    releaseGl();
 }
 
-static ofPixels ensureRgbaPixels(const ofPixels& in) {
-    if (in.getNumChannels() == 4) {
-        return in;
+void MemoryBank::releaseGl() {
+    if (saveAll) {
+        // Slots not yet read back would be read from the new textures; let queued encodes finish.
+        int abandoned = static_cast<int>(saveAll->slotsToRead.size());
+        for (auto& readback : saveAll->readbacks) {
+            if (readback.fence) {
+                glDeleteSync(readback.fence);
+                abandoned++;
+            }
+            readback = SlotReadback();
+        }
+        saveAll->slotsToRead.clear();
+        if (abandoned > 0) {
+            ofLogWarning("MemoryBank") << "Abandoned saving " << abandoned << " memories to " << saveAll->folder;
+            saveAll->slotsFailed += abandoned;
+        }
     }
+    if (slotFbo) {
+        glDeleteFramebuffers(1, &slotFbo);
+        slotFbo = 0;
+    }
+    if (mipFbo) {
+        glDeleteFramebuffers(1, &mipFbo);
+        mipFbo = 0;
+    }
+    slotTextures.clear();
+    for (auto& demotion : demotions) {
+        glDeleteSync(demotion.fence);
+    }
+    demotions.clear();
+    slotsMemory.release();
+    captureMemory.release();
+}
 
-    const int w = in.getWidth();
-    const int h = in.getHeight();
+void MemoryBank::allocate(glm::vec2 size, int slotCount_, GLint internalFormat_) {
+    cancelLoadAll();
+    releaseGl();
+
+    // Promotions decode to the old slot size; let them finish into a queue nobody reads.
+    promotions = std::make_shared<PromotionState>();
+    promotionsPending = 0;
+    promotedSlots.clear();
+    currentUpload.reset();
+
+    slotCount = std::clamp(slotCount_, MIN_SLOT_COUNT, MAX_SLOT_COUNT);
+    internalFormat = internalFormat_;
+
+    // A full mip chain adds a third to each slot; registrations count it as extra rows.
+    const auto withMips = [](float height) { return static_cast<int>(std::ceil(height * 4.0f / 3.0f)); };
+
+    auto& registry = GpuMemoryRegistry::instance();
+    const size_t bytes = GpuMemoryRegistry::estimateBytes(size.x, withMips(size.y), internalFormat, slotCount);
+    const float budgetScale = registry.admit("MemoryBank", "slots", bytes, true);
+    memorySize = glm::max(glm::floor(size * budgetScale), glm::vec2 { 1.0f });
+    const int width = static_cast<int>(memorySize.x);
+    const int height = static_cast<int>(memorySize.y);
+
+    mipLevelCount = 1;
+    while ((std::max(width, height) >> mipLevelCount) > 0) mipLevelCount++;
+
+    captureFbo.allocate(width, height, internalFormat);
+    captureMemory = registry.addFbo("MemoryBank", "capture", captureFbo);
+
+    // GL_TEXTURE_2D whatever the ARB setting, since slots are attached with glFramebufferTexture2D
+    ofTextureData slotTexData;
+    slotTexData.width = width;
+    slotTexData.height = height;
+    slotTexData.glInternalFormat = internalFormat;
+    slotTexData.textureTarget = GL_TEXTURE_2D;
+    slotTextures.resize(slotCount);
+    for (auto& texture : slotTextures) {
+        texture.allocate(slotTexData);
+        ofTextureData& texData = texture.getTextureData();
+        texData.bFlipTexture = captureFbo.getTexture().getTextureData().bFlipTexture;
+        glBindTexture(GL_TEXTURE_2D, texData.textureID);
+        for (int level = 1; level < mipLevelCount; ++level) {
+            glTexImage2D(GL_TEXTURE_2D, level, internalFormat, std::max(1, width >> level), std::max(1, height >> level), 0,
+                         ofGetGLFormatFromInternal(internalFormat), ofGetGLTypeFromInternal(internalFormat), nullptr);
+        }
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, mipLevelCount - 1);
+        glBindTexture(GL_TEXTURE_2D, 0);
+        texData.hasMipmap = true;
+        texture.setTextureMinMagFilter(GL_LINEAR_MIPMAP_LINEAR, GL_LINEAR);
+        texture.setTextureWrap(GL_CLAMP_TO_EDGE, GL_CLAMP_TO_EDGE);
+    }
+    glGenFramebuffers(1, &slotFbo);
+    glGenFramebuffers(1, &mipFbo);
+
+    slotsMemory = registry.add("MemoryBank", "slots", width, withMips(height), internalFormat, slotCount);
+
+    thumbnailColumns = std::min(slotCount, 16);
+    const int thumbnailRows = (slotCount + thumbnailColumns - 1) / thumbnailColumns;
+    thumbnailAtlas.allocate(thumbnailColumns * THUMBNAIL_SIZE, thumbnailRows * THUMBNAIL_SIZE, GL_RGB8);
+    thumbnailAtlas.begin();
+    ofClear(0, 0, 0, 255);
+    thumbnailAtlas.end();
+
+    occupied.assign(slotCount, false);
+    mipsDirty.assign(slotCount, false);
+    handedOut.assign(slotCount, false);
+    slotCaptureTimeSec.assign(slotCount, -1.0f);
+    slotQualityScore.assign(slotCount, -1.0f);
+    for (int i = 0; i < slotCount; i++) {
+        clearSlot(i);
+    }
 
-    ofPixels out;
-    out.allocate(w, h, OF_PIXELS_RGBA);
+    allocated = true;
+    occupiedCount = 0;
+    saveOrder.clear();
+    pendingSaveSlot = -1;
+}
+
+GLint MemoryBank::bindSlot(GLenum target, int slot, int level) const {
+    GLint previous = 0;
+    glGetIntegerv(target == GL_READ_FRAMEBUFFER ? GL_READ_FRAMEBUFFER_BINDING : GL_DRAW_FRAMEBUFFER_BINDING, &previous);
+    glBindFramebuffer(target, slotFbo);
+    glFramebufferTexture2D(target, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, slotTextures[slot].getTextureData().textureID, level);
+    return previous;
+}
 
-    const int inChannels = in.getNumChannels();
-    const unsigned char* src = in.getData();
-    unsigned char* dst = out.getData();
+void MemoryBank::clearSlot(int slot) {
+    GLint previous = 0;
+    for (int level = 0; level < mipLevelCount; ++level) {
+        const GLint bound = bindSlot(GL_DRAW_FRAMEBUFFER, slot, level);
+        if (level == 0) previous = bound;
+        glClearColor(0, 0, 0, 0);
+        glClear(GL_COLOR_BUFFER_BIT);
+    }
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, previous);
+    mipsDirty[slot] = false;
+}
 
-    const size_t n = static_cast<size_t>(w) * static_cast<size_t>(h);
-    for (size_t i = 0; i < n; ++i) {
-        unsigned char r = 0;
-        unsigned char g = 0;
-        unsigned char b = 0;
-        unsigned char a = 255;
+void MemoryBank::buildMips(int slot) const {
+    GLint previousRead = 0;
+    GLint previousDraw = 0;
+    glGetIntegerv(GL_READ_FRAMEBUFFER_BINDING, &previousRead);
+    glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &previousDraw);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, slotFbo);
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, mipFbo);
+
+    // Each level is a linear-filtered half-size blit of the one above (a 2x2 box filter)
+    const GLuint textureId = slotTextures[slot].getTextureData().textureID;
+    const int width = static_cast<int>(memorySize.x);
+    const int height = static_cast<int>(memorySize.y);
+    for (int level = 1; level < mipLevelCount; ++level) {
+        glFramebufferTexture2D(GL_READ_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, textureId, level - 1);
+        glFramebufferTexture2D(GL_DRAW_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, textureId, level);
+        glBlitFramebuffer(0, 0, std::max(1, width >> (level - 1)), std::max(1, height >> (level - 1)),
+                          0, 0, std::max(1, width >> level), std::max(1, height >> level),
+                          GL_COLOR_BUFFER_BIT, GL_LINEAR);
+    }
 
-        if (inChannels == 3) {
-            r = src[i * 3 + 0];
-            g = src[i * 3 + 1];
-            b = src[i * 3 + 2];
-        } else if (inChannels == 1) {
-            r = g = b = src[i];
-        } else if (inChannels > 0) {
-            // Fallback: copy first channel into RGB.
-            r = g = b = src[i * inChannels];
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, previousRead);
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, previousDraw);
+    mipsDirty[slot] = false;
+}
+
+void MemoryBank::updateMips() {
+    if (!allocated) return;
+
+    // One slot a frame keeps the cost off capture frames; fetching a slot builds its chain first.
+    for (int slot = 0; slot < slotCount; ++slot) {
+        if (mipsDirty[slot]) {
+            buildMips(slot);
+            return;
         }
+    }
+}
 
-        dst[i * 4 + 0] = r;
-        dst[i * 4 + 1] = g;
-        dst[i * 4 + 2] = b;
-        dst[i * 4 + 3] = a;
+void MemoryBank::storeCapture(int slot) {
+    if (currentUpload && currentUpload->promoted && currentUpload->slot == slot) {
+        // The live capture wins
+        abandonPromotionUpload();
+    } else {
+        demoteSlot(slot);
     }
 
-    return out;
-}
+    GLint previous = 0;
+    glGetIntegerv(GL_READ_FRAMEBUFFER_BINDING, &previous);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, captureFbo.getId());
+    glBindTexture(GL_TEXTURE_2D, slotTextures[slot].getTextureData().textureID);
+    glCopyTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, 0, 0, captureFbo.getWidth(), captureFbo.getHeight());
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, previous);
 
+    drawThumbnail(slot, captureFbo.getTexture());
+}
 
+void MemoryBank::drawThumbnail(int slot, const ofTexture& texture) {
+    const float x = static_cast<float>((slot % thumbnailColumns) * THUMBNAIL_SIZE);
+    const float y = static_cast<float>((slot / thumbnailColumns) * THUMBNAIL_SIZE);
 
-void MemoryBank::allocate(glm::vec2 size, GLint internalFormat) {
-    memorySize = size;
+    thumbnailAtlas.begin();
+    ofPushStyle();
+    ofEnableBlendMode(OF_BLENDMODE_DISABLED);
+    ofSetColor(255);
+    texture.draw(x, y, THUMBNAIL_SIZE, THUMBNAIL_SIZE);
+    ofPopStyle();
+    thumbnailAtlas.end();
+}
 
-    for (int i = 0; i < NUM_SLOTS; i++) {
-        slots[i].allocate(memorySize.x, memorySize.y, internalFormat);
-        slots[i].begin();
-        ofClear(0, 0, 0, 0);
-        slots[i].end();
+void MemoryBank::getThumbnailTexCoords(int slot, glm::vec2& uv0, glm::vec2& uv1) const {
+    const glm::vec2 atlasSize { thumbnailAtlas.getWidth(), thumbnailAtlas.getHeight() };
+    const glm::vec2 tileSize { static_cast<float>(THUMBNAIL_SIZE) };
+    const glm::vec2 topLeft = glm::vec2 { slot % thumbnailColumns, slot / thumbnailColumns } * tileSize;
+    uv0 = topLeft / atlasSize;
+    uv1 = (topLeft + tileSize) / atlasSize;
+    if (thumbnailAtlas.getTexture().getTextureData().bFlipTexture) {
+        uv0.y = 1.0f - uv0.y;
+        uv1.y = 1.0f - uv1.y;
     }
+}
 
-    allocated = true;
-    occupied.fill(false);
-    occupiedCount = 0;
-    saveOrder.clear();
-    pendingSaveSlot = -1;
+void MemoryBank::markStored(int slot) {
+    if (!occupied[slot]) {
+        occupied[slot] = true;
+        occupiedCount++;
+    }
+    // A Mod drawing the slot would sample the old memory's mips until updateMips() got to it.
+    if (handedOut[slot]) {
+        buildMips(slot);
+    } else {
+        mipsDirty[slot] = true;
+    }
+    updateOrderMostRecent(saveOrder, slot);
 }
 
 int MemoryBank::save(const ofFbo& source, float centre, float width) {
@@ -114,7 +305,7 @@ int MemoryBank::save(const ofFbo& source, float centre, float width) {
     }
 
     const int existingCount = static_cast<int>(saveOrder.size());
-    const bool hasFreeSlot = occupiedCount < NUM_SLOTS;
+    const bool hasFreeSlot = occupiedCount < slotCount;
     const int maxIndex = (hasFreeSlot) ? existingCount : std::max(0, existingCount - 1);
 
     int selectedIndex = selectSlotIndex(centre, width, maxIndex);
@@ -152,14 +343,10 @@ void MemoryBank::saveToSlot(const ofFbo& source, int slot) {
         return;
     }
 
-    captureRandomCrop(slots[slot], source);
-
-    if (!occupied[slot]) {
-        occupied[slot] = true;
-        occupiedCount++;
-    }
-
-    updateOrderMostRecent(saveOrder, slot);
+    captureRandomCrop(source);
+    storeCapture(slot);
+    markStored(slot);
+    setSlotInfo(slot, -1.0f, -1.0f);
 }
 
 void MemoryBank::saveToSlotCrop(const ofFbo& source, int slot, glm::vec2 cropTopLeft) {
@@ -172,14 +359,10 @@ void MemoryBank::saveToSlotCrop(const ofFbo& source, int slot, glm::vec2 cropTop
         return;
     }
 
-    captureCrop(slots[slot], source, cropTopLeft);
-
-    if (!occupied[slot]) {
-        occupied[slot] = true;
-        occupiedCount++;
-    }
-
-    updateOrderMostRecent(saveOrder, slot);
+    captureCrop(source, cropTopLeft);
+    storeCapture(slot);
+    markStored(slot);
+    setSlotInfo(slot, -1.0f, -1.0f);
 }
 
 int MemoryBank::processPendingSave(const ofFbo& source) {
@@ -192,11 +375,11 @@ int MemoryBank::processPendingSave(const ofFbo& source) {
     return -1;
 }
 
-void MemoryBank::captureRandomCrop(ofFbo& dest, const ofFbo& source) {
+void MemoryBank::captureRandomCrop(const ofFbo& source) {
     float sourceW = source.getWidth();
     float sourceH = source.getHeight();
-    float destW = dest.getWidth();
-    float destH = dest.getHeight();
+    float destW = captureFbo.getWidth();
+    float destH = captureFbo.getHeight();
 
     float maxX = std::max(0.0f, sourceW - destW);
     float maxY = std::max(0.0f, sourceH - destH);
@@ -204,14 +387,14 @@ void MemoryBank::captureRandomCrop(ofFbo& dest, const ofFbo& source) {
     float x = ofRandom(0, maxX);
     float y = ofRandom(0, maxY);
 
-    captureCrop(dest, source, glm::vec2 { x, y });
+    captureCrop(source, glm::vec2 { x, y });
 }
 
-void MemoryBank::captureCrop(ofFbo& dest, const ofFbo& source, glm::vec2 cropTopLeft) {
+void MemoryBank::captureCrop(const ofFbo& source, glm::vec2 cropTopLeft) {
     float sourceW = source.getWidth();
     float sourceH = source.getHeight();
-    float destW = dest.getWidth();
-    float destH = dest.getHeight();
+    float destW = captureFbo.getWidth();
+    float destH = captureFbo.getHeight();
 
     float maxX = std::max(0.0f, sourceW - destW);
     float maxY = std::max(0.0f, sourceH - destH);
@@ -219,14 +402,14 @@ void MemoryBank::captureCrop(ofFbo& dest, const ofFbo& source, glm::vec2 cropTop
     float x = ofClamp(cropTopLeft.x, 0.0f, maxX);
     float y = ofClamp(cropTopLeft.y, 0.0f, maxY);
 
-    dest.begin();
+    captureFbo.begin();
     ofClear(0, 0, 0, 0);
     ofPushStyle();
     ofEnableBlendMode(OF_BLENDMODE_DISABLED);
     ofSetColor(255);
     source.getTexture().drawSubsection(0, 0, destW, destH, x, y, destW, destH);
     ofPopStyle();
-    dest.end();
+    captureFbo.end();
 }
 
 
@@ -274,23 +457,32 @@ const ofTexture* MemoryBank::selectRandom() const {
 }
 
 const ofTexture* MemoryBank::get(int slot) const {
-    if (!isValidSlotIndex(slot)) return nullptr;
+    if (!allocated || !isValidSlotIndex(slot)) return nullptr;
     if (!occupied[slot]) return nullptr;
-    if (!slots[slot].isAllocated()) return nullptr;
-    return &slots[slot].getTexture();
+
+    if (mipsDirty[slot]) {
+        buildMips(slot);
+    }
+    handedOut[slot] = true;
+    return &slotTextures[slot];
 }
 
 bool MemoryBank::isOccupied(int slot) const {
     if (!isValidSlotIndex(slot)) return false;
-    return occupied[slot] && slots[slot].isAllocated();
+    return occupied[slot];
 }
 
-bool MemoryBank::saveAllToFolder(const std::filesystem::path& folder) const {
+bool MemoryBank::beginSaveAllToFolder(const std::filesystem::path& folder, EncodeWorkerPool* encodePool) {
     if (!allocated) {
         ofLogError("MemoryBank") << "Cannot save: not allocated";
         return false;
     }
 
+    if (saveAll) {
+        ofLogWarning("MemoryBank") << "Cannot save: a save to " << saveAll->folder << " is still in progress";
+        return false;
+    }
+
     std::error_code ec;
     std::filesystem::create_directories(folder, ec);
     if (ec) {
@@ -298,36 +490,171 @@ bool MemoryBank::saveAllToFolder(const std::filesystem::path& folder) const {
         return false;
     }
 
-    bool ok = true;
-
-    for (int i = 0; i < NUM_SLOTS; ++i) {
-        const std::filesystem::path path = getSlotFilePath(folder, i);
+    auto state = std::make_shared<SaveAllState>();
+    state->folder = folder;
+    state->encodePool = encodePool;
+    state->width = static_cast<int>(memorySize.x);
+    state->height = static_cast<int>(memorySize.y);
 
+    for (int i = 0; i < slotCount; ++i) {
         if (occupied[i]) {
-            ofPixels pixels;
-            slots[i].readToPixels(pixels);
-            ofPixels rgba = ensureRgbaPixels(pixels);
+            state->slotsToRead.push_back(i);
+        } else {
+            removeStaleSlotFile(folder, i);
+        }
+    }
+
+    saveAll = std::move(state);
+    startSaveAllReadbacks();
+    return true;
+}
 
-            if (!ofSaveImage(rgba, path.string())) {
-                ofLogError("MemoryBank") << "Failed to save PNG: " << path;
-                ok = false;
+int MemoryBank::countSaveAllReadbacksInFlight() const {
+    return static_cast<int>(std::count_if(saveAll->readbacks.begin(), saveAll->readbacks.end(),
+                                          [](const SlotReadback& readback) { return readback.fence != nullptr; }));
+}
+
+void MemoryBank::startSaveAllReadbacks() {
+    const size_t byteSize = static_cast<size_t>(saveAll->width) * static_cast<size_t>(saveAll->height) * 4;
+    GLint previousAlignment = 4;
+    glGetIntegerv(GL_PACK_ALIGNMENT, &previousAlignment);
+
+    // Each slot holds a PBO until it's mapped, then its pixels until the PNG is written
+    int inFlight = countSaveAllReadbacksInFlight() + saveAll->encodesInFlight;
+    for (auto& readback : saveAll->readbacks) {
+        if (inFlight >= SAVE_ALL_BATCH_SIZE) break;
+        if (readback.fence) continue;
+
+        int slot = -1;
+        while (slot < 0 && !saveAll->slotsToRead.empty()) {
+            slot = saveAll->slotsToRead.front();
+            saveAll->slotsToRead.pop_front();
+            if (!occupied[slot]) {
+                // Cleared since the save began
+                removeStaleSlotFile(saveAll->folder, slot);
+                slot = -1;
             }
+        }
+        if (slot < 0) break;
+
+        readback.slot = slot;
+        readback.framesWaited = 0;
+        if (!readback.pbo.isAllocated()) {
+            readback.pbo.allocate(byteSize, GL_STREAM_READ);
+        }
+
+        // Read back as RGBA so the PNG keeps the opaque alpha the slots have always been saved with.
+        const GLint previous = bindSlot(GL_READ_FRAMEBUFFER, slot);
+        readback.pbo.bind(GL_PIXEL_PACK_BUFFER);
+        glPixelStorei(GL_PACK_ALIGNMENT, 1);
+        glReadPixels(0, 0, saveAll->width, saveAll->height, GL_RGBA, GL_UNSIGNED_BYTE, 0);
+        readback.pbo.unbind(GL_PIXEL_PACK_BUFFER);
+        glBindFramebuffer(GL_READ_FRAMEBUFFER, previous);
+
+        readback.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        inFlight++;
+    }
+
+    glPixelStorei(GL_PACK_ALIGNMENT, previousAlignment);
+}
+
+void MemoryBank::encodeSlotReadback(SlotReadback& readback) {
+    glDeleteSync(readback.fence);
+    readback.fence = nullptr;
+
+    const std::filesystem::path path = getSlotFilePath(saveAll->folder, readback.slot);
+
+    auto pixels = std::make_shared<ofPixels>();
+    readback.pbo.bind(GL_PIXEL_PACK_BUFFER);
+    const void* mapped = readback.pbo.map(GL_READ_ONLY);
+    if (mapped) {
+        pixels->setFromPixels(static_cast<const unsigned char*>(mapped), saveAll->width, saveAll->height, OF_PIXELS_RGBA);
+        readback.pbo.unmap();
+    }
+    readback.pbo.unbind(GL_PIXEL_PACK_BUFFER);
+
+    if (!mapped) {
+        ofLogError("MemoryBank") << "Failed to map readback for memory PNG: " << path;
+        saveAll->slotsFailed++;
+        return;
+    }
+
+    // The job holds the state alive, so it's safe for the bank to start another save meanwhile.
+    std::shared_ptr<SaveAllState> state = saveAll;
+    auto encode = [state, pixels, path] {
+        if (ofSaveImage(*pixels, path.string())) {
+            state->slotsWritten++;
         } else {
-            std::error_code rmEc;
-            if (std::filesystem::exists(path, rmEc)) {
-                std::filesystem::remove(path, rmEc);
-                if (rmEc) {
-                    ofLogWarning("MemoryBank") << "Failed to remove stale memory PNG: " << path << " (" << rmEc.message() << ")";
-                }
-            }
+            ofLogError("MemoryBank") << "Failed to save PNG: " << path;
+            state->slotsFailed++;
         }
+        state->encodesInFlight--;
+    };
+
+    state->encodesInFlight++;
+    if (state->encodePool) {
+        state->encodePool->submit("memory " + path.filename().string(), std::move(encode));
+    } else {
+        encode();
     }
+}
+
+std::optional<MemoryBank::SaveAllResult> MemoryBank::updateSaveAll() {
+    if (!saveAll) return std::nullopt;
+
+    for (auto& readback : saveAll->readbacks) {
+        if (!readback.fence) continue;
+        readback.framesWaited++;
+        GLenum result = (readback.framesWaited < PBO_FRAMES_TO_WAIT) ? GL_TIMEOUT_EXPIRED : glClientWaitSync(readback.fence, 0, 0);
+
+        if (result == GL_ALREADY_SIGNALED || result == GL_CONDITION_SATISFIED) {
+            encodeSlotReadback(readback);
+        } else if (result == GL_WAIT_FAILED || readback.framesWaited > PBO_MAX_FRAMES_BEFORE_ABANDON) {
+            ofLogError("MemoryBank") << "Readback of memory slot " << readback.slot << " failed/timed out after "
+                                     << readback.framesWaited << " frames";
+            glDeleteSync(readback.fence);
+            readback.fence = nullptr;
+            saveAll->slotsFailed++;
+        }
+    }
+    startSaveAllReadbacks();
+
+    if (!saveAll->slotsToRead.empty() || countSaveAllReadbacksInFlight() > 0 || saveAll->encodesInFlight > 0) return std::nullopt;
 
-    ofLogNotice("MemoryBank") << "Saved memories to folder: " << folder;
-    return ok;
+    SaveAllResult saveResult { saveAll->folder, saveAll->slotsWritten, saveAll->slotsFailed };
+    saveAll.reset();
+    ofLogNotice("MemoryBank") << "Saved " << saveResult.slotsWritten << " memories to folder: " << saveResult.folder
+                              << (saveResult.ok() ? "" : " (with failures)");
+    return saveResult;
 }
 
-bool MemoryBank::loadAllFromFolder(const std::filesystem::path& folder) {
+std::optional<MemoryBank::SaveAllResult> MemoryBank::flushSaveAll() {
+    if (!saveAll) return std::nullopt;
+
+    // Still a batch at a time: once encodes fill the batch, wait for the pool before reading more.
+    while (true) {
+        startSaveAllReadbacks();
+        bool encoded = false;
+        for (auto& readback : saveAll->readbacks) {
+            if (!readback.fence) continue;
+            glClientWaitSync(readback.fence, GL_SYNC_FLUSH_COMMANDS_BIT, GL_TIMEOUT_IGNORED);
+            encodeSlotReadback(readback);
+            encoded = true;
+        }
+        if (saveAll->slotsToRead.empty()) break;
+        if (!encoded || saveAll->encodesInFlight >= SAVE_ALL_BATCH_SIZE) {
+            if (!saveAll->encodePool) break;
+            saveAll->encodePool->waitIdle();
+        }
+    }
+
+    if (saveAll->encodesInFlight > 0 && saveAll->encodePool) {
+        saveAll->encodePool->waitIdle();
+    }
+    return updateSaveAll();
+}
+
+bool MemoryBank::beginLoadAllFromFolder(const std::filesystem::path& folder, EncodeWorkerPool* decodePool) {
     if (!allocated) {
         ofLogError("MemoryBank") << "Cannot load: not allocated";
         return false;
@@ -341,55 +668,252 @@ bool MemoryBank::loadAllFromFolder(const std::filesystem::path& folder) {
         return false;
     }
 
-    bool anyLoaded = false;
+    auto state = std::make_shared<LoadAllState>();
+    state->folder = folder;
+    state->width = static_cast<int>(memorySize.x);
+    state->height = static_cast<int>(memorySize.y);
+    loadAll = state;
+    slotsLoaded = 0;
+
+    bool anyFound = false;
 
-    for (int i = 0; i < NUM_SLOTS; ++i) {
+    for (int i = 0; i < slotCount; ++i) {
         const std::filesystem::path path = getSlotFilePath(folder, i);
         if (!std::filesystem::exists(path, ec) || ec) {
             ec.clear();
             continue;
         }
+        anyFound = true;
+
+        auto decode = [state, path, slot = i] {
+            if (!state->cancelled) {
+                DecodedSlot decoded;
+                decoded.slot = slot;
+                if (!ofLoadImage(decoded.pixels, path)) {
+                    ofLogWarning("MemoryBank") << "Failed to load memory PNG: " << path;
+                } else {
+                    prepareDecodedPixels(decoded.pixels, decoded.thumbnail, state->width, state->height, THUMBNAIL_SIZE);
+                    std::lock_guard<std::mutex> lock(state->mutex);
+                    state->decoded.push_back(std::move(decoded));
+                }
+            }
+            state->decodesInFlight--;
+        };
 
-        ofImage img;
-        if (!img.load(path.string())) {
-            ofLogWarning("MemoryBank") << "Failed to load memory PNG: " << path;
+        state->decodesInFlight++;
+        if (decodePool) {
+            decodePool->submit("memory " + path.filename().string(), std::move(decode));
+        } else {
+            decode();
+        }
+    }
+
+    if (!anyFound) {
+        loadAll.reset();
+    }
+    return anyFound;
+}
+
+void MemoryBank::updateLoadAll() {
+    if (!loadAll && promotionsPending == 0) return;
+
+    const int width = static_cast<int>(memorySize.x);
+    const int height = static_cast<int>(memorySize.y);
+    const int rowBytes = width * 4;
+    size_t budget = UPLOAD_BYTES_PER_FRAME;
+
+    while (budget >= static_cast<size_t>(rowBytes)) {
+        if (!currentUpload && loadAll) {
+            std::lock_guard<std::mutex> lock(loadAll->mutex);
+            if (!loadAll->decoded.empty()) {
+                currentUpload = std::move(loadAll->decoded.front());
+                loadAll->decoded.pop_front();
+                currentUploadRow = 0;
+            }
+        }
+        if (!currentUpload && promotionsPending > 0) {
+            std::lock_guard<std::mutex> lock(promotions->mutex);
+            if (!promotions->decoded.empty()) {
+                currentUpload = std::move(promotions->decoded.front());
+                promotions->decoded.pop_front();
+                currentUploadRow = 0;
+            }
+        }
+        if (!currentUpload) break;
+
+        const int slot = currentUpload->slot;
+        if (currentUpload->promoted) {
+            if (!currentUpload->pixels.isAllocated()) {
+                promotionsPending--;
+                currentUpload.reset();
+                continue;
+            }
+            if (currentUploadRow == 0) {
+                demoteSlot(slot);
+            }
+        } else if (occupied[slot]) {
+            // Captured live while this slot was decoding; the newer memory wins.
+            currentUpload.reset();
             continue;
         }
 
-        if (img.getWidth() != memorySize.x || img.getHeight() != memorySize.y) {
-            img.resize(static_cast<int>(memorySize.x), static_cast<int>(memorySize.y));
+        const int rows = std::min(height - currentUploadRow, static_cast<int>(budget / rowBytes));
+        const size_t bytes = static_cast<size_t>(rows) * rowBytes;
+        const unsigned char* src = currentUpload->pixels.getData() + static_cast<size_t>(currentUploadRow) * rowBytes;
+
+        // Orphan and refill the PBO so the driver can DMA the band without stalling on the previous one.
+        uploadPbo.setData(bytes, src, GL_STREAM_DRAW);
+
+        glBindTexture(GL_TEXTURE_2D, slotTextures[slot].getTextureData().textureID);
+        uploadPbo.bind(GL_PIXEL_UNPACK_BUFFER);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, currentUploadRow, width, rows, GL_RGBA, GL_UNSIGNED_BYTE, 0);
+        uploadPbo.unbind(GL_PIXEL_UNPACK_BUFFER);
+        glBindTexture(GL_TEXTURE_2D, 0);
+
+        budget -= bytes;
+        currentUploadRow += rows;
+
+        if (currentUploadRow >= height) {
+            thumbnailUpload.loadData(currentUpload->thumbnail);
+            drawThumbnail(slot, thumbnailUpload);
+            markStored(slot);
+            setSlotInfo(slot, currentUpload->captureTimeSec, currentUpload->qualityScore);
+            if (currentUpload->promoted) {
+                promotedSlots.push_back({ slot, currentUpload->captureTimeSec, currentUpload->qualityScore });
+                promotionsPending--;
+            } else {
+                slotsLoaded++;
+            }
+            currentUpload.reset();
         }
+    }
 
-        slots[i].begin();
-        ofClear(0, 0, 0, 0);
-        ofPushStyle();
-        ofEnableBlendMode(OF_BLENDMODE_DISABLED);
-        ofSetColor(255);
-        img.draw(0, 0, slots[i].getWidth(), slots[i].getHeight());
-        ofPopStyle();
-        slots[i].end();
+    if (loadAll && !(currentUpload && !currentUpload->promoted) && loadAll->decodesInFlight == 0) {
+        std::lock_guard<std::mutex> lock(loadAll->mutex);
+        if (loadAll->decoded.empty()) {
+            ofLogNotice("MemoryBank") << "Loaded " << slotsLoaded << " memories from folder: " << loadAll->folder;
+            loadAll.reset();
+        }
+    }
+    if (!loadAll && promotionsPending == 0) {
+        uploadPbo = ofBufferObject();
+    }
+}
 
-        occupied[i] = true;
-        occupiedCount++;
-        saveOrder.push_back(i);
-        anyLoaded = true;
+void MemoryBank::setupArchive(const std::filesystem::path& spillFolder, size_t ramBudgetBytes, int maxDiskEntries, EncodeWorkerPool* pool) {
+    archive.setup(spillFolder, ramBudgetBytes, maxDiskEntries, pool);
+    if (archive.isEnabled()) {
+        ofLogNotice("MemoryBank") << "Archiving overwritten memories: " << (ramBudgetBytes / (1024 * 1024)) << " MB in RAM, up to "
+                                  << maxDiskEntries << " in " << spillFolder;
     }
+}
+
+void MemoryBank::setSlotInfo(int slot, float captureTimeSec, float qualityScore) {
+    if (!isValidSlotIndex(slot)) return;
+    slotCaptureTimeSec[slot] = captureTimeSec;
+    slotQualityScore[slot] = qualityScore;
+}
+
+void MemoryBank::demoteSlot(int slot) {
+    if (!archive.isEnabled() || !occupied[slot]) return;
+
+    const int width = static_cast<int>(memorySize.x);
+    const int height = static_cast<int>(memorySize.y);
+
+    Demotion& demotion = demotions.emplace_back();
+    demotion.captureTimeSec = slotCaptureTimeSec[slot];
+    demotion.qualityScore = slotQualityScore[slot];
+    demotion.pbo.allocate(static_cast<size_t>(width) * static_cast<size_t>(height) * 3, GL_STREAM_READ);
+
+    // Queued ahead of the overwrite, so the readback sees the old memory.
+    const GLint previous = bindSlot(GL_READ_FRAMEBUFFER, slot);
+    demotion.pbo.bind(GL_PIXEL_PACK_BUFFER);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glReadPixels(0, 0, width, height, GL_RGB, GL_UNSIGNED_BYTE, 0);
+    demotion.pbo.unbind(GL_PIXEL_PACK_BUFFER);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, previous);
+
+    demotion.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
+
+void MemoryBank::updateArchive() {
+    const int width = static_cast<int>(memorySize.x);
+    const int height = static_cast<int>(memorySize.y);
+
+    for (auto it = demotions.begin(); it != demotions.end();) {
+        it->framesWaited++;
+        GLenum result = (it->framesWaited < PBO_FRAMES_TO_WAIT) ? GL_TIMEOUT_EXPIRED : glClientWaitSync(it->fence, 0, 0);
 
-    if (anyLoaded) {
-        ofLogNotice("MemoryBank") << "Loaded " << occupiedCount << " memories from folder: " << folder;
+        if (result == GL_ALREADY_SIGNALED || result == GL_CONDITION_SATISFIED) {
+            ofPixels pixels;
+            it->pbo.bind(GL_PIXEL_PACK_BUFFER);
+            if (const void* mapped = it->pbo.map(GL_READ_ONLY)) {
+                pixels.setFromPixels(static_cast<const unsigned char*>(mapped), width, height, OF_PIXELS_RGB);
+                it->pbo.unmap();
+            }
+            it->pbo.unbind(GL_PIXEL_PACK_BUFFER);
+            glDeleteSync(it->fence);
+
+            if (pixels.isAllocated()) {
+                archive.add(std::move(pixels), it->captureTimeSec, it->qualityScore);
+            } else {
+                ofLogError("MemoryBank") << "Failed to map readback of a demoted memory";
+            }
+            it = demotions.erase(it);
+        } else if (result == GL_WAIT_FAILED || it->framesWaited > PBO_MAX_FRAMES_BEFORE_ABANDON) {
+            ofLogError("MemoryBank") << "Readback of a demoted memory failed/timed out after " << it->framesWaited << " frames";
+            glDeleteSync(it->fence);
+            it = demotions.erase(it);
+        } else {
+            ++it;
+        }
     }
+}
+
+bool MemoryBank::requestPromotion(uint64_t archiveId, int slot) {
+    if (!allocated || !isValidSlotIndex(slot)) return false;
+
+    const int width = static_cast<int>(memorySize.x);
+    const int height = static_cast<int>(memorySize.y);
+    std::shared_ptr<PromotionState> state = promotions;
+
+    const bool taken = archive.take(archiveId, [state, slot, width, height](ofPixels&& pixels, const MemoryArchive::EntryInfo& info) {
+        DecodedSlot decoded;
+        decoded.slot = slot;
+        decoded.promoted = true;
+        decoded.captureTimeSec = info.captureTimeSec;
+        decoded.qualityScore = info.qualityScore;
+        decoded.pixels = std::move(pixels);
+        if (decoded.pixels.isAllocated()) {
+            prepareDecodedPixels(decoded.pixels, decoded.thumbnail, width, height, THUMBNAIL_SIZE);
+        }
+        std::lock_guard<std::mutex> lock(state->mutex);
+        state->decoded.push_back(std::move(decoded));
+    });
 
-    return anyLoaded;
+    if (taken) promotionsPending++;
+    return taken;
 }
 
-void MemoryBank::clear(int slot) {
-    if (!isValidSlotIndex(slot)) return;
+std::vector<MemoryBank::PromotedSlot> MemoryBank::takePromotedSlots() {
+    return std::exchange(promotedSlots, {});
+}
 
-    if (slots[slot].isAllocated()) {
-        slots[slot].begin();
-        ofClear(0, 0, 0, 0);
-        slots[slot].end();
+void MemoryBank::cancelLoadAll() {
+    if (!loadAll) return;
+    loadAll->cancelled = true;
+    loadAll.reset();
+    if (currentUpload && !currentUpload->promoted) {
+        currentUpload.reset();
+        currentUploadRow = 0;
     }
+}
+
+void MemoryBank::clear(int slot) {
+    if (!allocated || !isValidSlotIndex(slot)) return;
+
+    clearSlot(slot);
 
     if (occupied[slot]) {
         occupied[slot] = false;
@@ -403,16 +927,26 @@ void MemoryBank::clear(int slot) {
     }
 }
 
+void MemoryBank::abandonPromotionUpload() {
+    archive.add(std::move(currentUpload->pixels), currentUpload->captureTimeSec, currentUpload->qualityScore);
+    currentUpload.reset();
+    currentUploadRow = 0;
+    promotionsPending--;
+}
+
 void MemoryBank::clearAll() {
-    for (int i = 0; i < NUM_SLOTS; i++) {
-        if (slots[i].isAllocated()) {
-            slots[i].begin();
-            ofClear(0, 0, 0, 0);
-            slots[i].end();
-        }
+    cancelLoadAll();
+    // Its remaining rows would land on a cleared slot
+    if (currentUpload && currentUpload->promoted) abandonPromotionUpload();
+    currentUploadRow = 0;
+
+    if (!allocated) return;
+
+    for (int i = 0; i < slotCount; i++) {
+        clearSlot(i);
     }
 
-    occupied.fill(false);
+    occupied.assign(slotCount, false);
     occupiedCount = 0;
     saveOrder.clear();
     pendingSaveSlot = -1;
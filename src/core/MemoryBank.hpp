@@ -5,25 +5,72 @@
 //  Memory bank for storing texture fragments captured from the composite
 //  during live performance, enabling recall of earlier visual states.
 //
+//  Each slot is a plain texture (no FBO of its own), so the slot count is a setting: captures are
+//  drawn into one staging FBO and copied into the slot, and clears, readbacks and mip builds go
+//  through a single FBO re-pointed at the slot. Consumers are handed the slot's own texture, which
+//  they can keep: it always shows that slot's current memory.
+//
+//  Every slot has a full mip chain, rebuilt a slot per frame after captures and loads (or on demand
+//  when a slot is fetched first), and samples with trilinear minification, so memories drawn small
+//  read a matching level instead of aliasing the full-size texture.
+//
+//  With an archive set up, memories that get overwritten are demoted to a MemoryArchive
+//  (compressed RAM, then disk) and can be promoted back into a slot later.
+//
 
 #pragma once
 
+#include "core/MemoryArchive.hpp"
+#include "rendering/GpuMemoryRegistry.hpp"
+#include "ofBufferObject.h"
 #include "ofFbo.h"
+#include "ofPixels.h"
 #include "ofTexture.h"
 #include <array>
+#include <atomic>
+#include <cstdint>
+#include <deque>
 #include <filesystem>
+#include <memory>
+#include <mutex>
+#include <optional>
 #include <vector>
 
 namespace ofxMarkSynth {
 
+class EncodeWorkerPool;
+
 class MemoryBank {
 public:
-    static constexpr int NUM_SLOTS = 8;
+    static constexpr int MIN_SLOT_COUNT = 8;
+    static constexpr int MAX_SLOT_COUNT = 128;
+    static constexpr int DEFAULT_SLOT_COUNT = 32;
+    static constexpr int SAVE_ALL_BATCH_SIZE = 4;  // Slots being read back or encoded at once by saveAll
+    static constexpr int THUMBNAIL_SIZE = 64;      // Tile size in the thumbnail atlas
+    static constexpr size_t UPLOAD_BYTES_PER_FRAME = 4 * 1024 * 1024;  // One 1024x1024 RGBA slot
+
+    struct PromotedSlot {
+        int slot { -1 };
+        float captureTimeSec { -1.0f };
+        float qualityScore { -1.0f };
+    };
+
+    struct SaveAllResult {
+        std::filesystem::path folder;
+        int slotsWritten { 0 };
+        int slotsFailed { 0 };
+        bool ok() const { return slotsFailed == 0; }
+    };
 
     MemoryBank() = default;
+    ~MemoryBank();
+
+    MemoryBank(const MemoryBank&) = delete;
+    MemoryBank& operator=(const MemoryBank&) = delete;
 
-    /// Allocate FBOs for all slots at the specified size
-    void allocate(glm::vec2 memorySize, GLint internalFormat = GL_RGB8);
+    /// Allocate the slot array at the specified size (reduced if over the GPU memory budget)
+    /// @param slotCount Number of slots, clamped to [MIN_SLOT_COUNT, MAX_SLOT_COUNT]
+    void allocate(glm::vec2 memorySize, int slotCount = DEFAULT_SLOT_COUNT, GLint internalFormat = GL_RGB8);
 
     /// Save a random crop from source into a slot selected by centre/width
     /// @param source The source FBO to crop from (typically the full composite)
@@ -62,25 +109,81 @@ public:
     /// Select purely random from filled slots
     const ofTexture* selectRandom() const;
 
-    /// Direct slot access (returns nullptr if slot is empty or out of range)
+    /// Direct slot access (returns nullptr if slot is empty or out of range).
+    /// This is the slot's own texture, with its mip chain built: copies kept by consumers share it,
+    /// and show whatever the slot holds later on (until the bank is reallocated), drawn at any size
+    /// through trilinear filtering.
     const ofTexture* get(int slot) const;
 
     /// Check if a slot contains a memory
     bool isOccupied(int slot) const;
 
-    /// Number of occupied slots (0 to NUM_SLOTS)
+    /// Number of occupied slots (0 to getSlotCount())
     int getFilledCount() const { return occupiedCount; }
 
+    int getSlotCount() const { return slotCount; }
+
+
+    /// Rebuild the mip chain of one slot whose content changed since its chain was built (call once a frame).
+    /// Slots whose texture consumers may hold are rebuilt as soon as they're stored instead.
+    void updateMips();
+
+    /// Small previews of every slot, tiled THUMBNAIL_SIZE apart (for the GUI)
+    const ofTexture& getThumbnailAtlas() const { return thumbnailAtlas.getTexture(); }
+
+    /// Texture coordinates of a slot's tile in the thumbnail atlas, top-left and bottom-right as displayed
+    void getThumbnailTexCoords(int slot, glm::vec2& uv0, glm::vec2& uv1) const;
+
     /// Get the configured memory size
     glm::vec2 getMemorySize() const { return memorySize; }
 
-    /// Save all occupied slots as PNGs.
-    /// Empty slots remove their PNG (to avoid stale files).
-    bool saveAllToFolder(const std::filesystem::path& folder) const;
+    /// Start saving all occupied slots as PNGs: slots are read back through a ring of
+    /// SAVE_ALL_BATCH_SIZE fenced PBOs and encoded on the worker pool (inline when the pool is
+    /// null), at most SAVE_ALL_BATCH_SIZE at a time, so memory use doesn't grow with the slot count.
+    /// A slot overwritten before its turn is saved as its newer memory. Empty slots remove their
+    /// PNG (to avoid stale files). Returns false if a save is already in progress or the folder can't be created.
+    bool beginSaveAllToFolder(const std::filesystem::path& folder, EncodeWorkerPool* encodePool);
+
+    /// Poll readbacks of an in-progress save and hand completed ones to the encoder. Never blocks.
+    /// @return The result once every slot has been written, otherwise std::nullopt
+    std::optional<SaveAllResult> updateSaveAll();
+
+    /// Block until an in-progress save has finished (for shutdown).
+    std::optional<SaveAllResult> flushSaveAll();
 
-    /// Load any slot PNGs found in the folder (slot-<i>.png).
-    /// Supports holes: missing files leave empty slots.
-    bool loadAllFromFolder(const std::filesystem::path& folder);
+    bool isSaveAllInProgress() const { return saveAll != nullptr; }
+
+    /// Start loading any slot PNGs found in the folder (slot-<i>.png). Clears the bank first, which
+    /// cancels a load still in progress and returns a half-uploaded promotion to the archive.
+    /// Decoding and resizing run on the worker pool (inline when the pool is null); uploads are
+    /// streamed by updateLoadAll(). Supports holes: missing files leave empty slots.
+    /// @return true if any slot files were found
+    bool beginLoadAllFromFolder(const std::filesystem::path& folder, EncodeWorkerPool* decodePool);
+
+    /// Upload decoded slots through a PBO, at most UPLOAD_BYTES_PER_FRAME per call. Each slot becomes
+    /// usable as soon as its last rows are uploaded. Never blocks on the decoders.
+    void updateLoadAll();
+
+    bool isLoadAllInProgress() const { return loadAll != nullptr; }
+
+    /// Archive overwritten memories (see MemoryArchive). A zero RAM budget leaves archiving off.
+    void setupArchive(const std::filesystem::path& spillFolder, size_t ramBudgetBytes, int maxDiskEntries, EncodeWorkerPool* pool);
+
+    const MemoryArchive& getArchive() const { return archive; }
+
+    /// Record a slot's capture time and quality score (< 0 if unknown); they go with it into the archive
+    void setSlotInfo(int slot, float captureTimeSec, float qualityScore);
+
+    /// Start bringing an archived memory back into a slot, whose current memory is archived in turn.
+    /// Decoding runs on the worker pool and the upload shares updateLoadAll()'s per-frame budget.
+    /// @return false if the entry no longer exists or the slot is invalid
+    bool requestPromotion(uint64_t archiveId, int slot);
+
+    /// Slots whose promotion has completed since the last call
+    std::vector<PromotedSlot> takePromotedSlots();
+
+    /// Poll readbacks of demoted memories and hand them to the archive. Never blocks.
+    void updateArchive();
 
     /// Clear a specific slot (does not reallocate, just marks as empty)
     void clear(int slot);
@@ -89,23 +192,142 @@ public:
     void clearAll();
 
 private:
-    std::array<ofFbo, NUM_SLOTS> slots;
-    std::array<bool, NUM_SLOTS> occupied { false, false, false, false, false, false, false, false };
+    int slotCount { DEFAULT_SLOT_COUNT };
+    GLint internalFormat { GL_RGB8 };
+    std::vector<ofTexture> slotTextures;
+    GLuint slotFbo { 0 };           // Re-pointed at one slot level at a time for clears, readbacks and mip builds
+    GLuint mipFbo { 0 };            // Draw side of the level-to-level blits in buildMips()
+    int mipLevelCount { 1 };
+    mutable std::vector<bool> mipsDirty;
+    mutable std::vector<bool> handedOut;  // get() has returned the slot's texture, so a consumer may be drawing it
+    GpuMemoryRegistry::Registration slotsMemory;
+    std::vector<bool> occupied;
+    std::vector<float> slotCaptureTimeSec;
+    std::vector<float> slotQualityScore;
     int occupiedCount { 0 };
 
+    // Captures are drawn here, then copied into their slot
+    ofFbo captureFbo;
+    GpuMemoryRegistry::Registration captureMemory;
+
+    ofFbo thumbnailAtlas;
+    int thumbnailColumns { 1 };
+    ofTexture thumbnailUpload;      // Staging for thumbnails of slots loaded from disk
+
     // Slot indices ordered from oldest -> most recent.
     // Used to preserve "centre" semantics even with holes.
     std::vector<int> saveOrder;
 
+    // In-progress saveAll: slots wait their turn for a readback PBO from the ring, then a PNG encode job
+    struct SlotReadback {
+        int slot { -1 };
+        ofBufferObject pbo;
+        GLsync fence { nullptr };   // Null while the PBO is free
+        int framesWaited { 0 };
+    };
+    struct SaveAllState {
+        std::filesystem::path folder;
+        EncodeWorkerPool* encodePool { nullptr };
+        int width { 0 };
+        int height { 0 };
+        std::deque<int> slotsToRead;
+        std::array<SlotReadback, SAVE_ALL_BATCH_SIZE> readbacks;
+        std::atomic<int> encodesInFlight { 0 };
+        std::atomic<int> slotsWritten { 0 };
+        std::atomic<int> slotsFailed { 0 };
+    };
+    std::shared_ptr<SaveAllState> saveAll;  // Shared with encode jobs
+
+    /// Map a completed readback and encode it (on the pool if there is one), freeing its PBO
+    void encodeSlotReadback(SlotReadback& readback);
+
+    /// Start readbacks of waiting slots into free PBOs, keeping SAVE_ALL_BATCH_SIZE slots in flight at most
+    void startSaveAllReadbacks();
+
+    int countSaveAllReadbacksInFlight() const;
+
+    // In-progress loadAll: decode jobs push into `decoded`; the main thread uploads in row bands
+    struct DecodedSlot {
+        int slot { -1 };
+        ofPixels pixels;     // RGBA at memorySize (empty if a promotion failed to decode)
+        ofPixels thumbnail;  // RGBA at THUMBNAIL_SIZE
+        bool promoted { false };
+        float captureTimeSec { -1.0f };
+        float qualityScore { -1.0f };
+    };
+    struct LoadAllState {
+        std::filesystem::path folder;
+        int width { 0 };
+        int height { 0 };
+        std::mutex mutex;
+        std::deque<DecodedSlot> decoded;
+        std::atomic<int> decodesInFlight { 0 };
+        std::atomic<bool> cancelled { false };
+    };
+    std::shared_ptr<LoadAllState> loadAll;  // Shared with decode jobs
+    std::optional<DecodedSlot> currentUpload;
+    int currentUploadRow { 0 };
+    int slotsLoaded { 0 };
+    ofBufferObject uploadPbo;
+
+    void cancelLoadAll();
+
+    // Demotions: the slot's texture is read back before it's overwritten, then archived
+    struct Demotion {
+        ofBufferObject pbo;
+        GLsync fence { nullptr };
+        int framesWaited { 0 };
+        float captureTimeSec { -1.0f };
+        float qualityScore { -1.0f };
+    };
+    MemoryArchive archive;
+    std::vector<Demotion> demotions;
+
+    // Promotions: decode jobs push into `decoded`; uploads go through currentUpload like loads
+    struct PromotionState {
+        std::mutex mutex;
+        std::deque<DecodedSlot> decoded;
+    };
+    std::shared_ptr<PromotionState> promotions { std::make_shared<PromotionState>() };
+    int promotionsPending { 0 };  // Requested and not yet uploaded or dropped
+    std::vector<PromotedSlot> promotedSlots;
+    /// Send a half-uploaded promotion back to the archive (its slot's memory was demoted when it started)
+    void abandonPromotionUpload();
+
+    /// Read back an occupied slot for the archive (no-op when archiving is off)
+    void demoteSlot(int slot);
+
+    bool isValidSlotIndex(int slot) const { return slot >= 0 && slot < slotCount; }
+
+    /// Bind slotFbo to `target` with a level of the slot's texture attached. Returns the previous binding.
+    GLint bindSlot(GLenum target, int slot, int level = 0) const;
+
+    /// Clear every level of a slot's texture to transparent black
+    void clearSlot(int slot);
+
+    /// Downsample level 0 of a slot's texture through its mip chain
+    void buildMips(int slot) const;
+
+    /// Copy captureFbo into a slot's texture and its thumbnail tile
+    void storeCapture(int slot);
+
+    /// Draw a texture into a slot's thumbnail tile
+    void drawThumbnail(int slot, const ofTexture& texture);
+
+    /// Mark a slot as holding a new memory
+    void markStored(int slot);
+
+    void releaseGl();
+
     glm::vec2 memorySize { 1024, 1024 };
     bool allocated { false };
     int pendingSaveSlot { -1 };
 
-    /// Capture a random crop from source into the destination FBO
-    void captureRandomCrop(ofFbo& dest, const ofFbo& source);
+    /// Capture a random crop from source into captureFbo
+    void captureRandomCrop(const ofFbo& source);
 
-    /// Capture a crop from source into the destination FBO
-    void captureCrop(ofFbo& dest, const ofFbo& source, glm::vec2 cropTopLeft);
+    /// Capture a crop from source into captureFbo
+    void captureCrop(const ofFbo& source, glm::vec2 cropTopLeft);
 
     /// Map centre/width to an index in [0, maxIndex]
     int selectSlotIndex(float centre, float width, int maxIndex) const;
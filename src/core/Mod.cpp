@@ -222,6 +222,7 @@ int Mod::getSinkId(const std::string& sinkName) {
 
 template<typename T>
 void Mod::emit(int sourceId, const T& value) {
+  emitCount++;
   if (!connections.contains(sourceId)) return;
   //  if (connections[sourceId] == nullptr) { ofLogError() << "bad connection in " << typeid(*this).name() << " with sourceId " << sourceId; return; }
   std::for_each(connections[sourceId]->begin(),
@@ -300,6 +301,7 @@ std::optional<DrawingLayerPtr> Mod::getNamedDrawingLayerPtr(const std::string& n
 
   auto layerPtr = drawingLayerPtrs[index];
   if (layerPtr->pauseState == DrawingLayer::PauseState::PAUSED) return std::nullopt;
+  if (!layerPtr->isVisible) return std::nullopt;
 
   return layerPtr;
 }
@@ -312,6 +314,13 @@ std::optional<DrawingLayerPtr> Mod::getCurrentNamedDrawingLayerPtr(const std::st
   return getNamedDrawingLayerPtr(name, index);
 }
 
+void Mod::markReadLayersVisible() const {
+  for (const auto& [layerName, layerPtrs] : namedDrawingLayerPtrs) {
+    if (!readsNamedLayer(layerName)) continue;
+    for (const auto& layerPtr : layerPtrs) layerPtr->isVisible = true;
+  }
+}
+
 std::optional<std::string> Mod::getRandomLayerName() const {
   if (namedDrawingLayerPtrs.empty()) return std::nullopt;
   auto it = namedDrawingLayerPtrs.begin();
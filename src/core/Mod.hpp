@@ -62,6 +62,7 @@ struct DrawingLayer {
 
   enum class PauseState { ACTIVE, PAUSED };
   PauseState pauseState { PauseState::ACTIVE };
+  bool isVisible { true }; // false while the composite alpha is zero and no Mod reads the layer
 
   DrawingLayer() : id(nextId++) {}
   DrawingLayer(const std::string& name_, const std::string& tag_, FboPtr fboPtr_, bool clearOnUpdate_,
@@ -172,6 +173,9 @@ public:
   void setName(const std::string& name_) { name = name_; }
   const std::string& getName() const;
 
+  // Number of emit() calls since the last call (for telemetry).
+  uint32_t takeEmitCount() { return std::exchange(emitCount, 0); }
+
   // Explicit preset name from the synth config (empty means none / _default).
   void setPresetName(const std::string& presetName_);
   const std::string& getPresetName() const;
@@ -196,6 +200,11 @@ public:
   void receiveDrawingLayerPtr(const std::string& name, const DrawingLayerPtr drawingLayerPtr);
   std::optional<DrawingLayerPtr> getCurrentNamedDrawingLayerPtr(const std::string& name) const;
 
+  // Layers under a name this returns true for are sampled by the Mod (not just drawn on), or feed
+  // its sources, so they are kept visible to every Mod drawing on them even at zero alpha.
+  virtual bool readsNamedLayer(const std::string& layerName) const { (void)layerName; return false; }
+  void markReadLayersVisible() const;
+
   static constexpr int SINK_CHANGE_LAYER = -300;
 
   // TODO: clean all this up
@@ -224,7 +233,7 @@ protected:
   std::optional<std::string> getRandomLayerName() const;
 
   // A Mod is considered "able to draw" on a named layer if the current layer index is valid
-  // AND the layer is not paused (see DrawingLayer::pauseState).
+  // AND the layer is neither paused nor invisible (see DrawingLayer::pauseState and isVisible).
   bool canDrawOnNamedLayer(const std::string& layerName = DEFAULT_DRAWING_LAYER_PTR_NAME) const {
     return getCurrentNamedDrawingLayerPtr(layerName).has_value();
   }
@@ -253,6 +262,7 @@ private:
   std::unordered_map<std::string, int> currentDrawingLayerIndices; // index < 0 means don't draw
   int id;
   static int nextId;
+  uint32_t emitCount { 0 };
 };
 
 
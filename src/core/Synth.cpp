@@ -71,6 +71,7 @@ std::string Synth::saveConfigFilePath(const std::string& filename) {
 constexpr std::string SNAPSHOTS_FOLDER_NAME = "drawing";
 constexpr std::string AUTO_SNAPSHOTS_FOLDER_NAME = "drawing-auto";
 constexpr std::string RECORDINGS_FOLDER_NAME = "recordings";
+constexpr std::string TELEMETRY_FOLDER_NAME = "telemetry";
 // Also: mod-params/snapshots, node-layouts
 // Also: ModSnapshotManager uses "mod-params/snapshots" and NodeEditorLayoutManager uses "node-layouts"
 
@@ -177,6 +178,22 @@ audioAnalysisClientPtr { std::move(audioAnalysisClient) }
   initPerformanceNavigator();
   initSinkSourceMappings();
 
+  if (auto hzPtr = resources.get<float>("debugViewRefreshHz"); hzPtr) {
+    setDebugViewRefreshHz(*hzPtr);
+  }
+  if (auto roundRobinPtr = resources.get<bool>("debugViewRoundRobin"); roundRobinPtr) {
+    setDebugViewRoundRobin(*roundRobinPtr);
+  }
+  if (auto telemetryPtr = resources.get<bool>("telemetryEnabled"); telemetryPtr) {
+    modTelemetry.setEnabled(*telemetryPtr);
+  }
+  if (auto deepIdlePtr = resources.get<float>("deepIdleFrameRate"); deepIdlePtr) {
+    deepIdleFrameRate = *deepIdlePtr;
+  }
+  if (auto frameRatePtr = resources.get<float>("frameRate"); frameRatePtr) {
+    sessionFrameRate = *frameRatePtr;
+  }
+
   // Enable node editor tooltips / contribution weights for background colour.
   registerControllerForSource(backgroundColorParameter, backgroundColorController);
 }
@@ -251,19 +268,41 @@ void Synth::initRendering(glm::vec2 compositeSize) {
   compositeRenderer->allocate(compositeSize, ofGetWindowWidth(), ofGetWindowHeight(),
                               *resources.getRequired<float>("compositePanelGapPx"));
 
-  imageSaver = std::make_unique<AsyncImageSaver>(compositeSize);
+  configTransitionManager->allocate(compositeSize);
+
+  encodeWorkerPool = std::make_unique<EncodeWorkerPool>();
+  imageSaver = std::make_unique<AsyncImageSaver>(compositeSize, *encodeWorkerPool);
+  configThumbnailSaver = std::make_unique<ConfigThumbnailSaver>(*encodeWorkerPool);
+  if (auto compressionPtr = resources.get<ExrCompression>("snapshotExrCompression"); compressionPtr) {
+    imageSaver->setCompression(*compressionPtr);
+  }
 
-#ifdef TARGET_MAC
+#ifdef OFXMARKSYNTH_VIDEO_RECORDING
   const auto ffmpegPath = *resources.getRequired<std::filesystem::path>("ffmpegBinaryPath");
+  int recorderPboCount = DEFAULT_RECORDER_PBO_COUNT;
+  if (auto pboCountPtr = resources.get<int>("recorderPboCount"); pboCountPtr) {
+    recorderPboCount = *pboCountPtr;
+  }
+  RecordingPixelFormat recorderPixelFormat = RecordingPixelFormat::RGB24;
+  if (auto pixelFormatPtr = resources.get<RecordingPixelFormat>("recorderPixelFormat"); pixelFormatPtr) {
+    recorderPixelFormat = *pixelFormatPtr;
+  }
+
+  RecordingBackpressurePolicy recorderBackpressurePolicy = RecordingBackpressurePolicy::Drop;
+  if (auto policyPtr = resources.get<RecordingBackpressurePolicy>("recorderBackpressurePolicy"); policyPtr) {
+    recorderBackpressurePolicy = *policyPtr;
+  }
 
   videoRecorderPtr = std::make_unique<VideoRecorder>();
   videoRecorderPtr->setup(
       *resources.getRequired<glm::vec2>("recorderCompositeSize"),
-      ffmpegPath);
+      ffmpegPath, recorderPboCount, recorderPixelFormat);
+  videoRecorderPtr->setBackpressurePolicy(recorderBackpressurePolicy);
 
   if (videoStreamPtr && videoStreamPtr->isAllocated()) {
     rawVideoRecorderPtr = std::make_unique<VideoRecorder>();
-    rawVideoRecorderPtr->setup(videoStreamPtr->getSize(), ffmpegPath);
+    rawVideoRecorderPtr->setup(videoStreamPtr->getSize(), ffmpegPath, recorderPboCount, recorderPixelFormat);
+    rawVideoRecorderPtr->setBackpressurePolicy(recorderBackpressurePolicy);
   }
 #endif
 }
@@ -314,7 +353,7 @@ void Synth::maybeStartRecordingOnFirstWake() {
     return;
   }
 
-#ifdef TARGET_MAC
+#ifdef OFXMARKSYNTH_VIDEO_RECORDING
   if (videoRecorderPtr && videoRecorderPtr->isRecording()) {
     startRecordingOnFirstWakeStarted = true;
     return;
@@ -326,7 +365,7 @@ void Synth::maybeStartRecordingOnFirstWake() {
   startRecordingOnFirstWakeStarted = true;
 }
 
-#ifdef TARGET_MAC
+#ifdef OFXMARKSYNTH_VIDEO_RECORDING
 void Synth::startRecordingTake() {
   if (!videoRecorderPtr) {
     ofLogError("Synth") << "startRecordingTake: composite recorder not setup";
@@ -353,11 +392,14 @@ void Synth::startRecordingTake() {
 
   if (rawVideoRecorderPtr) {
     rawVideoRecorderPtr->startRecording(lastRecordingRawVideoPath.string());
+    lastRecordingRawVideoPath = rawVideoRecorderPtr->getOutputPath();
   } else {
     ofLogWarning("Synth") << "startRecordingTake: raw video recorder not setup";
   }
 
   videoRecorderPtr->startRecording(lastRecordingVideoPath.string());
+  // The recorder may change the container (e.g. .y4m when the Linux backend has no ffmpeg)
+  lastRecordingVideoPath = videoRecorderPtr->getOutputPath();
 }
 
 void Synth::muxLastRecordingIfAvailable() {
@@ -391,9 +433,11 @@ void Synth::stopRecordingTakeAndMux() {
   // Stop raw video first so any last-frame work happens while composite is still intact.
   if (rawVideoRecorderPtr && rawVideoRecorderPtr->isRecording()) {
     rawVideoRecorderPtr->stopRecording();
+    rawVideoRecorderPtr->getStats().writeSidecar(getRecordingStatsPath(lastRecordingRawVideoPath), lastRecordingRawVideoPath);
   }
 
   videoRecorderPtr->stopRecording();
+  videoRecorderPtr->getStats().writeSidecar(getRecordingStatsPath(lastRecordingVideoPath), lastRecordingVideoPath);
 
   if (audioAnalysisClientPtr) {
     audioAnalysisClientPtr->stopSegmentRecording();
@@ -405,6 +449,13 @@ void Synth::stopRecordingTakeAndMux() {
 }
 #endif
 
+void Synth::captureConfigThumbnail() {
+  if (!configThumbnailSaver || !compositeRenderer || currentConfigPath.empty()) return;
+  if (getConfigRunningTime() < CONFIG_THUMBNAIL_MIN_RUNNING_SECS) return;
+
+  configThumbnailSaver->capture(*compositeRenderer, displayController->getSettings(), currentConfigPath);
+}
+
 void Synth::initResourcePaths() {
   if (resources.has("performanceArtefactRootPath")) {
     auto p = resources.get<std::filesystem::path>("performanceArtefactRootPath");
@@ -469,8 +520,30 @@ void Synth::initSinkSourceMappings() {
     { "Memory", SOURCE_MEMORY }
   };
   
+  glm::vec2 memorySlotSize { 1024, 1024 };
+  int memorySlotCount = MemoryBank::DEFAULT_SLOT_COUNT;
+  if (auto sizePtr = resources.get<glm::vec2>("memoryBankSlotSize"); sizePtr) {
+    memorySlotSize = *sizePtr;
+  }
+  if (auto countPtr = resources.get<int>("memoryBankSlotCount"); countPtr) {
+    memorySlotCount = *countPtr;
+  }
   memoryBankController = std::make_unique<MemoryBankController>();
-  memoryBankController->allocate({ 1024, 1024 });
+  memoryBankController->allocate(memorySlotSize, memorySlotCount);
+  memoryBankController->setEncodeWorkerPool(encodeWorkerPool.get());
+  if (artefactRootPathSet) {
+    int archiveRamMB = 256;
+    int archiveMaxDiskEntries = 4000;
+    if (auto ramPtr = resources.get<int>("memoryArchiveRamMB"); ramPtr) {
+      archiveRamMB = *ramPtr;
+    }
+    if (auto diskPtr = resources.get<int>("memoryArchiveMaxDiskEntries"); diskPtr) {
+      archiveMaxDiskEntries = *diskPtr;
+    }
+    memoryBankController->setupArchive(artefactRootPath / "memory-archive",
+                                       static_cast<size_t>(archiveRamMB) * 1024 * 1024,
+                                       archiveMaxDiskEntries);
+  }
   
   sinkNameIdMap = {
     { backgroundColorParameter.getName(), SINK_BACKGROUND_COLOR },
@@ -478,9 +551,22 @@ void Synth::initSinkSourceMappings() {
     { "AgencyAuto", SINK_AGENCY_AUTO }
   };
   
-  for (const auto& [name, id] : memoryBankController->getSinkNameIdMap()) {
+  const auto memorySinkNameIdMap = memoryBankController->getSinkNameIdMap();
+  for (const auto& [name, id] : memorySinkNameIdMap) {
     sinkNameIdMap[name] = id;
   }
+
+  // Float events (audio onsets in particular) arrive at a high rate, so route them by table lookup
+  int maxSinkId = std::max(SINK_AGENCY_AUTO, SINK_RESET_RANDOMNESS);
+  for (const auto& [name, id] : memorySinkNameIdMap) {
+    maxSinkId = std::max(maxSinkId, id);
+  }
+  floatSinkRoutes.assign(maxSinkId + 1, FloatSinkRoute::Unknown);
+  floatSinkRoutes[SINK_AGENCY_AUTO] = FloatSinkRoute::AgencyAuto;
+  floatSinkRoutes[SINK_RESET_RANDOMNESS] = FloatSinkRoute::ResetRandomness;
+  for (const auto& [name, id] : memorySinkNameIdMap) {
+    floatSinkRoutes[id] = FloatSinkRoute::MemoryBank;
+  }
 }
 
 // TODO: fold this into loadFromConfig and the ctor?
@@ -534,7 +620,7 @@ void Synth::shutdown() {
   
   gui.exit();
   
-#ifdef TARGET_MAC
+#ifdef OFXMARKSYNTH_VIDEO_RECORDING
   if (videoRecorderPtr && videoRecorderPtr->isRecording()) {
     stopRecordingTakeAndMux();
   }
@@ -550,9 +636,24 @@ void Synth::shutdown() {
     audioAnalysisClientPtr->closeStream();
   }
 
+  // Only a requested still is worth finishing; other deferred GL jobs are dropped with the app
+  deferredTasks.flush("imageSave");
+  if (compositeRenderer) {
+    compositeRenderer->finishTiledStill();
+  }
+
   if (imageSaver) {
     imageSaver->flush();
   }
+
+  if (configThumbnailSaver) {
+    captureConfigThumbnail();
+    configThumbnailSaver->flush();
+  }
+
+  if (memoryBankController) {
+    memoryBankController->flushSaveAll();
+  }
 }
 
 void Synth::unload() {
@@ -583,6 +684,10 @@ void Synth::unload() {
   // 6) Clear performer cues
   performerCues = {};
 
+  // 7) Drop deferred captures of this config's composite, so they can't land in the next config
+  deferredTasks.cancel("autoSnapshot");
+  deferredTasks.cancel("memoryAutoCapture");
+
   // Note: Keep displayController, compositeRenderer, and other helper classes
   // Rebuild of parameter groups happens when reloading config (configureGui/init* called then)
 }
@@ -711,35 +816,34 @@ void Synth::receive(int sinkId, const glm::vec4& v) {
 }
 
 void Synth::receive(int sinkId, const float& v) {
-  switch (sinkId) {
-    case SINK_AGENCY_AUTO:
+  const FloatSinkRoute route = (sinkId >= 0 && sinkId < static_cast<int>(floatSinkRoutes.size()))
+      ? floatSinkRoutes[sinkId] : FloatSinkRoute::Unknown;
+
+  switch (route) {
+    case FloatSinkRoute::AgencyAuto:
       autoAgencyAggregateThisFrame = std::max(autoAgencyAggregateThisFrame, std::clamp(v, 0.0f, 1.0f));
       break;
 
-    case SINK_RESET_RANDOMNESS:
+    case FloatSinkRoute::ResetRandomness:
       {
         // Use bucketed onset value as seed for repeatability
         int seed = static_cast<int>(v * 10.0f); // Adjust multiplier for desired granularity
         of::random::seed(seed);
       }
       break;
-      
-    default:
-      // Try memory bank controller
+
+    case FloatSinkRoute::MemoryBank:
       {
         auto result = memoryBankController->handleSink(sinkId, v, compositeRenderer->getCompositeFbo(), getAgency());
         if (result.shouldEmit && result.texture) {
           emit(SOURCE_MEMORY, *result.texture);
-          return;
-        }
-        // If handleSink returned a non-emit result (save/param update), it was handled
-        // Check if it was a known memory sink by checking all sink IDs
-        auto sinkMap = memoryBankController->getSinkNameIdMap();
-        for (const auto& [name, id] : sinkMap) {
-          if (id == sinkId) return; // Was a memory sink, handled
         }
       }
+      break;
+
+    case FloatSinkRoute::Unknown:
       ofLogError("Synth") << "Float receive for unknown sinkId " << sinkId;
+      break;
   }
 }
 
@@ -749,12 +853,14 @@ void Synth::applyIntent(const Intent& intent, float intentStrength) {
 }
 
 void Synth::update() {
+  deferredTasks.beginFrame();
+
   // Aggregate max auto agency from any .AgencyAuto connections.
   // This intentionally affects `getAgency()` on the next frame to avoid reliance on Mod update ordering.
   autoAgencyAggregateThisFrame = 0.0f;
 
   pauseStatus = paused ? "Yes" : "No";
-#ifdef TARGET_MAC
+#ifdef OFXMARKSYNTH_VIDEO_RECORDING
   recorderStatus = (videoRecorderPtr && videoRecorderPtr->isRecording()) ? "Yes" : "No";
 #else
   recorderStatus = "No";
@@ -765,11 +871,23 @@ void Synth::update() {
   ParamControllerSettings::instance().manualBiasDecaySec = manualBiasDecaySecParameter;
   ParamControllerSettings::instance().baseManualBias = baseManualBiasParameter;
   
-  // Update performance navigator hold state
+  // Update performance navigator hold state (and pick up any thumbnails written since last frame)
+  configThumbnailSaver->update();
+  for (const auto& thumbnailPath : configThumbnailSaver->takeWrittenPaths()) {
+    performanceNavigator.reloadThumbnail(thumbnailPath);
+  }
   performanceNavigator.update();
+  if (performanceNavigator.hasDecodedThumbnails()) {
+    deferredTasks.defer("thumbnailUpload", DEFER_THUMBNAIL_UPLOAD_MAX_SECS, [this] {
+      performanceNavigator.uploadDecodedThumbnail();
+    });
+  }
   
   // Update hibernation fade even when paused
   hibernationController->update();
+
+  updateDeepIdle();
+  if (deepIdle) return;
   
   // Update crossfade transition
   configTransitionManager->update();
@@ -781,6 +899,12 @@ void Synth::update() {
   
   // Update per-layer pause envelopes
   layerController->updatePauseStates();
+
+  // Zero-alpha layers are skipped by the Mods drawing on them, unless another Mod reads them
+  layerController->updateVisibility();
+  for (const auto& [name, modPtr] : modPtrs) {
+    modPtr->markReadLayersVisible();
+  }
   
   // Sync paused state with hibernation:
   // - HIBERNATED: paused = true (fully asleep, nothing updates)
@@ -823,14 +947,24 @@ void Synth::update() {
     
     layerController->clearActiveLayers(DEFAULT_CLEAR_COLOR);
     
-    std::for_each(modPtrs.cbegin(), modPtrs.cend(), [](const auto& pair) {
-      const auto& [name, modPtr] = pair;
+    // Slots follow modPtrs iteration order, as assigned by modTelemetry.setMods() on config load.
+    const bool telemetryEnabled = modTelemetry.isEnabled();
+    if (telemetryEnabled) modTelemetry.beginFrame();
+    int modSlot = 0;
+    for (const auto& [name, modPtr] : modPtrs) {
       TSGL_START(name);
       TS_START(name);
+      if (telemetryEnabled) {
+        modPtr->takeEmitCount();
+        modTelemetry.beginMod(modSlot);
+      }
       modPtr->update();
+      if (telemetryEnabled) modTelemetry.endMod(modSlot, modPtr->takeEmitCount());
       TS_STOP(name);
       TSGL_STOP(name);
-    });
+      modSlot++;
+    }
+    if (telemetryEnabled) modTelemetry.endFrame();
 
     // Latch "register shift" events from any AgencyController.
     // This is used only for GUI signaling.
@@ -881,26 +1015,56 @@ void Synth::update() {
   compositeRenderer->updateCompositeOverlays(compositeParams);
   
   // Update side panels
-  compositeRenderer->updateSidePanels();
+  if (compositeRenderer->isSidePanelUpdateDue()) {
+    deferredTasks.defer("sidePanels", DEFER_SIDE_PANEL_MAX_SECS, [this] {
+      compositeRenderer->updateSidePanels();
+    });
+  }
   
   TS_STOP("Synth-updateComposites");
   TSGL_STOP("Synth-updateComposites");
   
-  // Process deferred manual image save immediately after composite is ready.
-  // This timing ensures PBO bind happens while GPU is still working on this frame's data.
-  // If the saver is busy, keep the manual request pending and retry next frame.
+  // Process deferred manual image save on a frame with headroom, once the composite is ready.
+  // The saver queues behind in-flight saves; only under backpressure keep the request pending and retry next frame.
   if (pendingImageSave) {
-    bool accepted = imageSaver->requestSave(compositeRenderer->getCompositeFbo(), pendingImageSavePath);
-    if (accepted) {
-      pendingImageSave = false;
-      pendingImageSavePath.clear();
+    deferredTasks.defer("imageSave", DEFER_IMAGE_SAVE_MAX_SECS, [this] {
+      if (!pendingImageSave) return;
+      bool accepted = imageSaver->requestSave(compositeRenderer->getCompositeFbo(), pendingImageSavePath);
+      if (accepted) {
+        pendingImageSave = false;
+        pendingImageSavePath.clear();
+      }
+    });
+  }
+
+  // Oversize tonemapped still, re-rendered from the layer FBOs one tile per frame with headroom.
+  // A request made while one is in progress waits for it.
+  if (pendingTiledImageSave && !compositeRenderer->isTiledStillActive()) {
+    pendingTiledImageSave = false;
+    int tiledStillScale = DEFAULT_TILED_STILL_SCALE;
+    if (auto scalePtr = resources.get<int>("tiledStillScale"); scalePtr) {
+      tiledStillScale = *scalePtr;
     }
+    compositeRenderer->beginTiledStill(compositeParams,
+                                       displayController->getSettings(),
+                                       tiledStillScale,
+                                       pendingTiledImageSavePath,
+                                       *encodeWorkerPool);
+    pendingTiledImageSavePath.clear();
+  }
+  compositeRenderer->updateTiledStill();
+  if (compositeRenderer->isTiledStillTileReady()) {
+    deferredTasks.defer("tiledStillTile", DEFER_TILED_STILL_TILE_MAX_SECS, [this] {
+      TS_START("Synth-tiledStillTile");
+      compositeRenderer->renderTiledStillTile();
+      TS_STOP("Synth-tiledStillTile");
+    });
   }
 
   // Auto-save full-res HDR composite snapshots (pre-tonemap, EXR).
   // Guards:
   // - Never during pause/hibernation
-  // - No overlap: only when saver is fully idle
+  // - Only when the saver has a free PBO (autosaves never queue)
   bool autoSnapshotsEnabled = false;
   float autoSnapshotsIntervalSec = 20.0f;
   float autoSnapshotsJitterSec = 7.0f;
@@ -919,68 +1083,152 @@ void Synth::update() {
       !currentConfigPath.empty() &&
       hibernationController && !hibernationController->isHibernating() &&
       imageSaver &&
-      !pendingImageSave) {
+      !pendingImageSave &&
+      imageSaver->isAutoSaveDue(getClockTimeSinceFirstRun(), autoSnapshotsIntervalSec, autoSnapshotsJitterSec)) {
 
     const std::string configId = getCurrentConfigId();
     if (!configId.empty()) {
-      imageSaver->requestAutoSaveIfDue(
-          compositeRenderer->getCompositeFbo(),
-          getClockTimeSinceFirstRun(),
-          autoSnapshotsIntervalSec,
-          autoSnapshotsJitterSec,
-          [configId]() {
-            std::string timestamp = ofGetTimestampString();
-            return Synth::saveArtefactFilePath(
-                AUTO_SNAPSHOTS_FOLDER_NAME + "/" + configId + "/drawing-" + timestamp + ".exr");
-          });
+      deferredTasks.defer("autoSnapshot", DEFER_AUTO_SNAPSHOT_MAX_SECS,
+                          [this, configId, autoSnapshotsIntervalSec, autoSnapshotsJitterSec] {
+        imageSaver->requestAutoSaveIfDue(
+            compositeRenderer->getCompositeFbo(),
+            getClockTimeSinceFirstRun(),
+            autoSnapshotsIntervalSec,
+            autoSnapshotsJitterSec,
+            [configId]() {
+              std::string timestamp = ofGetTimestampString();
+              return Synth::saveArtefactFilePath(
+                  AUTO_SNAPSHOTS_FOLDER_NAME + "/" + configId + "/drawing-" + timestamp + ".exr");
+            });
+      });
     }
   }
 
-  // Update memory bank controller (process pending saves, auto-capture, save-all requests)
+  // Update memory bank controller (process pending saves, save-all requests)
   memoryBankController->update(compositeRenderer->getCompositeFbo(),
                                configRootPathSet ? configRootPath : std::filesystem::path{},
                                getSynthRunningTime());
+  if (memoryBankController->isAutoCaptureDue(getSynthRunningTime())) {
+    deferredTasks.defer("memoryAutoCapture", DEFER_MEMORY_AUTO_CAPTURE_MAX_SECS, [this] {
+      memoryBankController->updateAutoCapture(compositeRenderer->getCompositeFbo(), getSynthRunningTime());
+    });
+  }
   
   if (!paused) {
     emit(Synth::SOURCE_COMPOSITE_FBO, compositeRenderer->getCompositeFbo());
   }
 }
 
+void Synth::updateDeepIdle() {
+  const bool shouldIdle = deepIdleFrameRate > 0.0f
+      && hibernationController->isFullyHibernated()
+      && !isRecording();
+  if (shouldIdle == deepIdle) return;
+
+  deepIdle = shouldIdle;
+  if (deepIdle) {
+    paused = true;  // As when fully hibernated; waking unpauses
+    // ofGetTargetFrameRate() can't tell an uncapped loop from a capped one, so the loop is only
+    // capped when the rate to restore is known
+    if (sessionFrameRate) {
+      ofSetFrameRate(deepIdleFrameRate);
+      ofLogNotice("Synth") << "Deep idle: loop capped at " << deepIdleFrameRate << " fps until wake";
+    } else {
+      ofLogNotice("Synth") << "Deep idle: no frameRate resource, so the loop rate is left alone";
+    }
+  } else if (sessionFrameRate) {
+    ofSetFrameRate(*sessionFrameRate);  // 0 restores an uncapped loop
+    ofLogNotice("Synth") << "Leaving deep idle: loop back to " << *sessionFrameRate << " fps";
+  }
+}
+
+// Returns false if the GPU memory budget refuses the (optional) debug view.
+static bool allocateDebugViewFbo(ofFbo& fbo, float size, GpuMemoryRegistry::Registration& memory, const std::string& label) {
+  if (fbo.isAllocated()) return true;
+  auto& registry = GpuMemoryRegistry::instance();
+  if (registry.admit("Synth", label, GpuMemoryRegistry::estimateBytes(size, size, GL_RGBA), false) < 1.0f) return false;
+
+  ofFboSettings settings;
+  settings.width = size;
+  settings.height = size;
+  settings.internalformat = GL_RGBA;
+  settings.useDepth = false;
+  settings.useStencil = false;
+  fbo.allocate(settings);
+  memory = registry.addFbo("Synth", label, fbo);
+  return true;
+}
+
+static void drawModDebugView(const ModPtr& modPtr, float size) {
+  // Draw Mod debug overlays in [0,1] normalized coordinates
+  ofPushMatrix();
+  ofPushStyle();
+  ofScale(size, size);
+  modPtr->draw();
+  ofPopStyle();
+  ofPopMatrix();
+}
+
+void Synth::setDebugViewRoundRobin(bool enabled) {
+  if (debugViewRoundRobin == enabled) return;
+  debugViewRoundRobin = enabled;
+  debugViewRoundRobinIndex = 0;
+}
+
 void Synth::updateDebugViewFbo() {
   if (!debugViewEnabled) return;
   if (debugViewMode != DebugViewMode::Fbo) return;
 
-  // Allocate FBO if needed
-  if (!debugViewFbo.isAllocated()) {
-    ofFboSettings settings;
-    settings.width = DEBUG_VIEW_SIZE;
-    settings.height = DEBUG_VIEW_SIZE;
-    settings.internalformat = GL_RGBA;
-    settings.useDepth = false;
-    settings.useStencil = false;
-    debugViewFbo.allocate(settings);
-  }
+  // Skip entirely unless the Gui is showing the FBO (window open, not collapsed, FBO tab selected).
+  if (!guiVisible) return;
+  if (static_cast<int64_t>(ofGetFrameNum()) - debugViewLastShownFrame > DEBUG_VIEW_SHOWN_GRACE_FRAMES) return;
 
-  debugViewFbo.begin();
-  ofClear(20, 20, 20, 255);
+  const float now = ofGetElapsedTimef();
+  const bool hasRendered = debugViewFbo.isAllocated() && debugViewLastRefreshTimeSec >= 0.0f;
+  if (hasRendered && debugViewRefreshHz > 0.0f && now - debugViewLastRefreshTimeSec < 1.0f / debugViewRefreshHz) return;
+  debugViewLastRefreshTimeSec = now;
 
-  // Draw Mod debug overlays in [0,1] normalized coordinates
-  ofPushMatrix();
-  ofPushStyle();
-  ofScale(DEBUG_VIEW_SIZE, DEBUG_VIEW_SIZE);
-  for (const auto& [name, modPtr] : modPtrs) {
-    if (modPtr) {
-      modPtr->draw();
+  if (!allocateDebugViewFbo(debugViewFbo, DEBUG_VIEW_SIZE, debugViewMemory, "debug view")) return;
+
+  if (!debugViewRoundRobin) {
+    debugViewFbo.begin();
+    ofClear(20, 20, 20, 255);
+    for (const auto& [name, modPtr] : modPtrs) {
+      if (modPtr) drawModDebugView(modPtr, DEBUG_VIEW_SIZE);
     }
+    debugViewFbo.end();
+    return;
   }
-  ofPopStyle();
-  ofPopMatrix();
 
-  debugViewFbo.end();
+  // Round-robin: accumulate one Mod per refresh into the back FBO, publish when the cycle completes.
+  if (!allocateDebugViewFbo(debugViewBackFbo, DEBUG_VIEW_SIZE, debugViewBackMemory, "debug view (back)")) return;
+  if (debugViewRoundRobinIndex >= modPtrs.size()) debugViewRoundRobinIndex = 0; // Mods changed (config reload)
+
+  debugViewBackFbo.begin();
+  if (debugViewRoundRobinIndex == 0) ofClear(20, 20, 20, 255);
+  if (!modPtrs.empty()) {
+    const auto& modPtr = std::next(modPtrs.cbegin(), debugViewRoundRobinIndex)->second;
+    if (modPtr) drawModDebugView(modPtr, DEBUG_VIEW_SIZE);
+  }
+  debugViewBackFbo.end();
+
+  debugViewRoundRobinIndex++;
+  if (debugViewRoundRobinIndex >= modPtrs.size()) {
+    debugViewRoundRobinIndex = 0;
+    std::swap(debugViewFbo, debugViewBackFbo);
+  }
 }
 
 // Does not draw the GUI: see drawGui()
 void Synth::draw() {
+  if (deepIdle) {
+    // The composite is fully faded out; skip rendering it (and any recorder readback).
+    ofClear(0, 0, 0, 255);
+    deferredTasks.run(ofGetTargetFrameRate());
+    imageSaver->update();
+    return;
+  }
+
   TSGL_START("Synth::draw");
   compositeRenderer->draw(ofGetWindowWidth(), ofGetWindowHeight(),
                           displayController->getSettings(),
@@ -1009,7 +1257,7 @@ void Synth::draw() {
   updateDebugViewFbo();  // Render Mod debug draws to FBO for ImGui display
   TSGL_STOP("Synth::draw");
 
-#ifdef TARGET_MAC
+#ifdef OFXMARKSYNTH_VIDEO_RECORDING
   // Capture frames for recording.
   // Audio segment recording continues regardless of pause; to keep sync we also capture video regardless of pause.
   const bool shouldCaptureComposite = videoRecorderPtr && videoRecorderPtr->isRecording();
@@ -1030,7 +1278,9 @@ void Synth::draw() {
     TS_STOP("Synth::draw captureRawVideoFrame");
   }
 #endif
-  
+
+  // Composite and recorder readback are queued: spend what is left of the frame on deferred jobs
+  deferredTasks.run(ofGetTargetFrameRate());
   imageSaver->update();
 }
 
@@ -1052,7 +1302,7 @@ void Synth::windowResized(int w, int h) {
 }
 
 bool Synth::isRecording() const {
-#ifdef TARGET_MAC
+#ifdef OFXMARKSYNTH_VIDEO_RECORDING
   return videoRecorderPtr && videoRecorderPtr->isRecording();
 #else
   return false;
@@ -1072,7 +1322,7 @@ std::string Synth::getCurrentConfigId() const {
 }
 
 void Synth::toggleRecording() {
-#ifdef TARGET_MAC
+#ifdef OFXMARKSYNTH_VIDEO_RECORDING
   if (!videoRecorderPtr) return;
 
   if (videoRecorderPtr->isRecording()) {
@@ -1099,6 +1349,33 @@ void Synth::saveImage() {
   pendingImageSave = true;
 }
 
+void Synth::saveTiledImage() {
+  const std::string configId = getCurrentConfigId();
+  if (configId.empty()) {
+    ofLogError("Synth") << "saveTiledImage: no config loaded";
+    return;
+  }
+
+  std::string timestamp = ofGetTimestampString();
+  pendingTiledImageSavePath = Synth::saveArtefactFilePath(
+      SNAPSHOTS_FOLDER_NAME + "/" + configId + "/drawing-" + timestamp + "-large.ppm");
+  pendingTiledImageSave = true;
+}
+
+bool Synth::exportTelemetry() {
+  if (modTelemetry.getFrameCount() == 0) {
+    ofLogWarning("Synth") << "exportTelemetry: no telemetry frames recorded";
+    return false;
+  }
+
+  const std::string timestamp = ofGetTimestampString();
+  const std::filesystem::path csvPath = Synth::saveArtefactFilePath(TELEMETRY_FOLDER_NAME + "/telemetry-" + timestamp + ".csv");
+  const std::filesystem::path jsonPath = Synth::saveArtefactFilePath(TELEMETRY_FOLDER_NAME + "/telemetry-" + timestamp + ".json");
+  bool csvOk = modTelemetry.exportCsv(csvPath);
+  bool jsonOk = modTelemetry.exportJson(jsonPath);
+  return csvOk && jsonOk;
+}
+
 void Synth::requestSaveAllMemories() {
   memoryBankController->requestSaveAll();
 }
@@ -1158,6 +1435,11 @@ bool Synth::keyPressed(int key) {
     return true;
   }
 
+  if (key == 'L') {
+    saveTiledImage();
+    return true;
+  }
+
   if (key == 'R') {
     toggleRecording();
     return true;
@@ -1317,6 +1599,15 @@ bool Synth::loadFromConfig(const std::string& filepath) {
       modPtr->getParameterGroup();
     }
 
+    std::vector<std::pair<int, std::string>> telemetryMods;
+    telemetryMods.reserve(modPtrs.size());
+    for (const auto& [name, modPtr] : modPtrs) {
+      telemetryMods.emplace_back(modPtr->getId(), name);
+    }
+    modTelemetry.setMods(std::move(telemetryMods));
+
+    GpuMemoryRegistry::instance().logSummary();
+
     // Load global memories once (on first config load)
     if (configRootPathSet) {
       memoryBankController->loadGlobalMemories(configRootPath);
@@ -1444,6 +1735,8 @@ void Synth::updateModConfigJson(nlohmann::ordered_json& modJson, const ModPtr& m
 }
 
 void Synth::switchToConfig(const std::string& filepath, bool useCrossfade) {
+  captureConfigThumbnail();
+
   // Capture snapshot before unload (if crossfading)
   if (useCrossfade) {
     configTransitionManager->captureSnapshot(compositeRenderer->getCompositeFbo());
@@ -37,7 +37,11 @@
 #include "controller/LayerController.hpp"
 #include "controller/DisplayController.hpp"
 #include "controller/CueGlyphController.hpp"
+#include "controller/ModTelemetry.hpp"
+#include "controller/DeferredTaskScheduler.hpp"
 #include "rendering/CompositeRenderer.hpp"
+#include "rendering/ConfigThumbnailSaver.hpp"
+#include "rendering/GpuMemoryRegistry.hpp"
 
 namespace ofxAudioAnalysisClient {
 class LocalGistClient;
@@ -183,6 +187,7 @@ public:
   const std::string& getCurrentConfigPath() const { return currentConfigPath; }
   std::string getCurrentConfigId() const;
   void saveImage();
+  void saveTiledImage();
   void requestSaveAllMemories();
   int getActiveSaveCount() const;
   bool keyPressed(int key) override;
@@ -203,6 +208,8 @@ public:
 
   ofEvent<HibernationController::CompleteEvent>& getHibernationCompleteEvent();
   HibernationController::State getHibernationState() const;
+  /// True while fully hibernated with per-frame work skipped (see deepIdleFrameRate)
+  bool isDeepIdle() const { return deepIdle; }
 
   class ConfigUnloadEvent : public ofEventArgs {
   public:
@@ -254,7 +261,10 @@ private:
 
   void maybeStartRecordingOnFirstWake();
 
-#ifdef TARGET_MAC
+  /// Thumbnail the current config for the performance navigator (skipped if it has barely run)
+  void captureConfigThumbnail();
+
+#ifdef OFXMARKSYNTH_VIDEO_RECORDING
   void startRecordingTake();
   void stopRecordingTakeAndMux();
   void muxLastRecordingIfAvailable();
@@ -304,19 +314,44 @@ private:
 
   void updateDebugViewFbo();
   
-  // Debug view system - renders Mod::draw() calls to FBO for ImGui display
+  // Debug view system - renders Mod::draw() calls to FBO for ImGui display.
+  // Rendering only happens while the Gui is actually showing the FBO tab, throttled to
+  // debugViewRefreshHz. In round-robin mode one Mod is drawn per refresh into a back FBO,
+  // which is swapped to the front once every Mod has been drawn.
   ofFbo debugViewFbo;
+  ofFbo debugViewBackFbo;
+  GpuMemoryRegistry::Registration debugViewMemory;
+  GpuMemoryRegistry::Registration debugViewBackMemory;
   bool debugViewEnabled { false };
   DebugViewMode debugViewMode { DebugViewMode::Fbo };
   static constexpr float DEBUG_VIEW_SIZE { 640.0f };
+  float debugViewRefreshHz { 5.0f };                  // <= 0: refresh every frame
+  bool debugViewRoundRobin { false };
+  float debugViewLastRefreshTimeSec { -1.0f };
+  size_t debugViewRoundRobinIndex { 0 };
+  int64_t debugViewLastShownFrame { -1 };             // Last frame the Gui showed the FBO tab
+  static constexpr int64_t DEBUG_VIEW_SHOWN_GRACE_FRAMES { 2 }; // Gui may draw before or after Synth::draw
   
 public:
   const ofFbo& getDebugViewFbo() const { return debugViewFbo; }
   bool isDebugViewEnabled() const { return debugViewEnabled; }
   void setDebugViewEnabled(bool enabled) { debugViewEnabled = enabled; }
   void toggleDebugView() { debugViewEnabled = !debugViewEnabled; }
-  
+  void markDebugViewShown() { debugViewLastShownFrame = static_cast<int64_t>(ofGetFrameNum()); }
+  float getDebugViewRefreshHz() const { return debugViewRefreshHz; }
+  void setDebugViewRefreshHz(float hz) { debugViewRefreshHz = std::max(0.0f, hz); }
+  bool isDebugViewRoundRobin() const { return debugViewRoundRobin; }
+  void setDebugViewRoundRobin(bool enabled);
+
+  // Per-Mod update telemetry (disabled by default; see ModTelemetry)
+  ModTelemetry& getModTelemetry() { return modTelemetry; }
+  bool exportTelemetry();
+
 private:
+  ModTelemetry modTelemetry;
+
+  // Occasional GL jobs, run on frames with headroom (or at their deadline)
+  DeferredTaskScheduler deferredTasks;
 
   // >>> Config transition crossfade system (delegated to helper class)
   std::unique_ptr<ConfigTransitionManager> configTransitionManager;
@@ -368,7 +403,7 @@ private:
   // Synth-owned persistent video stream (camera OR file playback).
   std::shared_ptr<VideoStream> videoStreamPtr;
 
-#ifdef TARGET_MAC
+#ifdef OFXMARKSYNTH_VIDEO_RECORDING
   // Recording (segmented): composite + raw video + raw audio (segment WAV).
   std::unique_ptr<VideoRecorder> videoRecorderPtr;     // Composite (audience experience)
   std::unique_ptr<VideoRecorder> rawVideoRecorderPtr;  // Raw video stream
@@ -382,15 +417,34 @@ private:
   bool startRecordingOnFirstWakeEnabled { false };
   bool startRecordingOnFirstWakeStarted { false };
 
+  // Shared low-priority encode/I/O threads; declared before its users so it's destroyed after them
+  std::unique_ptr<EncodeWorkerPool> encodeWorkerPool;
   std::unique_ptr<AsyncImageSaver> imageSaver;
+  std::unique_ptr<ConfigThumbnailSaver> configThumbnailSaver;
   
   // Deferred image save: flag set in keyPressed, processed after composite update
   bool pendingImageSave { false };
   std::string pendingImageSavePath;
+  bool pendingTiledImageSave { false };
+  std::string pendingTiledImageSavePath;
 
   // >>> Memory bank system (delegated to helper class)
   std::unique_ptr<MemoryBankController> memoryBankController;
   // <<<
+
+  // Deep idle: while fully hibernated nothing is visible, so update() and draw() skip Mods, composites,
+  // memory capture and recording readbacks, and the loop is capped at deepIdleFrameRate (<= 0 disables).
+  // Not entered while recording, which needs a frame per loop to stay in step with the audio.
+  // Waking restores sessionFrameRate (the "frameRate" resource, 0 = uncapped); without it the
+  // loop isn't capped.
+  float deepIdleFrameRate { 5.0f };
+  bool deepIdle { false };
+  std::optional<float> sessionFrameRate;
+  void updateDeepIdle();
+
+  // Float sink dispatch, indexed by sinkId (built in initSinkSourceMappings)
+  enum class FloatSinkRoute : uint8_t { Unknown, AgencyAuto, ResetRandomness, MemoryBank };
+  std::vector<FloatSinkRoute> floatSinkRoutes;
 };
 
 template <typename ModT>
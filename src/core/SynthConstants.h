@@ -24,4 +24,12 @@ constexpr float NORMALIZATION_EPSILON = 1e-6f;
 // Intent system
 constexpr int MAX_INTENT_SLOTS = 7;
 
+// Deferred GL work (see DeferredTaskScheduler): the longest each job waits for a frame with headroom
+constexpr float DEFER_IMAGE_SAVE_MAX_SECS = 0.25f;
+constexpr float DEFER_AUTO_SNAPSHOT_MAX_SECS = 2.0f;
+constexpr float DEFER_MEMORY_AUTO_CAPTURE_MAX_SECS = 0.5f;
+constexpr float DEFER_SIDE_PANEL_MAX_SECS = 1.0f;
+constexpr float DEFER_THUMBNAIL_UPLOAD_MAX_SECS = 0.5f;
+constexpr float DEFER_TILED_STILL_TILE_MAX_SECS = 0.25f;
+
 } // namespace ofxMarkSynth
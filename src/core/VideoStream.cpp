@@ -179,6 +179,7 @@ void VideoStream::allocateFbos(glm::vec2 size) {
 
   frameFbo_.allocate(s);
   frameFbo_.clear(0, 255);
+  frameMemory_ = GpuMemoryRegistry::instance().add("VideoStream", "frames", size_.x, size_.y, GL_RGB8, 2);
 }
 
 void VideoStream::drawTextureToCurrentFrame(const ofTexture& texture, bool mirrorX) {
@@ -14,6 +14,7 @@
 #include <string>
 
 #include "PingPongFbo.h"
+#include "rendering/GpuMemoryRegistry.hpp"
 #include "ofFbo.h"
 #include "ofVideoGrabber.h"
 #include "ofVideoPlayer.h"
@@ -67,6 +68,7 @@ private:
 
   glm::vec2 size_ { 0.0f, 0.0f };
   PingPongFbo frameFbo_;
+  GpuMemoryRegistry::Registration frameMemory_;
 
   bool frameNewThisUpdate_ { false };
   bool hasEverReceivedFrame_ { false };
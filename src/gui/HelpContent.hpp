@@ -16,6 +16,7 @@ H               Toggle hibernation (fade out)
 
 RECORDING & SAVING
 S               Save HDR image
+L               Save oversize still (tiled, tonemapped)
 R               Toggle video recording
 
 DEBUG
@@ -94,6 +94,13 @@ void FluidMod::initParameters() {
   registerControllerForSource(velocityDissipationParam, *velocityDissipationControllerPtr);
 }
 
+// The simulation advects the values layer using the velocities and obstacles layers; while its
+// velocities feed other Mods it has to keep running even if the values are not composited.
+bool FluidMod::readsNamedLayer(const std::string& layerName) const {
+  if (layerName == VELOCITIES_LAYERPTR_NAME || layerName == OBSTACLES_LAYERPTR_NAME) return true;
+  return connections.contains(SOURCE_VELOCITIES_TEXTURE);
+}
+
 void FluidMod::setup() {
   if (fluidSimulation.isSetup()) return;
 
@@ -113,6 +120,13 @@ void FluidMod::setup() {
   } else {
     fluidSimulation.setup(valuesDrawingLayerPtr.value()->fboPtr, velocitiesDrawingLayerPtr.value()->fboPtr);
   }
+
+  // The value/velocity/obstacle layers are accounted by LayerController. FluidSimulation doesn't expose
+  // its scratch buffers, so record an estimate: pressure (ping-pong), divergence and curl, single-channel
+  // float at velocity resolution.
+  const auto& velocitiesFbo = velocitiesDrawingLayerPtr.value()->fboPtr->getSource();
+  simulationMemory = GpuMemoryRegistry::instance().add("FluidMod " + getName(), "simulation buffers (estimate)",
+                                                       velocitiesFbo.getWidth(), velocitiesFbo.getHeight(), GL_R32F, 4);
 }
 
 void FluidMod::update() {
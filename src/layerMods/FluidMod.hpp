@@ -14,6 +14,7 @@
 #include "FluidSimulation.h"
 #include "ApplyVelocityFieldShader.h"
 #include "core/ParamController.h"
+#include "rendering/GpuMemoryRegistry.hpp"
 
 namespace ofxMarkSynth {
 
@@ -30,6 +31,7 @@ public:
   void receive(int sinkId, const glm::vec2& point) override;
   void receive(int sinkId, const ofTexture& texture) override;
   void applyIntent(const Intent& intent, float strength) override;
+  bool readsNamedLayer(const std::string& layerName) const override;
  
   static constexpr int SOURCE_VELOCITIES_TEXTURE = 10;
 
@@ -52,6 +54,7 @@ private:
   void applyVelocityFieldTexture();
 
   FluidSimulation fluidSimulation;
+  GpuMemoryRegistry::Registration simulationMemory;
   ApplyVelocityFieldShader applyVelocityFieldShader;
   bool applyVelocityFieldShaderLoaded { false };
   
@@ -55,6 +55,7 @@ const ofTexture& PixelSnapshotMod::createSnapshot(const ofFbo& sourceFbo) {
   int size = static_cast<int>(sizeController.value);
   if (static_cast<int>(snapshotFbo.getWidth()) != size || static_cast<int>(snapshotFbo.getHeight()) != size) {
     snapshotFbo.allocate(size, size, GL_RGBA8);
+    snapshotMemory = GpuMemoryRegistry::instance().addFbo("PixelSnapshotMod " + getName(), "snapshot", snapshotFbo);
   }
 
   int x = ofRandom(0, sourceFbo.getWidth() - snapshotFbo.getWidth());
@@ -9,6 +9,7 @@
 
 #include "core/Mod.hpp"
 #include "core/ParamController.h"
+#include "rendering/GpuMemoryRegistry.hpp"
 
 
 
@@ -25,6 +26,7 @@ public:
   void draw() override;
   bool keyPressed(int key) override;
   void applyIntent(const Intent& intent, float strength) override;
+  bool readsNamedLayer(const std::string& layerName) const override { (void)layerName; return true; }
 
   UiState captureUiState() const override {
     UiState state;
@@ -49,6 +51,7 @@ private:
   ofParameter<float> agencyFactorParameter { "AgencyFactor", 1.0, 0.0, 1.0 };
 
   ofFbo snapshotFbo; // Scratchpad FBO for GPU-based cropping operation
+  GpuMemoryRegistry::Registration snapshotMemory;
   const ofTexture& createSnapshot(const ofFbo& sourceFbo);
 
   bool visible = false;
@@ -5,6 +5,7 @@
 //
 
 #include "rendering/AsyncImageSaver.hpp"
+#include "rendering/FboCopy.hpp"
 #include "rendering/RenderingConstants.h"
 #include "ofGLUtils.h"
 #include "ofLog.h"
@@ -13,20 +14,102 @@
 #include <algorithm>
 #include <cstddef>
 #include <cstring>
+#include <memory>
 #include <new>
 
-#ifdef __APPLE__
-#include <pthread.h>
-#include <pthread/qos.h>
+#if defined(__ARM_NEON)
+#include <arm_neon.h>
+#elif defined(__x86_64__) || defined(__i386__)
+#include <tmmintrin.h>
 #endif
 
 namespace ofxMarkSynth {
 
-static bool saveHalfRgbExrUncompressed(std::unique_ptr<std::uint16_t[]>&& interleavedRgb,
-                                      std::size_t pixelCount,
-                                      int width,
-                                      int height,
-                                      const std::string& filepath) {
+#if defined(__x86_64__) || defined(__i386__)
+// pshufb masks that gather one channel from each of three 16-byte loads (8 interleaved RGB16 pixels).
+struct RgbDeinterleaveMasks {
+    alignas(16) std::int8_t bytes[3][3][16];  // [channel][source vector][byte]
+
+    RgbDeinterleaveMasks() {
+        for (int c = 0; c < 3; ++c) {
+            for (int k = 0; k < 3; ++k) {
+                for (int j = 0; j < 16; ++j) {
+                    const int element = 3 * (j / 2) + c;
+                    bytes[c][k][j] = (element / 8 == k) ? static_cast<std::int8_t>(2 * (element % 8) + j % 2) : -128;
+                }
+            }
+        }
+    }
+};
+
+__attribute__((target("ssse3")))
+static std::size_t deinterleaveRgb16Ssse3(const std::uint16_t* rgb, std::size_t pixelCount,
+                                          std::uint16_t* r, std::uint16_t* g, std::uint16_t* b) {
+    static const RgbDeinterleaveMasks masks;
+    std::uint16_t* planes[3] = { r, g, b };
+    __m128i m[3][3];
+    for (int c = 0; c < 3; ++c) {
+        for (int k = 0; k < 3; ++k) {
+            m[c][k] = _mm_load_si128(reinterpret_cast<const __m128i*>(masks.bytes[c][k]));
+        }
+    }
+
+    std::size_t i = 0;
+    for (; i + 8 <= pixelCount; i += 8) {
+        const __m128i* src = reinterpret_cast<const __m128i*>(rgb + 3 * i);
+        const __m128i v0 = _mm_loadu_si128(src);
+        const __m128i v1 = _mm_loadu_si128(src + 1);
+        const __m128i v2 = _mm_loadu_si128(src + 2);
+        for (int c = 0; c < 3; ++c) {
+            const __m128i out = _mm_or_si128(_mm_or_si128(_mm_shuffle_epi8(v0, m[c][0]), _mm_shuffle_epi8(v1, m[c][1])),
+                                             _mm_shuffle_epi8(v2, m[c][2]));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(planes[c] + i), out);
+        }
+    }
+    return i;
+}
+#endif
+
+// Split interleaved RGB half-floats into planes (NEON vld3 / SSSE3 shuffles, scalar tail).
+static void deinterleaveRgb16(const std::uint16_t* rgb, std::size_t pixelCount,
+                              std::uint16_t* r, std::uint16_t* g, std::uint16_t* b) {
+    std::size_t i = 0;
+#if defined(__ARM_NEON)
+    for (; i + 8 <= pixelCount; i += 8) {
+        const uint16x8x3_t px = vld3q_u16(rgb + 3 * i);
+        vst1q_u16(r + i, px.val[0]);
+        vst1q_u16(g + i, px.val[1]);
+        vst1q_u16(b + i, px.val[2]);
+    }
+#elif defined(__x86_64__) || defined(__i386__)
+    static const bool hasSsse3 = __builtin_cpu_supports("ssse3");
+    if (hasSsse3) {
+        i = deinterleaveRgb16Ssse3(rgb, pixelCount, r, g, b);
+    }
+#endif
+    for (; i < pixelCount; ++i) {
+        r[i] = rgb[3 * i + 0];
+        g[i] = rgb[3 * i + 1];
+        b[i] = rgb[3 * i + 2];
+    }
+}
+
+static int toTinyExrCompression(ExrCompression compression) {
+    switch (compression) {
+        case ExrCompression::None: return TINYEXR_COMPRESSIONTYPE_NONE;
+        case ExrCompression::Zips: return TINYEXR_COMPRESSIONTYPE_ZIPS;
+        case ExrCompression::Zip: return TINYEXR_COMPRESSIONTYPE_ZIP;
+        case ExrCompression::Piz: return TINYEXR_COMPRESSIONTYPE_PIZ;
+    }
+    return TINYEXR_COMPRESSIONTYPE_ZIP;
+}
+
+static bool saveHalfRgbExr(std::unique_ptr<std::uint16_t[]>&& interleavedRgb,
+                           std::size_t pixelCount,
+                           int width,
+                           int height,
+                           ExrCompression compression,
+                           const std::string& filepath) {
     if (width <= 0 || height <= 0) {
         return false;
     }
@@ -40,23 +123,21 @@ static bool saveHalfRgbExrUncompressed(std::unique_ptr<std::uint16_t[]>&& interl
     }
 
     // TinyEXR expects planar data and channels in (A)BGR order.
+    // The readback is already GL_HALF_FLOAT, so this is a pure 16-bit shuffle.
     std::vector<std::uint16_t> images[3];
     images[0].resize(pixelCount);  // B
     images[1].resize(pixelCount);  // G
     images[2].resize(pixelCount);  // R
 
-    for (std::size_t i = 0; i < pixelCount; ++i) {
-        images[2][i] = interleavedRgb[3 * i + 0];
-        images[1][i] = interleavedRgb[3 * i + 1];
-        images[0][i] = interleavedRgb[3 * i + 2];
-    }
+    deinterleaveRgb16(interleavedRgb.get(), pixelCount, images[2].data(), images[1].data(), images[0].data());
 
     // Release the (large) interleaved buffer early to reduce peak memory usage.
     interleavedRgb.reset();
 
     EXRHeader header;
     InitEXRHeader(&header);
-    header.compression_type = TINYEXR_COMPRESSIONTYPE_NONE;
+    // Compressed on this encode worker only; parallelism comes from the bounded worker pool.
+    header.compression_type = toTinyExrCompression(compression);
 
     header.num_channels = 3;
     header.channels = static_cast<EXRChannelInfo*>(malloc(sizeof(EXRChannelInfo) * 3));
@@ -119,9 +200,19 @@ static bool saveHalfRgbExrUncompressed(std::unique_ptr<std::uint16_t[]>&& interl
     return true;
 }
 
-AsyncImageSaver::AsyncImageSaver(glm::vec2 imageSize_)
-    : imageSize(imageSize_) {
-    pbo.allocate(getImageByteSize(), GL_STREAM_READ);
+AsyncImageSaver::AsyncImageSaver(glm::vec2 imageSize_, EncodeWorkerPool& encodePool_)
+    : imageSize(imageSize_),
+      pboSlots(IMAGE_SAVER_PBO_COUNT),
+      stagingFbos(IMAGE_SAVER_MAX_QUEUED_REQUESTS),
+      stagingInUse(IMAGE_SAVER_MAX_QUEUED_REQUESTS, false),
+      stagingMemory(IMAGE_SAVER_MAX_QUEUED_REQUESTS),
+      encodePool(encodePool_) {
+    for (auto& slot : pboSlots) {
+        slot.pbo.allocate(getImageByteSize(), GL_STREAM_READ);
+    }
+    pboMemory = GpuMemoryRegistry::instance().add("AsyncImageSaver", "pbo ring",
+                                                  static_cast<int>(imageSize.x), static_cast<int>(imageSize.y),
+                                                  GL_RGB16F, IMAGE_SAVER_PBO_COUNT);
 }
 
 AsyncImageSaver::~AsyncImageSaver() {
@@ -133,22 +224,7 @@ bool AsyncImageSaver::requestAutoSaveIfDue(const ofFbo& sourceFbo,
                                           float intervalSec,
                                           float jitterSec,
                                           const std::function<std::string()>& filepathFactory) {
-    if (intervalSec <= 0.0f) {
-        return false;
-    }
-
-    // No overlap.
-    if (getActiveSaveCount() != 0) {
-        return false;
-    }
-
-    // Initialize schedule on first eligible frame.
-    if (nextAutoSnapshotDueConfigTimeSec < 0.0f) {
-        float jitter = ofRandom(-jitterSec, jitterSec);
-        nextAutoSnapshotDueConfigTimeSec = std::max(intervalSec, intervalSec + jitter);
-    }
-
-    if (timeSec < nextAutoSnapshotDueConfigTimeSec) {
+    if (!isAutoSaveDue(timeSec, intervalSec, jitterSec)) {
         return false;
     }
 
@@ -171,81 +247,166 @@ bool AsyncImageSaver::requestAutoSaveIfDue(const ofFbo& sourceFbo,
     return true;
 }
 
+bool AsyncImageSaver::isAutoSaveDue(float timeSec, float intervalSec, float jitterSec) {
+    if (intervalSec <= 0.0f) {
+        return false;
+    }
+
+    // Autosaves only use a free PBO; the staging queue is kept for manual saves.
+    if (!queuedRequests.empty() || !findFreePboSlot()) {
+        return false;
+    }
+
+    // Initialize schedule on first eligible frame.
+    if (nextAutoSnapshotDueConfigTimeSec < 0.0f) {
+        float jitter = ofRandom(-jitterSec, jitterSec);
+        nextAutoSnapshotDueConfigTimeSec = std::max(intervalSec, intervalSec + jitter);
+    }
+
+    return timeSec >= nextAutoSnapshotDueConfigTimeSec;
+}
+
 std::size_t AsyncImageSaver::getImageByteSize() const {
     int w = static_cast<int>(imageSize.x);
     int h = static_cast<int>(imageSize.y);
     return static_cast<std::size_t>(w) * static_cast<std::size_t>(h) * 3 * sizeof(std::uint16_t);
 }
 
+AsyncImageSaver::PboSlot* AsyncImageSaver::findFreePboSlot() {
+    for (auto& slot : pboSlots) {
+        if (!slot.inFlight) return &slot;
+    }
+    return nullptr;
+}
+
+bool AsyncImageSaver::hasCapacity() const {
+    if (queuedRequests.empty()) {
+        for (const auto& slot : pboSlots) {
+            if (!slot.inFlight) return true;
+        }
+    }
+    return queuedRequests.size() < stagingFbos.size();
+}
+
 bool AsyncImageSaver::requestSave(const ofFbo& sourceFbo, const std::string& filepath) {
-    if (state != State::IDLE) {
+    // Keep requests in order: only read back directly when nothing is already queued.
+    if (queuedRequests.empty()) {
+        if (PboSlot* slot = findFreePboSlot()) {
+            issueReadback(*slot, sourceFbo, filepath);
+            return true;
+        }
+    }
+
+    int stagingIndex = findFreeStagingIndex(sourceFbo);
+    if (stagingIndex < 0) {
+        backpressureCount++;
+        ofLogWarning("AsyncImageSaver") << "Backpressure: " << pboSlots.size() << " readbacks and "
+                                        << queuedRequests.size() << " queued saves in flight; refused " << filepath;
         return false;
     }
 
+    fboCopyBlit(sourceFbo, stagingFbos[stagingIndex]);
+    if (!stagingMemory[stagingIndex].isValid()) {
+        stagingMemory[stagingIndex] = GpuMemoryRegistry::instance().addFbo("AsyncImageSaver", "staging", stagingFbos[stagingIndex]);
+    }
+    stagingInUse[stagingIndex] = true;
+    queuedRequests.push_back({ static_cast<size_t>(stagingIndex), filepath });
+    return true;
+}
+
+int AsyncImageSaver::findFreeStagingIndex(const ofFbo& sourceFbo) {
+    for (size_t i = 0; i < stagingFbos.size(); ++i) {
+        if (stagingInUse[i]) continue;
+        if (stagingFbos[i].isAllocated()) return static_cast<int>(i);
+
+        // Staging copies are optional; respect the VRAM budget before allocating another.
+        size_t bytes = GpuMemoryRegistry::estimateBytes(sourceFbo.getWidth(), sourceFbo.getHeight(),
+                                                        sourceFbo.getTexture().getTextureData().glInternalFormat);
+        if (GpuMemoryRegistry::instance().admit("AsyncImageSaver", "staging", bytes, false) < 1.0f) {
+            return -1;
+        }
+        return static_cast<int>(i);
+    }
+    return -1;
+}
+
+void AsyncImageSaver::issueReadback(PboSlot& slot, const ofFbo& sourceFbo, const std::string& filepath) {
     int w = static_cast<int>(imageSize.x);
     int h = static_cast<int>(imageSize.y);
 
     glBindFramebuffer(GL_READ_FRAMEBUFFER, sourceFbo.getId());
-    glBindBuffer(GL_PIXEL_PACK_BUFFER, pbo.getId());
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.pbo.getId());
     glReadPixels(0, 0, w, h, GL_RGB, GL_HALF_FLOAT, 0);
     glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
     glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
 
-    fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    slot.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    slot.filepath = filepath;
+    slot.framesWaited = 0;
+    slot.inFlight = true;
+}
 
-    pendingFilepath = filepath;
-    state = State::PBO_WAITING;
-    framesWaited = 0;
+void AsyncImageSaver::issueQueuedReadbacks() {
+    while (!queuedRequests.empty()) {
+        PboSlot* slot = findFreePboSlot();
+        if (!slot) return;
 
-    return true;
+        QueuedRequest request = std::move(queuedRequests.front());
+        queuedRequests.pop_front();
+        issueReadback(*slot, stagingFbos[request.stagingIndex], request.filepath);
+        stagingInUse[request.stagingIndex] = false;
+    }
 }
 
 void AsyncImageSaver::update() {
-    pruneFinishedThreads();
-
-    if (state == State::PBO_WAITING) {
-        processPboTransfer();
+    for (auto& slot : pboSlots) {
+        if (slot.inFlight) {
+            processPboTransfer(slot);
+        }
     }
+
+    issueQueuedReadbacks();
 }
 
-void AsyncImageSaver::processPboTransfer() {
-    framesWaited++;
+void AsyncImageSaver::processPboTransfer(PboSlot& slot) {
+    slot.framesWaited++;
 
-    if (framesWaited < PBO_FRAMES_TO_WAIT) {
+    if (slot.framesWaited < PBO_FRAMES_TO_WAIT) {
         return;
     }
 
-    if (!fence) {
-        ofLogError("AsyncImageSaver") << "PBO_WAITING without fence";
-        state = State::IDLE;
-        pendingFilepath.clear();
+    if (!slot.fence) {
+        ofLogError("AsyncImageSaver") << "PBO in flight without fence";
+        releasePboSlot(slot);
         return;
     }
 
-    GLenum result = glClientWaitSync(fence, 0, 0);
+    GLenum result = glClientWaitSync(slot.fence, 0, 0);
 
     if (result == GL_ALREADY_SIGNALED || result == GL_CONDITION_SATISFIED) {
-        completePboTransfer();
+        completePboTransfer(slot);
 
-    } else if (result == GL_WAIT_FAILED || framesWaited > PBO_MAX_FRAMES_BEFORE_ABANDON) {
-        ofLogError("AsyncImageSaver") << "PBO transfer failed/timed out after " << framesWaited << " frames";
-        glDeleteSync(fence);
-        fence = nullptr;
-        state = State::IDLE;
-        pendingFilepath.clear();
+    } else if (result == GL_WAIT_FAILED || slot.framesWaited > PBO_MAX_FRAMES_BEFORE_ABANDON) {
+        ofLogError("AsyncImageSaver") << "PBO transfer failed/timed out after " << slot.framesWaited << " frames";
+        releasePboSlot(slot);
     }
 }
 
-void AsyncImageSaver::completePboTransfer() {
-    if (!fence) {
-        state = State::IDLE;
-        pendingFilepath.clear();
-        return;
+void AsyncImageSaver::releasePboSlot(PboSlot& slot) {
+    if (slot.fence) {
+        glDeleteSync(slot.fence);
+        slot.fence = nullptr;
     }
+    slot.filepath.clear();
+    slot.framesWaited = 0;
+    slot.inFlight = false;
+}
 
-    // Fence is already signaled; safe to delete now.
-    glDeleteSync(fence);
-    fence = nullptr;
+void AsyncImageSaver::completePboTransfer(PboSlot& slot) {
+    if (!slot.fence) {
+        releasePboSlot(slot);
+        return;
+    }
 
     const std::size_t byteSize = getImageByteSize();
     const std::size_t elementCount = byteSize / sizeof(std::uint16_t);
@@ -254,113 +415,85 @@ void AsyncImageSaver::completePboTransfer() {
     int h = static_cast<int>(imageSize.y);
     std::size_t pixelCount = static_cast<std::size_t>(w) * static_cast<std::size_t>(h);
 
-    pbo.bind(GL_PIXEL_PACK_BUFFER);
-    void* pboPtr = pbo.map(GL_READ_ONLY);
-    pbo.unbind(GL_PIXEL_PACK_BUFFER);
+    slot.pbo.bind(GL_PIXEL_PACK_BUFFER);
+    void* pboPtr = slot.pbo.map(GL_READ_ONLY);
+    slot.pbo.unbind(GL_PIXEL_PACK_BUFFER);
 
     if (!pboPtr) {
         ofLogError("AsyncImageSaver") << "Failed to map PBO";
-        state = State::IDLE;
-        pendingFilepath.clear();
+        releasePboSlot(slot);
         return;
     }
 
     auto cpu = std::unique_ptr<std::uint16_t[]>(new (std::nothrow) std::uint16_t[elementCount]);
-    if (!cpu) {
+    if (cpu) {
+        std::memcpy(cpu.get(), pboPtr, byteSize);
+    } else {
         ofLogError("AsyncImageSaver") << "Failed to allocate CPU image buffer";
-        pbo.bind(GL_PIXEL_PACK_BUFFER);
-        pbo.unmap();
-        pbo.unbind(GL_PIXEL_PACK_BUFFER);
-        state = State::IDLE;
-        pendingFilepath.clear();
-        return;
     }
 
-    std::memcpy(cpu.get(), pboPtr, byteSize);
-
-    pbo.bind(GL_PIXEL_PACK_BUFFER);
-    pbo.unmap();
-    pbo.unbind(GL_PIXEL_PACK_BUFFER);
-
-    startSaveThread(pendingFilepath, w, h, std::move(cpu), pixelCount);
+    slot.pbo.bind(GL_PIXEL_PACK_BUFFER);
+    slot.pbo.unmap();
+    slot.pbo.unbind(GL_PIXEL_PACK_BUFFER);
 
-    pendingFilepath.clear();
-    state = State::IDLE;
+    if (cpu) {
+        submitEncode(slot.filepath, w, h, std::move(cpu), pixelCount);
+    }
+    releasePboSlot(slot);
 }
 
-void AsyncImageSaver::startSaveThread(const std::string& filepath,
-                                     int width,
-                                     int height,
-                                     std::unique_ptr<std::uint16_t[]>&& interleavedRgb,
-                                     std::size_t pixelCount) {
-    auto thread = std::make_unique<SaveThread>();
-    thread->save(filepath, width, height, std::move(interleavedRgb), pixelCount);
-    threads.push_back(std::move(thread));
-}
+void AsyncImageSaver::submitEncode(const std::string& filepath,
+                                   int width,
+                                   int height,
+                                   std::unique_ptr<std::uint16_t[]>&& interleavedRgb,
+                                   std::size_t pixelCount) {
+    // std::function needs a copyable callable, so the pixels travel in a shared_ptr.
+    auto pixels = std::make_shared<std::unique_ptr<std::uint16_t[]>>(std::move(interleavedRgb));
+    encodesInFlight++;
+    const ExrCompression jobCompression = compression;
+    encodePool.submit("exr " + filepath, [this, filepath, width, height, pixels, pixelCount, jobCompression] {
+        ofLogNotice("AsyncImageSaver") << "Saving to " << filepath;
+
+        bool saved = saveHalfRgbExr(std::move(*pixels), pixelCount, width, height, jobCompression, filepath);
+        if (!saved) {
+            ofLogError("AsyncImageSaver") << "Failed to save EXR: " << filepath;
+        }
 
-void AsyncImageSaver::pruneFinishedThreads() {
-    threads.erase(
-        std::remove_if(threads.begin(), threads.end(),
-                       [](const std::unique_ptr<SaveThread>& t) {
-                           return !t->isThreadRunning();
-                       }),
-        threads.end());
+        ofLogNotice("AsyncImageSaver") << "Done saving " << filepath;
+        encodesInFlight--;
+    });
 }
 
 void AsyncImageSaver::flush() {
-    // Complete any pending PBO transfer with blocking wait.
-    if (state == State::PBO_WAITING && fence) {
-        ofLogNotice("AsyncImageSaver") << "Flush: waiting for PBO transfer";
-        glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, GL_TIMEOUT_IGNORED);
-        completePboTransfer();
-    }
-
-    // Wait for all I/O threads.
-    for (auto& t : threads) {
-        if (t->isThreadRunning()) {
-            ofLogNotice("AsyncImageSaver") << "Flush: waiting for save thread";
-            t->waitForThread(false);
+    // Complete pending PBO transfers and queued requests with blocking waits.
+    while (true) {
+        bool anyInFlight = false;
+        for (auto& slot : pboSlots) {
+            if (!slot.inFlight) continue;
+            anyInFlight = true;
+            ofLogNotice("AsyncImageSaver") << "Flush: waiting for PBO transfer";
+            if (slot.fence) {
+                glClientWaitSync(slot.fence, GL_SYNC_FLUSH_COMMANDS_BIT, GL_TIMEOUT_IGNORED);
+            }
+            completePboTransfer(slot);
         }
+        if (!anyInFlight && queuedRequests.empty()) break;
+        issueQueuedReadbacks();
     }
-    threads.clear();
-}
 
-int AsyncImageSaver::getActiveSaveCount() const {
-    int count = static_cast<int>(threads.size());
-    if (state != State::IDLE) {
-        count++;
+    // Wait for the encode jobs (the pool is shared, so this also waits for other owners' jobs).
+    if (encodesInFlight > 0) {
+        ofLogNotice("AsyncImageSaver") << "Flush: waiting for " << encodesInFlight << " encode jobs";
+        encodePool.waitIdle();
     }
-    return count;
 }
 
-// SaveThread implementation
-void AsyncImageSaver::SaveThread::save(const std::string& filepath_,
-                                      int width_,
-                                      int height_,
-                                      std::unique_ptr<std::uint16_t[]>&& interleavedRgb_,
-                                      std::size_t pixelCount_) {
-    filepath = filepath_;
-    width = width_;
-    height = height_;
-    interleavedRgb = std::move(interleavedRgb_);
-    pixelCount = pixelCount_;
-    startThread();
-}
-
-void AsyncImageSaver::SaveThread::threadedFunction() {
-#ifdef __APPLE__
-    // Keep EXR encoding + disk I/O from starving the render thread.
-    pthread_set_qos_class_self_np(QOS_CLASS_BACKGROUND, 0);
-#endif
-
-    ofLogNotice("AsyncImageSaver") << "Saving to " << filepath;
-
-    bool saved = saveHalfRgbExrUncompressed(std::move(interleavedRgb), pixelCount, width, height, filepath);
-    if (!saved) {
-        ofLogError("AsyncImageSaver") << "Failed to save EXR: " << filepath;
+int AsyncImageSaver::getActiveSaveCount() const {
+    int count = encodesInFlight + static_cast<int>(queuedRequests.size());
+    for (const auto& slot : pboSlots) {
+        if (slot.inFlight) count++;
     }
-
-    ofLogNotice("AsyncImageSaver") << "Done saving " << filepath;
+    return count;
 }
 
 } // namespace ofxMarkSynth
@@ -6,11 +6,14 @@
 
 #pragma once
 
+#include "rendering/EncodeWorkerPool.hpp"
+#include "rendering/GpuMemoryRegistry.hpp"
 #include "ofBufferObject.h"
 #include "ofFbo.h"
-#include "ofThread.h"
 #include <cstddef>
+#include <atomic>
 #include <cstdint>
+#include <deque>
 #include <functional>
 #include <memory>
 #include <string>
@@ -18,38 +21,63 @@
 
 namespace ofxMarkSynth {
 
+/// Half-float EXR compression for saved stills.
+enum class ExrCompression {
+    None,   // Fastest encode, largest files
+    Zips,   // zlib, one scanline per chunk
+    Zip,    // zlib, 16 scanlines per chunk (default)
+    Piz     // Wavelet; usually smallest for noisy images
+};
+
 /// Handles async image saving with PBO-based GPU readback.
 ///
 /// Usage:
-///   - Call requestSave() to initiate a save (rejects if a save is in progress)
+///   - Call requestSave() to initiate a save (queued behind any saves already in flight)
 ///   - Call update() once per frame from draw()
 ///   - Call flush() on shutdown to ensure all saves complete
 ///   - Call getActiveSaveCount() for status display
 ///
-/// The implementation uses a short delay before mapping the PBO to ensure the GPU
-/// DMA transfer completes without stalling the render pipeline.
+/// Readbacks go into a ring of fenced PBOs that are polled (never waited on) each frame.
+/// When every PBO is in flight the source is blitted into a pooled staging FBO and the
+/// readback is issued once a PBO frees up, so bursts of requests keep their frame content.
+/// Only when the staging queue is also full is a request refused; that is counted as
+/// backpressure rather than dropped silently. EXR encoding and disk writes run on the shared
+/// EncodeWorkerPool, which must outlive the saver.
 class AsyncImageSaver {
 public:
-    AsyncImageSaver(glm::vec2 imageSize);
+    AsyncImageSaver(glm::vec2 imageSize, EncodeWorkerPool& encodePool);
     ~AsyncImageSaver();
 
     /// Main thread: call once per frame from draw()
     void update();
 
-    /// Main thread: request a save. Returns true if accepted, false if a save is already in progress.
+    /// Main thread: request a save. Returns false only under backpressure (PBO ring and staging queue full).
     bool requestSave(const ofFbo& sourceFbo, const std::string& filepath);
 
     /// Main thread: force completion of any pending work (for shutdown)
     void flush();
 
-    /// Count of active operations (PBO wait + I/O threads)
+    /// Main thread: compression for saves that complete readback from now on
+    void setCompression(ExrCompression compression_) { compression = compression_; }
+    ExrCompression getCompression() const { return compression; }
+
+    /// Count of active operations (queued + PBO wait + encode jobs)
     int getActiveSaveCount() const;
 
+    /// Requests waiting in the staging queue for a free PBO
+    int getQueuedSaveCount() const { return static_cast<int>(queuedRequests.size()); }
+
+    /// Requests refused because the PBO ring and staging queue were full
+    int getBackpressureCount() const { return backpressureCount; }
+
+    /// True if requestSave() would be accepted now
+    bool hasCapacity() const;
+
     /// Convenience wrapper for full-res autosave scheduling.
     ///
     /// Policy:
     /// - Uses the caller-provided timebase (usually clock time)
-    /// - Requires saver to be fully idle (no overlap)
+    /// - Only when a PBO is free, so autosaves never take staging slots from manual saves
     /// - Maintains an internal due-time with jitter
     ///
     /// Returns true if an autosave was started this call.
@@ -59,44 +87,50 @@ public:
                               float jitterSec,
                               const std::function<std::string()>& filepathFactory);
 
+    /// Whether requestAutoSaveIfDue() would start a save now (the first call starts the schedule)
+    bool isAutoSaveDue(float timeSec, float intervalSec, float jitterSec);
+
 private:
-    // PBO state (main thread only)
-    ofBufferObject pbo;
     glm::vec2 imageSize;
 
-    enum class State {
-        IDLE,
-        PBO_WAITING
+    // PBO ring (main thread only)
+    struct PboSlot {
+        ofBufferObject pbo;
+        GLsync fence { nullptr };
+        int framesWaited { 0 };
+        std::string filepath;
+        bool inFlight { false };
     };
-    State state { State::IDLE };
-    int framesWaited { 0 };
-    GLsync fence { nullptr };
-    std::string pendingFilepath;
-
-    float nextAutoSnapshotDueConfigTimeSec { -1.0f };
-
-    // I/O thread (inner class)
-    struct SaveThread : public ofThread {
-        void save(const std::string& filepath,
-                  int width,
-                  int height,
-                  std::unique_ptr<std::uint16_t[]>&& interleavedRgb,
-                  std::size_t pixelCount);
-        void threadedFunction() override;
+    std::vector<PboSlot> pboSlots;
+    GpuMemoryRegistry::Registration pboMemory;
 
+    // Staging queue (main thread only): copies of the source waiting for a free PBO
+    struct QueuedRequest {
+        size_t stagingIndex;
         std::string filepath;
-        int width { 0 };
-        int height { 0 };
-        std::unique_ptr<std::uint16_t[]> interleavedRgb;
-        std::size_t pixelCount { 0 };
     };
-    std::vector<std::unique_ptr<SaveThread>> threads;
+    std::deque<QueuedRequest> queuedRequests;
+    std::vector<ofFbo> stagingFbos;
+    std::vector<bool> stagingInUse;
+    std::vector<GpuMemoryRegistry::Registration> stagingMemory;
+    int backpressureCount { 0 };
+
+    float nextAutoSnapshotDueConfigTimeSec { -1.0f };
+
+    // Encoding + I/O runs on the shared pool; count of this saver's unfinished jobs
+    EncodeWorkerPool& encodePool;
+    std::atomic<int> encodesInFlight { 0 };
+    ExrCompression compression { ExrCompression::Zip };
 
-    void pruneFinishedThreads();
-    void processPboTransfer();
-    void completePboTransfer();
+    PboSlot* findFreePboSlot();
+    void issueReadback(PboSlot& slot, const ofFbo& sourceFbo, const std::string& filepath);
+    void issueQueuedReadbacks();
+    void processPboTransfer(PboSlot& slot);
+    void completePboTransfer(PboSlot& slot);
+    void releasePboSlot(PboSlot& slot);
+    int findFreeStagingIndex(const ofFbo& sourceFbo);
 
-    void startSaveThread(const std::string& filepath,
+    void submitEncode(const std::string& filepath,
                          int width,
                          int height,
                          std::unique_ptr<std::uint16_t[]>&& interleavedRgb,
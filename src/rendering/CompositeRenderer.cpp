@@ -5,12 +5,15 @@
 
 #include "rendering/CompositeRenderer.hpp"
 #include "rendering/RenderingConstants.h"
+#include "rendering/TiledImageWriter.hpp"
 
 #include "ofGraphics.h"
 #include "ofAppRunner.h"
 
 #include <algorithm>
 #include <cmath>
+#include <cstring>
+#include <memory>
 
 namespace ofxMarkSynth {
 
@@ -54,8 +57,10 @@ void CompositeRenderer::allocate(glm::vec2 compositeSize, float windowWidth, flo
     panelGapPx = panelGapPx_;
 
     compositeFbo.allocate(size.x, size.y, GL_RGB16F);
+    compositeMemory = GpuMemoryRegistry::instance().addFbo("CompositeRenderer", "composite", compositeFbo);
 
     tonemapShader.load();
+    tonemapSingleShader.load();
 
     // Composite quad mesh (sized to composite dimensions)
     compositeQuadMesh.setMode(OF_PRIMITIVE_TRIANGLE_FAN);
@@ -112,12 +117,22 @@ void CompositeRenderer::windowResized(float windowWidth, float windowHeight, flo
     const size_t allocWidth = static_cast<size_t>(std::max<long>(1L, std::lround(panelWidth)));
     const size_t allocHeight = static_cast<size_t>(std::max<long>(1L, std::lround(panelHeight)));
 
-    const size_t currentWidth = leftPanel.fbo.isAllocated() ? static_cast<size_t>(leftPanel.fbo.getWidth()) : 0U;
-    const size_t currentHeight = leftPanel.fbo.isAllocated() ? static_cast<size_t>(leftPanel.fbo.getHeight()) : 0U;
-
-    if (allocWidth != currentWidth || allocHeight != currentHeight) {
-        leftPanel.fbo.allocate(allocWidth, allocHeight, GL_RGB16F);
-        rightPanel.fbo.allocate(allocWidth, allocHeight, GL_RGB16F);
+    const glm::vec2 requestedSize { allocWidth, allocHeight };
+    if (requestedSize != panelRequestedSize || !leftPanel.fbo.isAllocated()) {
+        panelRequestedSize = requestedSize;
+
+        // Panels are stretched to fit when drawn, so they can be downscaled to meet a GPU budget.
+        // Two panels, each a PingPongFbo.
+        auto& registry = GpuMemoryRegistry::instance();
+        sidePanelMemory.release();
+        const size_t bytes = GpuMemoryRegistry::estimateBytes(allocWidth, allocHeight, GL_RGB16F, 4);
+        const float budgetScale = registry.admit("CompositeRenderer", "side panels", bytes, true);
+        const size_t w = std::max<size_t>(1U, static_cast<size_t>(allocWidth * budgetScale));
+        const size_t h = std::max<size_t>(1U, static_cast<size_t>(allocHeight * budgetScale));
+
+        leftPanel.fbo.allocate(w, h, GL_RGB16F);
+        rightPanel.fbo.allocate(w, h, GL_RGB16F);
+        sidePanelMemory = registry.add("CompositeRenderer", "side panels", w, h, GL_RGB16F, 4);
     }
 
     leftPanel.timeoutSecs = LEFT_PANEL_TIMEOUT_SECS;
@@ -127,13 +142,12 @@ void CompositeRenderer::windowResized(float windowWidth, float windowHeight, flo
     rightPanel.lastUpdateTime = -rightPanel.timeoutSecs;
 }
 
-void CompositeRenderer::updateCompositeBase(const CompositeParams& params) {
-    hibernationAlpha = std::clamp(params.hibernationAlpha, 0.0f, 1.0f);
-
-    // Collect layers and separate base from overlay
-    std::vector<LayerInfo> baseLayers;
+void CompositeRenderer::collectLayers(const CompositeParams& params,
+                                      std::vector<LayerInfo>& baseLayers,
+                                      std::vector<LayerInfo>& overlayLayers) {
+    baseLayers.clear();
     overlayLayers.clear();
-    
+
     const auto& drawingLayers = params.layers.getLayers();
     auto& alphaParams = params.layers.getAlphaParameterGroup();
     
@@ -153,6 +167,14 @@ void CompositeRenderer::updateCompositeBase(const CompositeParams& params) {
             baseLayers.push_back({ dlptr, finalAlpha });
         }
     }
+}
+
+void CompositeRenderer::updateCompositeBase(const CompositeParams& params) {
+    hibernationAlpha = std::clamp(params.hibernationAlpha, 0.0f, 1.0f);
+
+    // Collect layers and separate base from overlay
+    std::vector<LayerInfo> baseLayers;
+    collectLayers(params, baseLayers, overlayLayers);
     
     // Phase 1: Clear background and draw base layers
     compositeFbo.begin();
@@ -183,6 +205,13 @@ void CompositeRenderer::updateCompositeOverlays(const CompositeParams& params) {
     compositeFbo.end();
 }
 
+bool CompositeRenderer::isSidePanelUpdateDue() const {
+    if (panelWidth <= 0.0f) return false;
+    float currentTime = ofGetElapsedTimef();
+    return currentTime - leftPanel.lastUpdateTime > leftPanel.timeoutSecs
+        || currentTime - rightPanel.lastUpdateTime > rightPanel.timeoutSecs;
+}
+
 void CompositeRenderer::updateSidePanels() {
     if (panelWidth <= 0.0f) return;
     
@@ -215,6 +244,7 @@ void CompositeRenderer::draw(float windowWidth, float windowHeight,
                               const DisplayController::Settings& mainDisplay,
                               const DisplayController::Settings& sidePanelDisplay,
                               const ConfigTransitionManager* transition) {
+    gradingLut.update(mainDisplay);
     ofEnableBlendMode(OF_BLENDMODE_DISABLED);
     drawSidePanels(0.0f, windowWidth - panelWidth, panelWidth, panelHeight, sidePanelDisplay);
     drawMiddlePanel(windowWidth, windowHeight, scale, mainDisplay, transition);
@@ -224,6 +254,7 @@ void CompositeRenderer::drawToFbo(ofFbo& target,
                                    const DisplayController::Settings& mainDisplay,
                                    const DisplayController::Settings& sidePanelDisplay,
                                    const ConfigTransitionManager* transition) {
+    gradingLut.update(mainDisplay);
     ofEnableBlendMode(OF_BLENDMODE_DISABLED);
     ofClear(0, 0, 0, 255);
 
@@ -245,6 +276,205 @@ void CompositeRenderer::drawToFbo(ofFbo& target,
     drawMiddlePanel(target.getWidth(), target.getHeight(), fboScale, mainDisplay, transition);
 }
 
+bool CompositeRenderer::beginTiledStill(const CompositeParams& params,
+                                        const DisplayController::Settings& display,
+                                        int scaleFactor,
+                                        const std::filesystem::path& path,
+                                        EncodeWorkerPool& encodePool) {
+    if (tiledStill) {
+        ofLogWarning("CompositeRenderer") << "Tiled still already in progress: " << tiledStill->path;
+        return false;
+    }
+
+    scaleFactor = std::clamp(scaleFactor, 1, MAX_TILED_STILL_SCALE);
+    const int outWidth = static_cast<int>(size.x) * scaleFactor;
+    const int outHeight = static_cast<int>(size.y) * scaleFactor;
+    const int tileSize = std::min(TILED_STILL_TILE_SIZE, std::max(outWidth, outHeight));
+
+    auto& registry = GpuMemoryRegistry::instance();
+    const size_t tileBytes = GpuMemoryRegistry::estimateBytes(tileSize, tileSize, GL_RGB16F)
+                           + GpuMemoryRegistry::estimateBytes(tileSize, tileSize, GL_RGB8);
+    if (registry.admit("CompositeRenderer", "tiled still", tileBytes, false) < 1.0f) {
+        ofLogError("CompositeRenderer") << "Tiled still refused: tile FBOs exceed the GPU memory budget";
+        return false;
+    }
+
+    auto still = std::make_unique<TiledStill>();
+    still->writer = std::make_shared<TiledImageWriter>();
+    if (!still->writer->open(path, outWidth, outHeight)) return false;
+
+    still->encodePool = &encodePool;
+    still->path = path;
+    still->display = display;
+    still->scaleFactor = scaleFactor;
+    still->outWidth = outWidth;
+    still->outHeight = outHeight;
+    still->tileSize = tileSize;
+    still->tilesX = (outWidth + tileSize - 1) / tileSize;
+    still->tileCount = still->tilesX * ((outHeight + tileSize - 1) / tileSize);
+    still->startTime = ofGetElapsedTimef();
+
+    still->hdrTile.allocate(tileSize, tileSize, GL_RGB16F);
+    still->ldrTile.allocate(tileSize, tileSize, GL_RGB8);
+    still->hdrTileMemory = registry.addFbo("CompositeRenderer", "tiled still hdr", still->hdrTile);
+    still->ldrTileMemory = registry.addFbo("CompositeRenderer", "tiled still ldr", still->ldrTile);
+
+    // The layers keep their FBOs alive until the still is done, even across a config switch
+    std::vector<LayerInfo> overlays;
+    collectLayers(params, still->layers, overlays);
+    still->layers.insert(still->layers.end(), overlays.begin(), overlays.end());
+    still->background = makeBackgroundTintWithBrightness(params.backgroundColor, params.backgroundBrightness);
+
+    still->ring.resize(TILED_STILL_PBO_COUNT);
+    for (auto& slot : still->ring) {
+        slot.pbo.allocate(static_cast<size_t>(tileSize) * tileSize * 3, GL_STREAM_READ);
+    }
+
+    tiledStill = std::move(still);
+    ofLogNotice("CompositeRenderer") << "Rendering " << outWidth << "x" << outHeight << " still in "
+                                     << tiledStill->tileCount << " tiles: " << path;
+    return true;
+}
+
+bool CompositeRenderer::isTiledStillTileReady() const {
+    return tiledStill && !tiledStill->failed && tiledStill->nextTile < tiledStill->tileCount
+        && !tiledStill->ring[tiledStill->nextTile % tiledStill->ring.size()].fence;
+}
+
+bool CompositeRenderer::retireTiledStillTile(TiledStill::TileReadback& slot, bool wait) {
+    if (!slot.fence) return true;
+    const GLenum result = glClientWaitSync(slot.fence, GL_SYNC_FLUSH_COMMANDS_BIT, wait ? GL_TIMEOUT_IGNORED : 0);
+    if (result == GL_TIMEOUT_EXPIRED) return false;
+    glDeleteSync(slot.fence);
+    slot.fence = nullptr;
+    if (result == GL_WAIT_FAILED) {
+        tiledStill->failed = true;
+        return true;
+    }
+
+    auto pixels = std::make_shared<std::vector<uint8_t>>(static_cast<size_t>(slot.w) * slot.h * 3);
+    slot.pbo.bind(GL_PIXEL_PACK_BUFFER);
+    const void* mapped = slot.pbo.map(GL_READ_ONLY);
+    if (mapped) {
+        std::memcpy(pixels->data(), mapped, pixels->size());
+        slot.pbo.unmap();
+    }
+    slot.pbo.unbind(GL_PIXEL_PACK_BUFFER);
+    if (!mapped) {
+        tiledStill->failed = true;
+        return true;
+    }
+
+    tiledStill->encodePool->submit("tile " + tiledStill->path.filename().string(),
+                                   [writer = tiledStill->writer, pixels, x0 = slot.x0, y0 = slot.y0, w = slot.w, h = slot.h] {
+                                       writer->writeTile(x0, y0, w, h, pixels->data());
+                                   });
+    return true;
+}
+
+void CompositeRenderer::renderTiledStillTile() {
+    if (!isTiledStillTileReady()) return;
+    TiledStill& still = *tiledStill;
+
+    const int tileSize = still.tileSize;
+    const int x0 = (still.nextTile % still.tilesX) * tileSize;
+    const int y0 = (still.nextTile / still.tilesX) * tileSize;
+    const int w = std::min(tileSize, still.outWidth - x0);
+    const int h = std::min(tileSize, still.outHeight - y0);
+    const float scaledWidth = size.x * still.scaleFactor;
+    const float scaledHeight = size.y * still.scaleFactor;
+
+    ofPushStyle();
+    gradingLut.update(still.display);
+
+    // Composite: the same layer draws as updateCompositeBase/Overlays, offset into the upsampled frame
+    still.hdrTile.begin();
+    ofClear(still.background);
+    ofPushMatrix();
+    ofTranslate(-x0, -y0);
+    for (const auto& info : still.layers) {
+        ofEnableBlendMode(info.layer->blendMode);
+        ofSetColor(ofFloatColor { 1.0f, 1.0f, 1.0f, info.finalAlpha });
+        info.layer->fboPtr->draw(0, 0, scaledWidth, scaledHeight);
+    }
+    ofPopMatrix();
+    still.hdrTile.end();
+
+    // Tonemap + grading, as drawMiddlePanel outside transitions
+    still.ldrTile.begin();
+    ofEnableBlendMode(OF_BLENDMODE_DISABLED);
+    tonemapSingleShader.begin(still.display.toneMapType,
+                              still.display.exposure,
+                              still.display.gamma,
+                              still.display.whitePoint,
+                              gradingLut.getTextureId(),
+                              GradingLut::LUT_SIZE,
+                              still.hdrTile.getTexture().getTextureData().bFlipTexture,
+                              still.hdrTile.getTexture());
+    ofPushMatrix();
+    ofScale(tileSize, tileSize);
+    ofSetColor(255);
+    unitQuadMesh.draw();
+    ofPopMatrix();
+    tonemapSingleShader.end();
+    still.ldrTile.end();
+    ofPopStyle();
+
+    TiledStill::TileReadback& slot = still.ring[still.nextTile % still.ring.size()];
+    GLint previousPackAlignment = 4;
+    glGetIntegerv(GL_PACK_ALIGNMENT, &previousPackAlignment);
+    still.ldrTile.bind();
+    slot.pbo.bind(GL_PIXEL_PACK_BUFFER);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glReadPixels(0, 0, w, h, GL_RGB, GL_UNSIGNED_BYTE, 0);
+    glPixelStorei(GL_PACK_ALIGNMENT, previousPackAlignment);
+    slot.pbo.unbind(GL_PIXEL_PACK_BUFFER);
+    still.ldrTile.unbind();
+    slot.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    slot.x0 = x0;
+    slot.y0 = y0;
+    slot.w = w;
+    slot.h = h;
+    still.nextTile++;
+}
+
+void CompositeRenderer::updateTiledStill() {
+    if (!tiledStill) return;
+
+    bool readbacksPending = false;
+    for (auto& slot : tiledStill->ring) {
+        if (!retireTiledStillTile(slot, false)) readbacksPending = true;
+    }
+
+    if (tiledStill->failed) {
+        for (auto& slot : tiledStill->ring) {
+            if (slot.fence) glDeleteSync(slot.fence);
+        }
+        ofLogError("CompositeRenderer") << "Tiled still failed: could not read back a tile for " << tiledStill->path;
+        tiledStill.reset();
+        return;
+    }
+    if (readbacksPending || tiledStill->nextTile < tiledStill->tileCount) return;
+
+    // The writer closes the file when the last queued tile write releases it
+    ofLogNotice("CompositeRenderer") << "Rendered " << tiledStill->tileCount << " tiles for " << tiledStill->outWidth
+                                     << "x" << tiledStill->outHeight << " still in "
+                                     << (ofGetElapsedTimef() - tiledStill->startTime) << "s; writing " << tiledStill->path;
+    tiledStill.reset();
+}
+
+void CompositeRenderer::finishTiledStill() {
+    if (!tiledStill) return;
+    while (!tiledStill->failed && tiledStill->nextTile < tiledStill->tileCount) {
+        retireTiledStillTile(tiledStill->ring[tiledStill->nextTile % tiledStill->ring.size()], true);
+        renderTiledStillTile();
+    }
+    for (auto& slot : tiledStill->ring) {
+        retireTiledStillTile(slot, true);
+    }
+    updateTiledStill();
+}
+
 void CompositeRenderer::drawMiddlePanel(float w, float h, float drawScale,
                                          const DisplayController::Settings& display,
                                          const ConfigTransitionManager* transition) {
@@ -253,6 +483,7 @@ void CompositeRenderer::drawMiddlePanel(float w, float h, float drawScale,
                 (h - compositeFbo.getHeight() * drawScale) / 2.0f);
     ofScale(drawScale, drawScale);
     
+    // Only pay for the two-texture crossfade while a config transition is running.
     if (transition && transition->isTransitioning() && transition->hasValidSnapshot()) {
         const auto& snapshotTexData = transition->getSnapshotFbo().getTexture().getTextureData();
         const auto& liveTexData = compositeFbo.getTexture().getTextureData();
@@ -264,23 +495,109 @@ void CompositeRenderer::drawMiddlePanel(float w, float h, float drawScale,
                            liveTexData.bFlipTexture,
                            transition->getSnapshotFbo().getTexture(),
                            compositeFbo.getTexture());
+        ofSetColor(255);
+        compositeQuadMesh.draw();
+        tonemapShader.end();
     } else {
         const auto& texData = compositeFbo.getTexture().getTextureData();
         
-        beginTonemapShader(display,
-                           0.0f,
-                           1.0f,
-                           texData.bFlipTexture,
-                           texData.bFlipTexture,
-                           compositeFbo.getTexture(),
-                           compositeFbo.getTexture());
+        tonemapSingleShader.begin(display.toneMapType,
+                                  display.exposure,
+                                  display.gamma,
+                                  display.whitePoint,
+                                  gradingLut.getTextureId(),
+                                  GradingLut::LUT_SIZE,
+                                  texData.bFlipTexture,
+                                  compositeFbo.getTexture());
+        ofSetColor(255);
+        compositeQuadMesh.draw();
+        tonemapSingleShader.end();
     }
     
+    ofPopMatrix();
+}
+
+bool CompositeRenderer::allocateThumbnailDownsample(int size0, int size1) {
+    auto matches = [](const ofFbo& fbo, int fboSize) {
+        return fboSize == 0 ? !fbo.isAllocated() : fbo.isAllocated() && static_cast<int>(fbo.getWidth()) == fboSize;
+    };
+    if (matches(thumbnailDownsampleFbos[0], size0) && matches(thumbnailDownsampleFbos[1], size1)) return true;
+
+    thumbnailDownsampleMemory[0].release();
+    thumbnailDownsampleMemory[1].release();
+    thumbnailDownsampleFbos[0].clear();
+    thumbnailDownsampleFbos[1].clear();
+
+    auto& registry = GpuMemoryRegistry::instance();
+    const size_t bytes = GpuMemoryRegistry::estimateBytes(size0, size0, GL_RGB8)
+                       + (size1 > 0 ? GpuMemoryRegistry::estimateBytes(size1, size1, GL_RGB8) : 0);
+    if (registry.admit("CompositeRenderer", "thumbnail downsample", bytes, false) < 1.0f) {
+        ofLogWarning("CompositeRenderer") << "Config thumbnail refused by the GPU memory budget";
+        return false;
+    }
+    const int sizes[2] = { size0, size1 };
+    for (int i = 0; i < 2; ++i) {
+        if (sizes[i] <= 0) continue;
+        thumbnailDownsampleFbos[i].allocate(sizes[i], sizes[i], GL_RGB8);
+        thumbnailDownsampleFbos[i].getTexture().setTextureMinMagFilter(GL_LINEAR, GL_LINEAR);
+        thumbnailDownsampleMemory[i] = registry.addFbo("CompositeRenderer", "thumbnail downsample", thumbnailDownsampleFbos[i]);
+    }
+    return true;
+}
+
+void CompositeRenderer::renderThumbnail(const DisplayController::Settings& display, ofFbo& target) {
+    if (!compositeFbo.isAllocated() || !target.isAllocated()) return;
+
+    // Halve the centre crop until the next halving would pass the target size. Each halving (the
+    // tonemap pass, then linear blits) reads exactly 2x2 texels per output, so every pixel counts.
+    const float cropSize = std::min(compositeFbo.getWidth(), compositeFbo.getHeight());
+    const int targetSize = static_cast<int>(target.getWidth());
+    std::vector<int> stageSizes { std::max(targetSize, static_cast<int>(cropSize) / 2) };
+    while (stageSizes.back() / 2 >= targetSize) stageSizes.push_back(stageSizes.back() / 2);
+    // Stages alternate between two FBOs, each sized for the largest stage it holds
+    if (!allocateThumbnailDownsample(stageSizes[0], stageSizes.size() > 1 ? stageSizes[1] : 0)) return;
+
+    ofFbo& firstStage = thumbnailDownsampleFbos[0];
+    ofPushStyle();
+    gradingLut.update(display);
+    firstStage.begin();
+    ofEnableBlendMode(OF_BLENDMODE_DISABLED);
+    ofPushMatrix();
+    ofScale(stageSizes[0] / cropSize, stageSizes[0] / cropSize);
+    ofTranslate(-(compositeFbo.getWidth() - cropSize) / 2.0f, -(compositeFbo.getHeight() - cropSize) / 2.0f);
+    tonemapSingleShader.begin(display.toneMapType,
+                              display.exposure,
+                              display.gamma,
+                              display.whitePoint,
+                              gradingLut.getTextureId(),
+                              GradingLut::LUT_SIZE,
+                              compositeFbo.getTexture().getTextureData().bFlipTexture,
+                              compositeFbo.getTexture());
     ofSetColor(255);
     compositeQuadMesh.draw();
-    tonemapShader.end();
-    
+    tonemapSingleShader.end();
     ofPopMatrix();
+    firstStage.end();
+    ofPopStyle();
+
+    GLint previousReadFramebuffer = 0;
+    GLint previousDrawFramebuffer = 0;
+    glGetIntegerv(GL_READ_FRAMEBUFFER_BINDING, &previousReadFramebuffer);
+    glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &previousDrawFramebuffer);
+
+    auto blit = [](const ofFbo& from, int fromSize, const ofFbo& to, int toSize) {
+        glBindFramebuffer(GL_READ_FRAMEBUFFER, from.getId());
+        glBindFramebuffer(GL_DRAW_FRAMEBUFFER, to.getId());
+        glBlitFramebuffer(0, 0, fromSize, fromSize, 0, 0, toSize, toSize, GL_COLOR_BUFFER_BIT, GL_LINEAR);
+    };
+    for (size_t i = 1; i < stageSizes.size(); ++i) {
+        blit(thumbnailDownsampleFbos[(i - 1) % 2], stageSizes[i - 1], thumbnailDownsampleFbos[i % 2], stageSizes[i]);
+    }
+    const size_t lastStage = stageSizes.size() - 1;
+    blit(thumbnailDownsampleFbos[lastStage % 2], stageSizes[lastStage], target, targetSize);
+
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, previousReadFramebuffer);
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, previousDrawFramebuffer);
 }
 
 void CompositeRenderer::drawSidePanels(float xleft, float xright, float w, float h,
@@ -339,10 +656,8 @@ void CompositeRenderer::beginTonemapShader(const DisplayController::Settings& di
                         display.exposure,
                         display.gamma,
                         display.whitePoint,
-                        display.contrast,
-                        display.saturation,
-                        display.brightness,
-                        display.hueShift,
+                        gradingLut.getTextureId(),
+                        GradingLut::LUT_SIZE,
                         weightA,
                         weightB,
                         flipTextureA,
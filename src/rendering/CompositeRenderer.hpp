@@ -11,9 +11,17 @@
 #include "controller/LayerController.hpp"
 #include "controller/ConfigTransitionManager.hpp"
 #include "rendering/TonemapCrossfadeShader.h"
+#include "rendering/GradingLut.hpp"
+#include "rendering/GpuMemoryRegistry.hpp"
+#include "rendering/EncodeWorkerPool.hpp"
+#include "rendering/TiledImageWriter.hpp"
 #include "PingPongFbo.h"
+#include "ofBufferObject.h"
 #include "ofFbo.h"
 #include "ofMesh.h"
+#include <filesystem>
+#include <memory>
+#include <vector>
 
 namespace ofxMarkSynth {
 
@@ -45,8 +53,9 @@ public:
     /// Call this after mods have rendered their overlays
     void updateCompositeOverlays(const CompositeParams& params);
 
-    /// Update side panels with new crops from composite (call each frame)
+    /// Update side panels with new crops from composite, for each panel whose timeout has passed
     void updateSidePanels();
+    bool isSidePanelUpdateDue() const;
 
     /// Draw to screen
     void draw(float windowWidth, float windowHeight,
@@ -60,6 +69,34 @@ public:
                    const DisplayController::Settings& sidePanelDisplay,
                    const ConfigTransitionManager* transition);
 
+    /// Start an oversize still (composite size x scaleFactor) as a binary PPM, rendered tile by
+    /// tile: each tile re-composites the layer FBOs upsampled, then applies tonemap + grading.
+    /// Tiles are read back through a small PBO ring and written on the encode pool, so VRAM use
+    /// is fixed regardless of output size. Mod overlays and config transitions are not reproduced.
+    /// Tiles are rendered on later frames (renderTiledStillTile), so each shows the layers as they
+    /// are when it renders. Fails if a still is already in progress.
+    bool beginTiledStill(const CompositeParams& params,
+                         const DisplayController::Settings& display,
+                         int scaleFactor,
+                         const std::filesystem::path& path,
+                         EncodeWorkerPool& encodePool);
+    bool isTiledStillActive() const { return tiledStill != nullptr; }
+    /// True when another tile remains and its readback slot is free
+    bool isTiledStillTileReady() const;
+    /// Render the next tile and start its readback (no-op unless isTiledStillTileReady())
+    void renderTiledStillTile();
+    /// Call every frame: hand finished tile readbacks to the encode pool without waiting, and
+    /// end the still once every tile has been read back.
+    void updateTiledStill();
+    /// Render and read back every remaining tile, waiting on the GPU (for shutdown)
+    void finishTiledStill();
+
+    /// Render a square, centre-cropped, tonemapped + graded thumbnail of the composite into
+    /// `target` (square, allocated by the caller). The crop is tonemapped at half size, then
+    /// halved with linear blits through two small persistent FBOs, so the downsample averages
+    /// every pixel instead of skipping. Skipped if the GPU memory budget refuses those FBOs.
+    void renderThumbnail(const DisplayController::Settings& display, ofFbo& target);
+
     // Accessors
     const ofFbo& getCompositeFbo() const { return compositeFbo; }
     glm::vec2 getCompositeSize() const { return size; }
@@ -86,9 +123,22 @@ private:
     float panelWidth { 0.0f };
     float panelHeight { 0.0f };
     float panelGapPx { 0.0f };
+    glm::vec2 panelRequestedSize { 0, 0 };   // Before any GPU budget downscale
+
+    GpuMemoryRegistry::Registration compositeMemory;
+    GpuMemoryRegistry::Registration sidePanelMemory;
+
+    // Config thumbnail downsample stages (allocated on first use)
+    ofFbo thumbnailDownsampleFbos[2];
+    GpuMemoryRegistry::Registration thumbnailDownsampleMemory[2];
+    bool allocateThumbnailDownsample(int size0, int size1);
 
     // Shader and meshes
-    TonemapCrossfadeShader tonemapShader;
+    TonemapCrossfadeShader tonemapShader;      // Config transitions and side panel fades
+    TonemapShader tonemapSingleShader;          // Steady-state middle panel
+    // Shared by main and side panels: DisplayController side panel settings only differ in
+    // exposure, which is applied before the LUT.
+    GradingLut gradingLut;
     ofMesh compositeQuadMesh;
     ofMesh unitQuadMesh;
 
@@ -99,6 +149,45 @@ private:
     };
     std::vector<LayerInfo> overlayLayers;
 
+    // Oversize still in progress (see beginTiledStill)
+    struct TiledStill {
+        // A slot is reused only after its tile has been handed to the writer
+        struct TileReadback {
+            ofBufferObject pbo;
+            GLsync fence { nullptr };
+            int x0 { 0 }, y0 { 0 }, w { 0 }, h { 0 };
+        };
+
+        std::shared_ptr<TiledImageWriter> writer;
+        EncodeWorkerPool* encodePool { nullptr };
+        std::filesystem::path path;
+        DisplayController::Settings display;
+        std::vector<LayerInfo> layers;   // Base then overlay, in draw order
+        ofFloatColor background;
+        ofFbo hdrTile;
+        ofFbo ldrTile;
+        GpuMemoryRegistry::Registration hdrTileMemory;
+        GpuMemoryRegistry::Registration ldrTileMemory;
+        std::vector<TileReadback> ring;
+        int scaleFactor { 1 };
+        int outWidth { 0 };
+        int outHeight { 0 };
+        int tileSize { 0 };
+        int tilesX { 0 };
+        int tileCount { 0 };
+        int nextTile { 0 };
+        float startTime { 0.0f };
+        bool failed { false };
+    };
+    std::unique_ptr<TiledStill> tiledStill;
+    /// Returns false if the readback isn't finished yet (only when not waiting)
+    bool retireTiledStillTile(TiledStill::TileReadback& slot, bool wait);
+
+    /// Visible layers with their final alpha, split into base and overlay
+    static void collectLayers(const CompositeParams& params,
+                              std::vector<LayerInfo>& baseLayers,
+                              std::vector<LayerInfo>& overlayLayers);
+
     // Internal draw helpers
     void drawMiddlePanel(float w, float h, float drawScale,
                          const DisplayController::Settings& display,
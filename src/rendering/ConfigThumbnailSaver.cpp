@@ -0,0 +1,126 @@
+//
+//  ConfigThumbnailSaver.cpp
+//  ofxMarkSynth
+//
+
+#include "rendering/ConfigThumbnailSaver.hpp"
+#include "rendering/RenderingConstants.h"
+#include "ofImage.h"
+#include "ofLog.h"
+#include <cstring>
+#include <system_error>
+#include <utility>
+
+namespace ofxMarkSynth {
+
+ConfigThumbnailSaver::ConfigThumbnailSaver(EncodeWorkerPool& encodePool_)
+: encodePool(encodePool_),
+  written(std::make_shared<WrittenPaths>())
+{}
+
+ConfigThumbnailSaver::~ConfigThumbnailSaver() {
+    for (auto& readback : pending) {
+        if (readback->fence) glDeleteSync(readback->fence);
+    }
+}
+
+std::filesystem::path ConfigThumbnailSaver::getThumbnailPath(const std::filesystem::path& configPath) {
+    auto path = configPath;
+    path.replace_extension(".jpg");
+    return path;
+}
+
+void ConfigThumbnailSaver::capture(CompositeRenderer& compositeRenderer,
+                                   const DisplayController::Settings& display,
+                                   const std::filesystem::path& configPath) {
+    if (!thumbnailFbo.isAllocated()) {
+        thumbnailFbo.allocate(CONFIG_THUMBNAIL_SIZE, CONFIG_THUMBNAIL_SIZE, GL_RGB8);
+        thumbnailMemory = GpuMemoryRegistry::instance().addFbo("ConfigThumbnailSaver", "thumbnail", thumbnailFbo);
+    }
+    compositeRenderer.renderThumbnail(display, thumbnailFbo);
+
+    auto readback = std::make_unique<PendingReadback>();
+    readback->path = getThumbnailPath(configPath);
+    readback->pbo.allocate(static_cast<size_t>(CONFIG_THUMBNAIL_SIZE) * CONFIG_THUMBNAIL_SIZE * 3, GL_STREAM_READ);
+
+    thumbnailFbo.bind();
+    readback->pbo.bind(GL_PIXEL_PACK_BUFFER);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glReadPixels(0, 0, CONFIG_THUMBNAIL_SIZE, CONFIG_THUMBNAIL_SIZE, GL_RGB, GL_UNSIGNED_BYTE, 0);
+    readback->pbo.unbind(GL_PIXEL_PACK_BUFFER);
+    thumbnailFbo.unbind();
+    readback->fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+    pending.push_back(std::move(readback));
+}
+
+void ConfigThumbnailSaver::update() {
+    for (auto it = pending.begin(); it != pending.end();) {
+        const GLenum result = glClientWaitSync((*it)->fence, 0, 0);
+        if (result == GL_TIMEOUT_EXPIRED) {
+            ++it;
+            continue;
+        }
+        if (result == GL_WAIT_FAILED) {
+            ofLogError("ConfigThumbnailSaver") << "Readback fence failed for " << (*it)->path;
+        } else {
+            complete(**it);
+        }
+        glDeleteSync((*it)->fence);
+        it = pending.erase(it);
+    }
+}
+
+void ConfigThumbnailSaver::flush() {
+    for (auto& readback : pending) {
+        glClientWaitSync(readback->fence, GL_SYNC_FLUSH_COMMANDS_BIT, GL_TIMEOUT_IGNORED);
+        complete(*readback);
+        glDeleteSync(readback->fence);
+    }
+    pending.clear();
+    encodePool.waitIdle();
+}
+
+void ConfigThumbnailSaver::complete(PendingReadback& readback) {
+    ofPixels pixels;
+    pixels.allocate(CONFIG_THUMBNAIL_SIZE, CONFIG_THUMBNAIL_SIZE, OF_PIXELS_RGB);
+
+    readback.pbo.bind(GL_PIXEL_PACK_BUFFER);
+    const void* mapped = readback.pbo.map(GL_READ_ONLY);
+    if (mapped) {
+        std::memcpy(pixels.getData(), mapped, pixels.size());
+        readback.pbo.unmap();
+    }
+    readback.pbo.unbind(GL_PIXEL_PACK_BUFFER);
+    if (!mapped) {
+        ofLogError("ConfigThumbnailSaver") << "Failed to map readback for " << readback.path;
+        return;
+    }
+
+    encodePool.submit("thumbnail " + readback.path.filename().string(),
+                      [pixels = std::move(pixels), path = readback.path, written = written] {
+                          // Write then rename, so the navigator never decodes a partial file
+                          // (the temp name keeps the .jpg extension, which picks the encoder).
+                          const auto tempPath = path.parent_path() / ("." + path.stem().string() + ".tmp.jpg");
+                          if (!ofSaveImage(pixels, tempPath, OF_IMAGE_QUALITY_HIGH)) {
+                              ofLogError("ConfigThumbnailSaver") << "Failed to encode " << path;
+                              return;
+                          }
+                          std::error_code ec;
+                          std::filesystem::rename(tempPath, path, ec);
+                          if (ec) {
+                              ofLogError("ConfigThumbnailSaver") << "Failed to write " << path << ": " << ec.message();
+                              std::filesystem::remove(tempPath, ec);
+                              return;
+                          }
+                          std::lock_guard<std::mutex> lock(written->mutex);
+                          written->paths.push_back(path);
+                      });
+}
+
+std::vector<std::filesystem::path> ConfigThumbnailSaver::takeWrittenPaths() {
+    std::lock_guard<std::mutex> lock(written->mutex);
+    return std::exchange(written->paths, {});
+}
+
+} // namespace ofxMarkSynth
@@ -0,0 +1,68 @@
+//
+//  ConfigThumbnailSaver.hpp
+//  ofxMarkSynth
+//
+//  Writes a small JPEG of the composite next to a config's JSON (<stem>.jpg, as read by
+//  PerformanceNavigator) when that config is left. The thumbnail is rendered at its final size on
+//  the GPU, read back through a fenced PBO that is polled each frame, and encoded on the
+//  EncodeWorkerPool, so leaving a config never waits on readback or disk.
+//
+
+#pragma once
+
+#include "rendering/CompositeRenderer.hpp"
+#include "rendering/EncodeWorkerPool.hpp"
+#include "ofBufferObject.h"
+#include "ofFbo.h"
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace ofxMarkSynth {
+
+class ConfigThumbnailSaver {
+public:
+    explicit ConfigThumbnailSaver(EncodeWorkerPool& encodePool);
+    ~ConfigThumbnailSaver();
+
+    /// Main thread: render a thumbnail of the current composite and start its readback.
+    /// `configPath` is the config JSON; the thumbnail goes alongside it as <stem>.jpg.
+    void capture(CompositeRenderer& compositeRenderer,
+                 const DisplayController::Settings& display,
+                 const std::filesystem::path& configPath);
+
+    /// Main thread: hand finished readbacks to the encode pool. Call once per frame.
+    void update();
+
+    /// Main thread: finish every readback and encode (for shutdown).
+    void flush();
+
+    /// Main thread: thumbnails written to disk since the last call.
+    std::vector<std::filesystem::path> takeWrittenPaths();
+
+    static std::filesystem::path getThumbnailPath(const std::filesystem::path& configPath);
+
+private:
+    struct PendingReadback {
+        ofBufferObject pbo;
+        GLsync fence { nullptr };
+        std::filesystem::path path;
+    };
+
+    EncodeWorkerPool& encodePool;
+    ofFbo thumbnailFbo;
+    GpuMemoryRegistry::Registration thumbnailMemory;
+    std::vector<std::unique_ptr<PendingReadback>> pending;
+
+    // Shared with encode jobs, which may finish after the saver is gone
+    struct WrittenPaths {
+        std::mutex mutex;
+        std::vector<std::filesystem::path> paths;
+    };
+    std::shared_ptr<WrittenPaths> written;
+
+    void complete(PendingReadback& readback);
+};
+
+} // namespace ofxMarkSynth
@@ -0,0 +1,329 @@
+//
+//  DensityMetrics.cpp
+//  ofxMarkSynth
+//
+
+#include "rendering/DensityMetrics.hpp"
+#include <glm/gtc/packing.hpp>
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#if defined(__ARM_NEON)
+#include <arm_neon.h>
+#elif defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+namespace ofxMarkSynth {
+
+// Rec. 709 luma
+static constexpr float LUMA_R = 0.2126f;
+static constexpr float LUMA_G = 0.7152f;
+static constexpr float LUMA_B = 0.0722f;
+
+// Pixels converted and summed per block: the block's luma stays in L1 while it's summed, and the
+// float lane sums are flushed to double before they lose precision.
+static constexpr size_t BLOCK_PIXELS = 1024;
+static constexpr size_t LANES = 8;
+
+#if defined(__x86_64__) || defined(__i386__)
+// pshufb masks that gather one channel from each of three 16-byte loads (16 interleaved RGB8 pixels).
+struct Rgb8DeinterleaveMasks {
+    alignas(16) std::int8_t bytes[3][3][16];  // [channel][source vector][byte]
+
+    Rgb8DeinterleaveMasks() {
+        for (int c = 0; c < 3; ++c) {
+            for (int k = 0; k < 3; ++k) {
+                for (int j = 0; j < 16; ++j) {
+                    const int element = 3 * j + c;
+                    bytes[c][k][j] = (element / 16 == k) ? static_cast<std::int8_t>(element % 16) : -128;
+                }
+            }
+        }
+    }
+};
+
+__attribute__((target("ssse3")))
+static size_t rgb8ToLumaSsse3(const uint8_t* rgb, size_t pixelCount, float* luma) {
+    static const Rgb8DeinterleaveMasks masks;
+    __m128i m[3][3];
+    for (int c = 0; c < 3; ++c) {
+        for (int k = 0; k < 3; ++k) {
+            m[c][k] = _mm_load_si128(reinterpret_cast<const __m128i*>(masks.bytes[c][k]));
+        }
+    }
+    const __m128i zero = _mm_setzero_si128();
+    const __m128 weights[3] = { _mm_set1_ps(LUMA_R / 255.0f), _mm_set1_ps(LUMA_G / 255.0f), _mm_set1_ps(LUMA_B / 255.0f) };
+
+    size_t i = 0;
+    for (; i + 16 <= pixelCount; i += 16) {
+        const __m128i* src = reinterpret_cast<const __m128i*>(rgb + 3 * i);
+        const __m128i v0 = _mm_loadu_si128(src);
+        const __m128i v1 = _mm_loadu_si128(src + 1);
+        const __m128i v2 = _mm_loadu_si128(src + 2);
+
+        __m128i channel16[3][2];  // [channel][low/high 8 pixels], widened to 16 bits
+        for (int c = 0; c < 3; ++c) {
+            const __m128i bytes = _mm_or_si128(_mm_or_si128(_mm_shuffle_epi8(v0, m[c][0]), _mm_shuffle_epi8(v1, m[c][1])),
+                                               _mm_shuffle_epi8(v2, m[c][2]));
+            channel16[c][0] = _mm_unpacklo_epi8(bytes, zero);
+            channel16[c][1] = _mm_unpackhi_epi8(bytes, zero);
+        }
+
+        for (int h = 0; h < 2; ++h) {
+            for (int q = 0; q < 2; ++q) {
+                __m128 y = _mm_setzero_ps();
+                for (int c = 0; c < 3; ++c) {
+                    const __m128i wide = q ? _mm_unpackhi_epi16(channel16[c][h], zero) : _mm_unpacklo_epi16(channel16[c][h], zero);
+                    y = _mm_add_ps(y, _mm_mul_ps(_mm_cvtepi32_ps(wide), weights[c]));
+                }
+                _mm_storeu_ps(luma + i + h * 8 + q * 4, y);
+            }
+        }
+    }
+    return i;
+}
+
+__attribute__((target("f16c")))
+static size_t halfToFloatF16c(const uint16_t* halves, size_t count, float* out) {
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        _mm256_storeu_ps(out + i, _mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(halves + i))));
+    }
+    return i;
+}
+#endif
+
+static void rgb8ToLuma(const uint8_t* rgb, size_t pixelCount, float* luma) {
+    size_t i = 0;
+#if defined(__ARM_NEON)
+    const float32x4_t zero = vdupq_n_f32(0.0f);
+    for (; i + 16 <= pixelCount; i += 16) {
+        const uint8x16x3_t px = vld3q_u8(rgb + 3 * i);
+        const uint16x8_t r[2] = { vmovl_u8(vget_low_u8(px.val[0])), vmovl_u8(vget_high_u8(px.val[0])) };
+        const uint16x8_t g[2] = { vmovl_u8(vget_low_u8(px.val[1])), vmovl_u8(vget_high_u8(px.val[1])) };
+        const uint16x8_t b[2] = { vmovl_u8(vget_low_u8(px.val[2])), vmovl_u8(vget_high_u8(px.val[2])) };
+        for (int h = 0; h < 2; ++h) {
+            const uint16x4_t rq[2] = { vget_low_u16(r[h]), vget_high_u16(r[h]) };
+            const uint16x4_t gq[2] = { vget_low_u16(g[h]), vget_high_u16(g[h]) };
+            const uint16x4_t bq[2] = { vget_low_u16(b[h]), vget_high_u16(b[h]) };
+            for (int q = 0; q < 2; ++q) {
+                float32x4_t y = vmlaq_n_f32(zero, vcvtq_f32_u32(vmovl_u16(rq[q])), LUMA_R / 255.0f);
+                y = vmlaq_n_f32(y, vcvtq_f32_u32(vmovl_u16(gq[q])), LUMA_G / 255.0f);
+                y = vmlaq_n_f32(y, vcvtq_f32_u32(vmovl_u16(bq[q])), LUMA_B / 255.0f);
+                vst1q_f32(luma + i + h * 8 + q * 4, y);
+            }
+        }
+    }
+#elif defined(__x86_64__) || defined(__i386__)
+    static const bool hasSsse3 = __builtin_cpu_supports("ssse3");
+    if (hasSsse3) {
+        i = rgb8ToLumaSsse3(rgb, pixelCount, luma);
+    }
+#endif
+    for (; i < pixelCount; ++i) {
+        luma[i] = (LUMA_R / 255.0f) * rgb[3 * i + 0] + (LUMA_G / 255.0f) * rgb[3 * i + 1] + (LUMA_B / 255.0f) * rgb[3 * i + 2];
+    }
+}
+
+static void rgb16fToLuma(const uint16_t* rgb, size_t pixelCount, float* luma) {
+    size_t i = 0;
+#if defined(__ARM_NEON) && defined(__aarch64__)
+    for (; i + 8 <= pixelCount; i += 8) {
+        const uint16x8x3_t px = vld3q_u16(rgb + 3 * i);
+        for (int h = 0; h < 2; ++h) {
+            const auto toFloat = [h](uint16x8_t v) {
+                return vcvt_f32_f16(vreinterpret_f16_u16(h ? vget_high_u16(v) : vget_low_u16(v)));
+            };
+            float32x4_t y = vmulq_n_f32(toFloat(px.val[0]), LUMA_R);
+            y = vmlaq_n_f32(y, toFloat(px.val[1]), LUMA_G);
+            y = vmlaq_n_f32(y, toFloat(px.val[2]), LUMA_B);
+            vst1q_f32(luma + i + h * 4, y);
+        }
+    }
+#elif defined(__x86_64__) || defined(__i386__)
+    static const bool hasF16c = __builtin_cpu_supports("f16c");
+    if (hasF16c) {
+        // Widen the interleaved halves 8 at a time, then weight the floats.
+        float rgbFloat[3 * BLOCK_PIXELS];
+        while (i < pixelCount) {
+            const size_t count = std::min(BLOCK_PIXELS, pixelCount - i);
+            const size_t converted = halfToFloatF16c(rgb + 3 * i, 3 * count, rgbFloat);
+            for (size_t k = converted; k < 3 * count; ++k) {
+                rgbFloat[k] = glm::unpackHalf1x16(rgb[3 * i + k]);
+            }
+            for (size_t k = 0; k < count; ++k) {
+                luma[i + k] = LUMA_R * rgbFloat[3 * k + 0] + LUMA_G * rgbFloat[3 * k + 1] + LUMA_B * rgbFloat[3 * k + 2];
+            }
+            i += count;
+        }
+    }
+#endif
+    for (; i < pixelCount; ++i) {
+        luma[i] = LUMA_R * glm::unpackHalf1x16(rgb[3 * i + 0])
+            + LUMA_G * glm::unpackHalf1x16(rgb[3 * i + 1])
+            + LUMA_B * glm::unpackHalf1x16(rgb[3 * i + 2]);
+    }
+}
+
+// Fixed-width lane loops (no reassociation needed) so the compiler can vectorize them. Sums are of
+// luma - shift, with shift near the mean, so E[d²] - E[d]² doesn't cancel away the variance.
+static void accumulateLuma(const float* luma, size_t count, float shift, double& sum, double& sumSq) {
+    float laneSum[LANES] = {};
+    float laneSumSq[LANES] = {};
+    size_t i = 0;
+    for (; i + LANES <= count; i += LANES) {
+        for (size_t l = 0; l < LANES; ++l) {
+            const float d = luma[i + l] - shift;
+            laneSum[l] += d;
+            laneSumSq[l] += d * d;
+        }
+    }
+    for (; i < count; ++i) {
+        const float d = luma[i] - shift;
+        laneSum[0] += d;
+        laneSumSq[0] += d * d;
+    }
+    for (size_t l = 0; l < LANES; ++l) {
+        sum += laneSum[l];
+        sumSq += laneSumSq[l];
+    }
+}
+
+static size_t countActive(const float* luma, size_t count, float mean, float activeEpsilon) {
+    uint32_t laneCount[LANES] = {};
+    size_t i = 0;
+    for (; i + LANES <= count; i += LANES) {
+        for (size_t l = 0; l < LANES; ++l) {
+            laneCount[l] += (std::abs(luma[i + l] - mean) > activeEpsilon) ? 1u : 0u;
+        }
+    }
+    size_t active = 0;
+    for (; i < count; ++i) {
+        active += (std::abs(luma[i] - mean) > activeEpsilon) ? 1 : 0;
+    }
+    for (size_t l = 0; l < LANES; ++l) {
+        active += laneCount[l];
+    }
+    return active;
+}
+
+template <typename T>
+static DensityMetrics computeDensityMetrics(const T* rgb, size_t pixelCount, float activeEpsilon,
+                                            void (*toLuma)(const T*, size_t, float*)) {
+    if (!rgb || pixelCount == 0) return {};
+
+    // The active count needs the final mean, so keep the luma for a second pass over the whole
+    // buffer (streamed from L2 or memory at the larger analysis sizes, not from L1).
+    thread_local std::vector<float> luma;
+    luma.resize(pixelCount);
+
+    double sum = 0.0;
+    double sumSq = 0.0;
+    float shift = 0.0f;
+    for (size_t start = 0; start < pixelCount; start += BLOCK_PIXELS) {
+        const size_t count = std::min(BLOCK_PIXELS, pixelCount - start);
+        toLuma(rgb + 3 * start, count, luma.data() + start);
+        if (start == 0) {
+            // Mean of the first block: close enough to the overall mean for the shifted sums
+            double firstSum = 0.0;
+            double unused = 0.0;
+            accumulateLuma(luma.data(), count, 0.0f, firstSum, unused);
+            shift = static_cast<float>(firstSum / static_cast<double>(count));
+        }
+        accumulateLuma(luma.data() + start, count, shift, sum, sumSq);
+    }
+
+    const double n = static_cast<double>(pixelCount);
+    const double meanOffset = sum / n;
+    const double mean = shift + meanOffset;
+    const double variance = std::max(0.0, sumSq / n - meanOffset * meanOffset);
+    const size_t active = countActive(luma.data(), pixelCount, static_cast<float>(mean), activeEpsilon);
+
+    DensityMetrics out;
+    out.variance = static_cast<float>(variance);
+    out.activeFraction = static_cast<float>(active) / static_cast<float>(pixelCount);
+    return out;
+}
+
+DensityMetrics computeDensityMetricsRgb8(const uint8_t* rgb, size_t pixelCount, float activeEpsilon) {
+    return computeDensityMetrics(rgb, pixelCount, activeEpsilon, rgb8ToLuma);
+}
+
+DensityMetrics computeDensityMetricsRgb16f(const uint16_t* rgb, size_t pixelCount, float activeEpsilon) {
+    return computeDensityMetrics(rgb, pixelCount, activeEpsilon, rgb16fToLuma);
+}
+
+static float computeLuma01(unsigned char r, unsigned char g, unsigned char b) {
+    return (LUMA_R * (static_cast<float>(r) / 255.0f))
+        + (LUMA_G * (static_cast<float>(g) / 255.0f))
+        + (LUMA_B * (static_cast<float>(b) / 255.0f));
+}
+
+DensityMetrics computeDensityMetricsRgb8Reference(const uint8_t* rgb, size_t pixelCount, float activeEpsilon) {
+    if (!rgb || pixelCount == 0) return {};
+
+    double mean = 0.0;
+    for (size_t i = 0; i < pixelCount; ++i) {
+        mean += computeLuma01(rgb[i * 3 + 0], rgb[i * 3 + 1], rgb[i * 3 + 2]);
+    }
+    mean /= static_cast<double>(pixelCount);
+
+    double var = 0.0;
+    size_t activeCount = 0;
+    for (size_t i = 0; i < pixelCount; ++i) {
+        float y = computeLuma01(rgb[i * 3 + 0], rgb[i * 3 + 1], rgb[i * 3 + 2]);
+        float d = y - static_cast<float>(mean);
+        var += static_cast<double>(d) * static_cast<double>(d);
+
+        if (std::abs(d) > activeEpsilon) {
+            activeCount++;
+        }
+    }
+
+    DensityMetrics out;
+    out.variance = static_cast<float>(var / static_cast<double>(pixelCount));
+    out.activeFraction = static_cast<float>(activeCount) / static_cast<float>(pixelCount);
+    return out;
+}
+
+uint64_t computePerceptualHash(const float* blockLuma) {
+    constexpr int blockCount = PERCEPTUAL_HASH_SIZE * PERCEPTUAL_HASH_SIZE;
+    float mean = 0.0f;
+    for (int i = 0; i < blockCount; ++i) {
+        mean += blockLuma[i];
+    }
+    mean /= static_cast<float>(blockCount);
+
+    uint64_t hash = 0;
+    for (int i = 0; i < blockCount; ++i) {
+        if (blockLuma[i] > mean) hash |= uint64_t { 1 } << i;
+    }
+    return hash;
+}
+
+uint64_t computePerceptualHashRgb8(const uint8_t* rgb, int size) {
+    if (!rgb || size < PERCEPTUAL_HASH_SIZE) return 0;
+
+    float blockLuma[PERCEPTUAL_HASH_SIZE * PERCEPTUAL_HASH_SIZE] = {};
+    for (int by = 0; by < PERCEPTUAL_HASH_SIZE; ++by) {
+        const int y0 = by * size / PERCEPTUAL_HASH_SIZE;
+        const int y1 = (by + 1) * size / PERCEPTUAL_HASH_SIZE;
+        for (int bx = 0; bx < PERCEPTUAL_HASH_SIZE; ++bx) {
+            const int x0 = bx * size / PERCEPTUAL_HASH_SIZE;
+            const int x1 = (bx + 1) * size / PERCEPTUAL_HASH_SIZE;
+            float sum = 0.0f;
+            for (int y = y0; y < y1; ++y) {
+                const uint8_t* row = rgb + (static_cast<size_t>(y) * static_cast<size_t>(size) + static_cast<size_t>(x0)) * 3;
+                for (int x = x0; x < x1; ++x, row += 3) {
+                    sum += computeLuma01(row[0], row[1], row[2]);
+                }
+            }
+            blockLuma[by * PERCEPTUAL_HASH_SIZE + bx] = sum / static_cast<float>((x1 - x0) * (y1 - y0));
+        }
+    }
+    return computePerceptualHash(blockLuma);
+}
+
+} // namespace ofxMarkSynth
@@ -0,0 +1,47 @@
+//
+//  DensityMetrics.hpp
+//  ofxMarkSynth
+//
+//  Luma statistics of the MemoryBank auto-capture analysis readback: variance, and the fraction
+//  of pixels further than an epsilon from the mean. The fast path converts to luma and sums luma and
+//  luma² (shifted by an early mean estimate) in one vectorized pass over the pixels (NEON, or
+//  SSSE3/F16C on x86), then counts active pixels over the luma it kept. The original two-pass scalar
+//  version is kept as a reference; tests/DensityMetricsTest.cpp checks both paths against it.
+//  The 64-bit average hash (8x8 block luma above/below its mean) lets auto-capture spot near-duplicates.
+//
+
+#pragma once
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+
+namespace ofxMarkSynth {
+
+struct DensityMetrics {
+    float variance { 0.0f };
+    float activeFraction { 0.0f };
+};
+
+/// Rec. 709 luma of tightly packed 8-bit RGB
+DensityMetrics computeDensityMetricsRgb8(const uint8_t* rgb, size_t pixelCount, float activeEpsilon);
+
+/// Rec. 709 luma of tightly packed half-float RGB (a GL_HALF_FLOAT readback)
+DensityMetrics computeDensityMetricsRgb16f(const uint16_t* rgb, size_t pixelCount, float activeEpsilon);
+
+/// Scalar reference for computeDensityMetricsRgb8 (two passes, double accumulation)
+DensityMetrics computeDensityMetricsRgb8Reference(const uint8_t* rgb, size_t pixelCount, float activeEpsilon);
+
+constexpr int PERCEPTUAL_HASH_SIZE = 8;
+
+/// Average hash of PERCEPTUAL_HASH_SIZE² block luma values (row-major): bit i is set when block i is
+/// brighter than the mean of all blocks.
+uint64_t computePerceptualHash(const float* blockLuma);
+
+/// Average hash of a square, tightly packed 8-bit RGB image of at least PERCEPTUAL_HASH_SIZE pixels a side
+uint64_t computePerceptualHashRgb8(const uint8_t* rgb, int size);
+
+/// Number of differing bits (0 for identical, 64 for inverted images)
+inline int getPerceptualHashDistance(uint64_t a, uint64_t b) { return std::popcount(a ^ b); }
+
+} // namespace ofxMarkSynth
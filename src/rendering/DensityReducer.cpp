@@ -0,0 +1,230 @@
+//
+//  DensityReducer.cpp
+//  ofxMarkSynth
+//
+
+#include "rendering/DensityReducer.hpp"
+#include "ofGraphics.h"
+#include "ofLog.h"
+#include "ofMesh.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+namespace ofxMarkSynth {
+
+// Readback layout: mean luma, mean luma², active fraction, then the 8x8 block luma for the hash
+static constexpr size_t METRICS_FLOATS = 3;
+static constexpr size_t HASH_FLOATS = PERCEPTUAL_HASH_SIZE * PERCEPTUAL_HASH_SIZE;
+static constexpr size_t READBACK_FLOATS = METRICS_FLOATS + HASH_FLOATS;
+static constexpr int HASH_LEVELS_BELOW_TOP = 3;  // 2^3 = PERCEPTUAL_HASH_SIZE
+
+// Tolerances against the CPU reference; the GPU sums in float down the mip chain.
+static constexpr float VALIDATION_VARIANCE_ABS = 1e-4f;
+static constexpr float VALIDATION_VARIANCE_REL = 1e-2f;
+static constexpr float VALIDATION_ACTIVE_FRACTION = 0.01f;
+static constexpr int VALIDATION_HASH_DISTANCE = 4;
+
+static void allocateTarget(ofFbo& fbo, int size, GLint internalFormat) {
+    ofFboSettings settings;
+    settings.width = size;
+    settings.height = size;
+    settings.internalformat = internalFormat;
+    settings.textureTarget = GL_TEXTURE_2D;
+    settings.useDepth = false;
+    settings.useStencil = false;
+    settings.minFilter = GL_NEAREST;
+    settings.maxFilter = GL_NEAREST;
+    fbo.allocate(settings);
+}
+
+static void generateMipmaps(const ofFbo& fbo) {
+    const GLuint textureId = fbo.getTexture().getTextureData().textureID;
+    glBindTexture(GL_TEXTURE_2D, textureId);
+    glGenerateMipmap(GL_TEXTURE_2D);
+    // Mipmap-complete, so texelFetch can read any level
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST_MIPMAP_NEAREST);
+    glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+static DensityMetrics toMetrics(const float* values) {
+    const float mean = values[0];
+    DensityMetrics out;
+    out.variance = std::max(0.0f, values[1] - mean * mean);
+    out.activeFraction = std::clamp(values[2], 0.0f, 1.0f);
+    return out;
+}
+
+bool DensityReducer::allocate(int size_, float activeEpsilon) {
+    release();
+
+    size_ = std::clamp(size_, MIN_SIZE, MAX_SIZE);
+    int powerOfTwo = MIN_SIZE;
+    while (powerOfTwo * 2 <= size_) powerOfTwo *= 2;
+
+    if (!shadersLoaded) {
+        momentsShader.load();
+        activeShader.load();
+        shadersLoaded = true;
+    }
+
+    size = powerOfTwo;
+    topLevel = static_cast<int>(std::log2(size));
+
+    allocateTarget(sourceFbo, size, GL_RGB8);
+    allocateTarget(momentsFbo, size, GL_RG32F);
+    allocateTarget(activeFbo, size, GL_R32F);
+    pbo.allocate(READBACK_FLOATS * sizeof(float), GL_STREAM_READ);
+
+    if (!sourceFbo.isAllocated() || !momentsFbo.isAllocated() || !activeFbo.isAllocated()) {
+        ofLogError("DensityReducer") << "Failed to allocate " << size << "x" << size << " reduction";
+        release();
+        return false;
+    }
+
+    if (!validate(activeEpsilon)) {
+        release();
+        return false;
+    }
+
+    // RG32F + R32F is 12 bytes a texel, like one RGB32F target; the mip chains add a third
+    const int mipScaledSize = static_cast<int>(std::ceil(size * std::sqrt(4.0f / 3.0f)));
+    memory = GpuMemoryRegistry::instance().add("DensityReducer", "reduction", mipScaledSize, mipScaledSize, GL_RGB32F, 1);
+    ofLogNotice("DensityReducer") << "Allocated " << size << "x" << size << " GPU density reduction";
+    return true;
+}
+
+void DensityReducer::release() {
+    memory = {};
+    sourceFbo.clear();
+    momentsFbo.clear();
+    activeFbo.clear();
+    pbo = ofBufferObject();
+    size = 0;
+    topLevel = 0;
+}
+
+void DensityReducer::reduce(const ofTexture& source, glm::vec2 cropTopLeft, glm::vec2 cropSize, float activeEpsilon) {
+    if (!isAllocated()) return;
+
+    drawSource(source, cropTopLeft, cropSize);
+    runReduction(activeEpsilon);
+
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, pbo.getId());
+    readTopLevels(nullptr);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+}
+
+DensityMetrics DensityReducer::readMetrics(uint64_t* perceptualHash) {
+    if (!isAllocated()) return {};
+
+    float values[READBACK_FLOATS] = {};
+    pbo.bind(GL_PIXEL_PACK_BUFFER);
+    const void* ptr = pbo.map(GL_READ_ONLY);
+    if (ptr) {
+        std::copy_n(static_cast<const float*>(ptr), READBACK_FLOATS, values);
+        pbo.unmap();
+    }
+    pbo.unbind(GL_PIXEL_PACK_BUFFER);
+    if (perceptualHash) *perceptualHash = computePerceptualHash(values + METRICS_FLOATS);
+    return toMetrics(values);
+}
+
+void DensityReducer::drawSource(const ofTexture& source, glm::vec2 cropTopLeft, glm::vec2 cropSize) {
+    sourceFbo.begin();
+    ofClear(0, 0, 0, 255);
+    ofPushStyle();
+    ofEnableBlendMode(OF_BLENDMODE_DISABLED);
+    ofSetColor(255);
+    source.drawSubsection(0, 0, static_cast<float>(size), static_cast<float>(size),
+                          cropTopLeft.x, cropTopLeft.y, cropSize.x, cropSize.y);
+    ofPopStyle();
+    sourceFbo.end();
+}
+
+void DensityReducer::runReduction(float activeEpsilon) {
+    ofPushStyle();
+    ofEnableBlendMode(OF_BLENDMODE_DISABLED);
+
+    momentsFbo.begin();
+    momentsShader.begin(sourceFbo.getTexture());
+    ofDrawRectangle(0, 0, size, size);
+    momentsShader.end();
+    momentsFbo.end();
+    generateMipmaps(momentsFbo);
+
+    activeFbo.begin();
+    activeShader.begin(momentsFbo.getTexture(), topLevel, activeEpsilon);
+    ofDrawRectangle(0, 0, size, size);
+    activeShader.end();
+    activeFbo.end();
+    generateMipmaps(activeFbo);
+
+    ofPopStyle();
+}
+
+void DensityReducer::readTopLevels(void* dst) {
+    const uintptr_t base = reinterpret_cast<uintptr_t>(dst);
+    glPixelStorei(GL_PACK_ALIGNMENT, 4);
+    glBindTexture(GL_TEXTURE_2D, momentsFbo.getTexture().getTextureData().textureID);
+    glGetTexImage(GL_TEXTURE_2D, topLevel, GL_RG, GL_FLOAT, reinterpret_cast<void*>(base));
+    glBindTexture(GL_TEXTURE_2D, activeFbo.getTexture().getTextureData().textureID);
+    glGetTexImage(GL_TEXTURE_2D, topLevel, GL_RED, GL_FLOAT, reinterpret_cast<void*>(base + 2 * sizeof(float)));
+    glBindTexture(GL_TEXTURE_2D, momentsFbo.getTexture().getTextureData().textureID);
+    glGetTexImage(GL_TEXTURE_2D, topLevel - HASH_LEVELS_BELOW_TOP, GL_RED, GL_FLOAT,
+                  reinterpret_cast<void*>(base + METRICS_FLOATS * sizeof(float)));
+    glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+bool DensityReducer::validate(float activeEpsilon) {
+    // A gradient exercising all three channels, with a flat band so some texels sit near the mean
+    const float s = static_cast<float>(size);
+    ofMesh gradient;
+    gradient.setMode(OF_PRIMITIVE_TRIANGLE_STRIP);
+    gradient.addVertex({ 0.0f, 0.0f, 0.0f });
+    gradient.addColor(ofFloatColor(0.0f, 0.0f, 1.0f));
+    gradient.addVertex({ s, 0.0f, 0.0f });
+    gradient.addColor(ofFloatColor(1.0f, 0.0f, 0.0f));
+    gradient.addVertex({ 0.0f, s, 0.0f });
+    gradient.addColor(ofFloatColor(0.0f, 1.0f, 0.0f));
+    gradient.addVertex({ s, s, 0.0f });
+    gradient.addColor(ofFloatColor(1.0f, 1.0f, 1.0f));
+
+    sourceFbo.begin();
+    ofClear(0, 0, 0, 255);
+    gradient.draw();
+    ofPushStyle();
+    ofSetColor(128);
+    ofDrawRectangle(0.0f, s * 0.25f, s, s * 0.25f);
+    ofPopStyle();
+    sourceFbo.end();
+    runReduction(activeEpsilon);
+
+    float values[READBACK_FLOATS] = {};
+    readTopLevels(values);
+    const DensityMetrics gpu = toMetrics(values);
+    const uint64_t gpuHash = computePerceptualHash(values + METRICS_FLOATS);
+
+    std::vector<uint8_t> rgb(static_cast<size_t>(size) * static_cast<size_t>(size) * 3);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    sourceFbo.bind();
+    glReadPixels(0, 0, size, size, GL_RGB, GL_UNSIGNED_BYTE, rgb.data());
+    sourceFbo.unbind();
+    const DensityMetrics cpu = computeDensityMetricsRgb8Reference(rgb.data(), static_cast<size_t>(size) * static_cast<size_t>(size), activeEpsilon);
+    const int hashDistance = getPerceptualHashDistance(gpuHash, computePerceptualHashRgb8(rgb.data(), size));
+
+    const bool varianceOk = std::abs(gpu.variance - cpu.variance) <= VALIDATION_VARIANCE_ABS + VALIDATION_VARIANCE_REL * cpu.variance;
+    const bool activeOk = std::abs(gpu.activeFraction - cpu.activeFraction) <= VALIDATION_ACTIVE_FRACTION;
+    const bool hashOk = hashDistance <= VALIDATION_HASH_DISTANCE;
+    if (!varianceOk || !activeOk || !hashOk) {
+        ofLogWarning("DensityReducer") << "GPU density reduction differs from the CPU reference (variance "
+                                       << gpu.variance << " vs " << cpu.variance << ", active "
+                                       << gpu.activeFraction << " vs " << cpu.activeFraction << ", hash distance "
+                                       << hashDistance << ")";
+        return false;
+    }
+    return true;
+}
+
+} // namespace ofxMarkSynth
@@ -0,0 +1,73 @@
+//
+//  DensityReducer.hpp
+//  ofxMarkSynth
+//
+//  GPU version of the DensityMetrics statistics. A crop of the composite is drawn into an RGB8
+//  source FBO, converted to luma/luma² and averaged down its mip chain; a second pass marks texels
+//  further than epsilon from that mean and is averaged the same way. Only the two top mip texels
+//  (three floats) and the 8x8 luma mip level for the perceptual hash are read back, through a PBO,
+//  so the crop can be analysed at a much higher resolution than a CPU readback allows.
+//
+
+#pragma once
+
+#include "rendering/DensityMetrics.hpp"
+#include "rendering/DensityReductionShader.h"
+#include "rendering/GpuMemoryRegistry.hpp"
+#include "ofBufferObject.h"
+#include "ofFbo.h"
+#include <cstdint>
+#include <glm/vec2.hpp>
+
+namespace ofxMarkSynth {
+
+class DensityReducer {
+public:
+    static constexpr int MIN_SIZE = 8;
+    static constexpr int MAX_SIZE = 2048;
+
+    DensityReducer() = default;
+
+    DensityReducer(const DensityReducer&) = delete;
+    DensityReducer& operator=(const DensityReducer&) = delete;
+
+    /// Allocate a square reduction of `size` (rounded down to a power of two so each mip level is an
+    /// exact 2x2 average), then check it once against computeDensityMetricsRgb8Reference().
+    /// @return false, leaving the reducer released, if allocation or validation fails
+    bool allocate(int size, float activeEpsilon);
+    void release();
+
+    bool isAllocated() const { return size > 0; }
+    int getSize() const { return size; }
+
+    /// Draw the crop of `source` and queue the reduction and its readback. Fence the GL stream after
+    /// this and call readMetrics() once the fence has signalled.
+    void reduce(const ofTexture& source, glm::vec2 cropTopLeft, glm::vec2 cropSize, float activeEpsilon);
+
+    /// Map the readback queued by the last reduce()
+    /// @param perceptualHash Set to the crop's computePerceptualHash() when not null
+    DensityMetrics readMetrics(uint64_t* perceptualHash = nullptr);
+
+private:
+    int size { 0 };
+    int topLevel { 0 };
+
+    ofFbo sourceFbo;   // RGB8, like the CPU analysis readback
+    ofFbo momentsFbo;  // RG32F luma, luma², mipmapped
+    ofFbo activeFbo;   // R32F active mask, mipmapped
+    ofBufferObject pbo;
+
+    LumaMomentsShader momentsShader;
+    ActiveFractionShader activeShader;
+    bool shadersLoaded { false };
+
+    GpuMemoryRegistry::Registration memory;
+
+    void drawSource(const ofTexture& source, glm::vec2 cropTopLeft, glm::vec2 cropSize);
+    void runReduction(float activeEpsilon);
+    /// Copy the top mip texels, then the hash mip level, into `dst` (a PBO offset when a pack buffer is bound)
+    void readTopLevels(void* dst);
+    bool validate(float activeEpsilon);
+};
+
+} // namespace ofxMarkSynth
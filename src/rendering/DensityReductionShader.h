@@ -0,0 +1,77 @@
+//
+//  DensityReductionShader.h
+//  ofxMarkSynth
+//
+//  The two passes of DensityReducer. LumaMomentsShader writes Rec. 709 luma and luma² into an RG32F
+//  target whose mip chain then averages them down to one texel (the mean and mean square).
+//  ActiveFractionShader reads that mean from the top mip level and writes 1 for texels further than
+//  epsilon from it, so the top mip of its own chain is the active fraction.
+//
+
+#pragma once
+
+#include "Shader.h"
+
+namespace ofxMarkSynth {
+
+class LumaMomentsShader : public ::Shader {
+
+public:
+  /// Draw a rectangle covering the whole target (the same size as rgbTexture) between begin() and end().
+  void begin(const ofTexture& rgbTexture) {
+    shader.begin();
+    shader.setUniformTexture("u_rgb", rgbTexture, 0);
+  }
+
+  void end() {
+    shader.end();
+  }
+
+  std::string getFragmentShader() override {
+    return GLSL(
+      uniform sampler2D u_rgb;
+
+      out vec4 fragColor;
+
+      void main() {
+        float y = dot(texelFetch(u_rgb, ivec2(gl_FragCoord.xy), 0).rgb, vec3(0.2126, 0.7152, 0.0722));
+        fragColor = vec4(y, y * y, 0.0, 1.0);
+      }
+    );
+  }
+};
+
+class ActiveFractionShader : public ::Shader {
+
+public:
+  /// @param momentsTexture LumaMomentsShader output with its mip chain generated
+  /// @param topLevel The 1x1 mip level of momentsTexture
+  void begin(const ofTexture& momentsTexture, int topLevel, float activeEpsilon) {
+    shader.begin();
+    shader.setUniformTexture("u_moments", momentsTexture, 0);
+    shader.setUniform1i("u_topLevel", topLevel);
+    shader.setUniform1f("u_activeEpsilon", activeEpsilon);
+  }
+
+  void end() {
+    shader.end();
+  }
+
+  std::string getFragmentShader() override {
+    return GLSL(
+      uniform sampler2D u_moments;
+      uniform int u_topLevel;
+      uniform float u_activeEpsilon;
+
+      out vec4 fragColor;
+
+      void main() {
+        float mean = texelFetch(u_moments, ivec2(0, 0), u_topLevel).r;
+        float y = texelFetch(u_moments, ivec2(gl_FragCoord.xy), 0).r;
+        fragColor = vec4(abs(y - mean) > u_activeEpsilon ? 1.0 : 0.0, 0.0, 0.0, 1.0);
+      }
+    );
+  }
+};
+
+} // namespace ofxMarkSynth
@@ -0,0 +1,92 @@
+//
+//  EncodeWorkerPool.cpp
+//  ofxMarkSynth
+//
+
+#include "rendering/EncodeWorkerPool.hpp"
+#include "ofLog.h"
+#include <algorithm>
+#include <exception>
+
+#ifdef __APPLE__
+#include <pthread.h>
+#include <pthread/qos.h>
+#elif defined(__linux__)
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace ofxMarkSynth {
+
+static void lowerCurrentThreadPriority() {
+#ifdef __APPLE__
+    // Keep encoding + disk I/O from starving the render thread.
+    pthread_set_qos_class_self_np(QOS_CLASS_BACKGROUND, 0);
+#elif defined(__linux__)
+    // Per-thread nice value (Linux applies setpriority to a single tid).
+    setpriority(PRIO_PROCESS, static_cast<id_t>(syscall(SYS_gettid)), 10);
+#endif
+}
+
+EncodeWorkerPool::EncodeWorkerPool(int threadCount) {
+    threadCount = std::max(1, threadCount);
+    workers.reserve(threadCount);
+    for (int i = 0; i < threadCount; ++i) {
+        workers.emplace_back([this] { workerLoop(); });
+    }
+}
+
+EncodeWorkerPool::~EncodeWorkerPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopRequested = true;
+    }
+    jobAvailable.notify_all();
+    for (auto& worker : workers) {
+        if (worker.joinable()) worker.join();
+    }
+}
+
+void EncodeWorkerPool::submit(const std::string& label, std::function<void()> job) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        jobs.push_back({ label, std::move(job) });
+        pendingCount++;
+    }
+    jobAvailable.notify_one();
+}
+
+void EncodeWorkerPool::waitIdle() {
+    std::unique_lock<std::mutex> lock(mutex);
+    idle.wait(lock, [this] { return pendingCount.load() == 0; });
+}
+
+void EncodeWorkerPool::workerLoop() {
+    lowerCurrentThreadPriority();
+
+    while (true) {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            jobAvailable.wait(lock, [this] { return stopRequested || !jobs.empty(); });
+            if (jobs.empty()) return; // stop requested and fully drained
+            job = std::move(jobs.front());
+            jobs.pop_front();
+        }
+
+        try {
+            job.run();
+        } catch (const std::exception& e) {
+            ofLogError("EncodeWorkerPool") << "Job '" << job.label << "' failed: " << e.what();
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            pendingCount--;
+        }
+        idle.notify_all();
+    }
+}
+
+} // namespace ofxMarkSynth
@@ -0,0 +1,63 @@
+//
+//  EncodeWorkerPool.hpp
+//  ofxMarkSynth
+//
+//  Fixed-size pool of low-priority worker threads for CPU-side image encoding and disk I/O
+//  (EXR snapshots, memory bank PNGs, thumbnails). Jobs run FIFO; the thread count bounds how
+//  much CPU they can take from the render thread, and no thread is created per job.
+//
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace ofxMarkSynth {
+
+class EncodeWorkerPool {
+public:
+    static constexpr int DEFAULT_THREAD_COUNT = 2;
+
+    explicit EncodeWorkerPool(int threadCount = DEFAULT_THREAD_COUNT);
+
+    /// Runs every queued job, then joins the workers.
+    ~EncodeWorkerPool();
+
+    EncodeWorkerPool(const EncodeWorkerPool&) = delete;
+    EncodeWorkerPool& operator=(const EncodeWorkerPool&) = delete;
+
+    /// Queue a job. `label` is only used for logging. Jobs must not touch GL.
+    void submit(const std::string& label, std::function<void()> job);
+
+    /// Block until every queued and running job has finished (for shutdown / flush).
+    void waitIdle();
+
+    /// Jobs queued or running
+    int getPendingCount() const { return pendingCount.load(); }
+
+    int getThreadCount() const { return static_cast<int>(workers.size()); }
+
+private:
+    struct Job {
+        std::string label;
+        std::function<void()> run;
+    };
+
+    std::vector<std::thread> workers;
+    mutable std::mutex mutex;
+    std::condition_variable jobAvailable;
+    std::condition_variable idle;
+    std::deque<Job> jobs;
+    std::atomic<int> pendingCount { 0 };
+    bool stopRequested { false };
+
+    void workerLoop();
+};
+
+} // namespace ofxMarkSynth
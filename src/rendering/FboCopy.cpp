@@ -99,5 +99,32 @@ void fboCopyBlit(const ofFbo& src, ofFbo& dst, bool copyDepth) {
   glDrawBuffer(prevDrawBuf);
 }
 
+void fboCopyBlitScaled(const ofFbo& src, ofFbo& dst) {
+  if (!src.isAllocated() || !dst.isAllocated()) return;
+
+  GLint prevReadFbo = 0, prevDrawFbo = 0, prevReadBuf = 0, prevDrawBuf = 0;
+  glGetIntegerv(GL_READ_FRAMEBUFFER_BINDING, &prevReadFbo);
+  glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &prevDrawFbo);
+  glGetIntegerv(GL_READ_BUFFER, &prevReadBuf);
+  glGetIntegerv(GL_DRAW_BUFFER, &prevDrawBuf);
+  GLboolean scissorEnabled = GL_FALSE;
+  glGetBooleanv(GL_SCISSOR_TEST, &scissorEnabled);
+  if (scissorEnabled) glDisable(GL_SCISSOR_TEST);
+
+  glBindFramebuffer(GL_READ_FRAMEBUFFER, src.getId());
+  glBindFramebuffer(GL_DRAW_FRAMEBUFFER, dst.getId());
+  glReadBuffer(GL_COLOR_ATTACHMENT0);
+  glDrawBuffer(GL_COLOR_ATTACHMENT0);
+  glBlitFramebuffer(0, 0, src.getWidth(), src.getHeight(),
+                    0, 0, dst.getWidth(), dst.getHeight(),
+                    GL_COLOR_BUFFER_BIT, GL_LINEAR);
+
+  if (scissorEnabled) glEnable(GL_SCISSOR_TEST);
+  glBindFramebuffer(GL_READ_FRAMEBUFFER, prevReadFbo);
+  glBindFramebuffer(GL_DRAW_FRAMEBUFFER, prevDrawFbo);
+  glReadBuffer(prevReadBuf);
+  glDrawBuffer(prevDrawBuf);
+}
+
 
 } // namespace ofxMarkSynth
@@ -24,5 +24,9 @@ void fboCopyDraw(const ofFbo& src, ofFbo& dst);
 // - Works on macOS OpenGL core profile (up to 4.1).
 void fboCopyBlit(const ofFbo& src, ofFbo& dst, bool copyDepth = false);
 
+// OpenGL blit into an already-allocated dst of any size (linear filtered resample).
+// - Color attachment 0 only; no draw call, no shader.
+void fboCopyBlitScaled(const ofFbo& src, ofFbo& dst);
+
 
 }
@@ -0,0 +1,284 @@
+//
+//  FramePipeEncoder.cpp
+//  ofxMarkSynth
+//
+
+#include "rendering/FramePipeEncoder.hpp"
+#include "rendering/RenderingConstants.h"
+#include "ofLog.h"
+#include "ofUtils.h"
+#include <algorithm>
+#include <cmath>
+#include <cerrno>
+#include <csignal>
+#include <pthread.h>
+#include <sstream>
+#include <unistd.h>
+
+namespace ofxMarkSynth {
+
+static bool isExecutable(const std::filesystem::path& path) {
+    return !path.empty() && std::filesystem::exists(path) && access(path.c_str(), X_OK) == 0;
+}
+
+FramePipeEncoder::~FramePipeEncoder() {
+    stop();
+}
+
+bool FramePipeEncoder::start(const std::filesystem::path& outputPath_, int width_, int height_, float fps,
+                             RecordingPixelFormat pixelFormat_, const std::filesystem::path& ffmpegPath, int poolSize) {
+    if (active) {
+        ofLogWarning("FramePipeEncoder") << "Already encoding to " << outputPath;
+        return false;
+    }
+
+    width = width_;
+    height = height_;
+    pixelFormat = pixelFormat_;
+    useFfmpeg = isExecutable(ffmpegPath);
+    outputPath = outputPath_;
+
+    if (useFfmpeg) {
+        // RGB24 is converted by ffmpeg, with the BT.709 matrix the GPU YUV path uses
+        const bool isRgb = pixelFormat == RecordingPixelFormat::RGB24;
+        std::ostringstream cmd;
+        cmd << "\"" << ffmpegPath.string() << "\" -y -loglevel error"
+            << " -f rawvideo -pix_fmt " << getFfmpegPixelFormat(pixelFormat)
+            << (isRgb ? "" : " -color_range tv -colorspace bt709")
+            << " -s " << width << "x" << height << " -r " << fps << " -i -"
+            << (isRgb ? " -vf scale=out_color_matrix=bt709:out_range=tv" : "")
+            << " -c:v " << LINUX_VIDEO_CODEC << " -preset " << LINUX_VIDEO_PRESET
+            << " -b:v " << DEFAULT_VIDEO_BITRATE << "k -pix_fmt yuv420p"
+            << " -color_range tv -colorspace bt709 -color_primaries bt709 -color_trc bt709"
+            << " \"" << outputPath.string() << "\"";
+        output = popen(cmd.str().c_str(), "w");
+        if (!output) {
+            ofLogError("FramePipeEncoder") << "Failed to start ffmpeg: " << cmd.str();
+            return false;
+        }
+    } else {
+        outputPath.replace_extension(".y4m");
+        ofLogWarning("FramePipeEncoder") << "ffmpeg not found at '" << ffmpegPath.string() << "'; writing " << outputPath;
+        output = std::fopen(outputPath.c_str(), "wb");
+        if (!output) {
+            ofLogError("FramePipeEncoder") << "Failed to open " << outputPath;
+            return false;
+        }
+        const int fpsMilli = static_cast<int>(std::lround(fps * 1000.0f));
+        const bool is420 = pixelFormat != RecordingPixelFormat::RGB24;
+        std::fprintf(output, "YUV4MPEG2 W%d H%d F%d:1000 Ip A1:1 %s\n", width, height, fpsMilli, is420 ? "C420mpeg2" : "C444");
+        yuvScratch.resize(getRecordingFrameByteSize(is420 ? RecordingPixelFormat::I420 : RecordingPixelFormat::RGB24, width, height));
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        freeFrames.clear();
+        queuedFrames.clear();
+        lastFrame.reset();
+        for (int i = 0; i < std::max(1, poolSize); ++i) {
+            freeFrames.push_back(std::make_unique<std::vector<uint8_t>>(getFrameByteSize()));
+        }
+        stopRequested = false;
+        pendingDuplicates = 0;
+        queueDepth = 0;
+        framesWritten = 0;
+        framesDuplicated = 0;
+        framesDropped = 0;
+        totalLatencyMicros = 0;
+        maxLatencyMicros = 0;
+    }
+
+    active = true;
+    startThread();
+    ofLogNotice("FramePipeEncoder") << "Encoding " << width << "x" << height << " to " << outputPath
+                                    << (useFfmpeg ? " (ffmpeg)" : " (y4m)");
+    return true;
+}
+
+void FramePipeEncoder::stop() {
+    if (!active) return;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopRequested = true;
+    }
+    queueCondition.notify_all();
+    waitForThread(false);   // The thread closes the output
+    active = false;
+
+    ofLogNotice("FramePipeEncoder") << "Finished " << outputPath << ": " << getFramesWritten() << " frames written, "
+                                    << getFramesDuplicated() << " duplicated, " << getFramesDropped() << " dropped";
+}
+
+FramePipeEncoder::FrameBuffer FramePipeEncoder::acquireFrame(std::chrono::milliseconds wait) {
+    std::unique_lock<std::mutex> lock(mutex);
+    if (freeFrames.empty() && wait.count() > 0) {
+        frameFreedCondition.wait_for(lock, wait, [this] { return !freeFrames.empty(); });
+    }
+    if (freeFrames.empty()) return nullptr;
+    FrameBuffer frame = std::move(freeFrames.front());
+    freeFrames.pop_front();
+    return frame;
+}
+
+void FramePipeEncoder::submitFrame(FrameBuffer frame) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        queuedFrames.push_back({ std::move(frame), Clock::now() });
+        queueDepth++;
+    }
+    queueCondition.notify_one();
+}
+
+void FramePipeEncoder::submitDuplicateFrame() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        // Each repeat is a full write; when the encoder is the bottleneck, don't let them pile up
+        if (pendingDuplicates >= MAX_PENDING_DUPLICATE_FRAMES) {
+            framesDropped++;
+            return;
+        }
+        pendingDuplicates++;
+        if (!queuedFrames.empty() && !queuedFrames.back().buffer) {
+            queuedFrames.back().repeats++;
+        } else {
+            queuedFrames.push_back({ nullptr, Clock::now(), 1 });
+        }
+        queueDepth++;
+    }
+    queueCondition.notify_one();
+}
+
+void FramePipeEncoder::noteDroppedFrame() {
+    framesDropped++;
+}
+
+double FramePipeEncoder::getMeanEncodeLatencyMs() const {
+    const uint64_t frames = framesWritten.load() + framesDuplicated.load();
+    if (frames == 0) return 0.0;
+    return totalLatencyMicros.load() / 1000.0 / static_cast<double>(frames);
+}
+
+void FramePipeEncoder::threadedFunction() {
+    // A dying ffmpeg must not take the app down: with SIGPIPE blocked on this thread, the only
+    // thread that writes to or closes the pipe, a write to it fails with EPIPE instead.
+    sigset_t sigpipeSet;
+    sigemptyset(&sigpipeSet);
+    sigaddset(&sigpipeSet, SIGPIPE);
+    pthread_sigmask(SIG_BLOCK, &sigpipeSet, nullptr);
+    pipeBroken = false;
+
+    while (true) {
+        QueuedFrame frame;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            queueCondition.wait(lock, [this] { return stopRequested || !queuedFrames.empty(); });
+            if (queuedFrames.empty()) break; // stop requested and fully drained
+            frame = std::move(queuedFrames.front());
+            queuedFrames.pop_front();
+            if (!frame.buffer) pendingDuplicates -= frame.repeats;
+            queueDepth -= frame.buffer ? 1 : frame.repeats;
+        }
+
+        const bool isDuplicate = !frame.buffer;
+        const std::vector<uint8_t>* data = isDuplicate ? lastFrame.get() : frame.buffer.get();
+        for (int i = 0; i < (isDuplicate ? frame.repeats : 1); ++i) {
+            if (data && writeFrame(*data)) {
+                (isDuplicate ? framesDuplicated : framesWritten)++;
+                const auto latency = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - frame.submitTime).count();
+                totalLatencyMicros += static_cast<uint64_t>(latency);
+                if (static_cast<uint64_t>(latency) > maxLatencyMicros.load()) maxLatencyMicros = static_cast<uint64_t>(latency);
+            } else {
+                framesDropped++;
+            }
+        }
+
+        if (isDuplicate) continue;
+
+        // Keep this frame back for repeats; the one it replaces goes back to the pool.
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (lastFrame) freeFrames.push_back(std::move(lastFrame));
+            lastFrame = std::move(frame.buffer);
+        }
+        frameFreedCondition.notify_one();
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (lastFrame) freeFrames.push_back(std::move(lastFrame));
+    }
+    frameFreedCondition.notify_all();
+
+    // Closing flushes buffered frames, so it happens here too, while SIGPIPE is blocked
+    closeOutput();
+    consumePendingSigpipe();
+}
+
+void FramePipeEncoder::consumePendingSigpipe() {
+    // A blocked SIGPIPE stays pending on this thread; take it so it can't be delivered later
+    sigset_t pending;
+    sigemptyset(&pending);
+    if (sigpending(&pending) != 0 || !sigismember(&pending, SIGPIPE)) return;
+    sigset_t sigpipeSet;
+    sigemptyset(&sigpipeSet);
+    sigaddset(&sigpipeSet, SIGPIPE);
+    int signal = 0;
+    sigwait(&sigpipeSet, &signal);
+}
+
+bool FramePipeEncoder::writeFrame(const std::vector<uint8_t>& frame) {
+    if (!output) return false;
+
+    if (useFfmpeg) {
+        if (pipeBroken) return false;
+        if (std::fwrite(frame.data(), 1, frame.size(), output) == frame.size()) return true;
+        if (errno == EPIPE) {
+            pipeBroken = true;
+            consumePendingSigpipe();
+            ofLogError("FramePipeEncoder") << "ffmpeg closed its input; dropping the rest of " << outputPath;
+        }
+        return false;
+    }
+
+    writeY4mFrame(frame);
+    return !std::ferror(output);
+}
+
+void FramePipeEncoder::writeY4mFrame(const std::vector<uint8_t>& frame) {
+    std::fputs("FRAME\n", output);
+
+    switch (pixelFormat) {
+        case RecordingPixelFormat::I420:
+            std::fwrite(frame.data(), 1, frame.size(), output);
+            return;
+
+        case RecordingPixelFormat::NV12:
+            convertNv12ToI420(frame.data(), width, height, yuvScratch.data());
+            std::fwrite(yuvScratch.data(), 1, yuvScratch.size(), output);
+            return;
+
+        case RecordingPixelFormat::RGB24:
+            break;
+    }
+
+    // BT.709 limited range like the GPU YUV path, 4:4:4 planar
+    convertRgbToYuv444(frame.data(), width, height, yuvScratch.data());
+    std::fwrite(yuvScratch.data(), 1, yuvScratch.size(), output);
+}
+
+void FramePipeEncoder::closeOutput() {
+    if (!output) return;
+
+    if (useFfmpeg) {
+        const int status = pclose(output);
+        if (status != 0) {
+            ofLogError("FramePipeEncoder") << "ffmpeg exited with status " << status << " for " << outputPath;
+        }
+    } else {
+        std::fclose(output);
+    }
+    output = nullptr;
+}
+
+} // namespace ofxMarkSynth
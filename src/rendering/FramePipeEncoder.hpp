@@ -0,0 +1,112 @@
+//
+//  FramePipeEncoder.hpp
+//  ofxMarkSynth
+//
+//  Encoder thread for recorded frames: pipes raw RGB24/I420/NV12 frames into a local ffmpeg
+//  process, or writes a .y4m file when ffmpeg isn't available. Frame buffers come from a fixed pool
+//  so the main thread never allocates; if the pool is empty the caller drops the frame, or waits
+//  for one (Block policy). The last written frame is kept back so it can be repeated on request.
+//
+
+#pragma once
+
+#include "ofThread.h"
+#include "rendering/YuvConversion.hpp"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <filesystem>
+#include <memory>
+#include <vector>
+
+namespace ofxMarkSynth {
+
+class FramePipeEncoder : public ofThread {
+public:
+    using FrameBuffer = std::unique_ptr<std::vector<uint8_t>>;
+
+    FramePipeEncoder() = default;
+    ~FramePipeEncoder();
+
+    /// Start encoding to outputPath (extension is replaced with .y4m when ffmpeg isn't found).
+    /// @param poolSize Number of in-flight frame buffers between the main thread and the encoder
+    bool start(const std::filesystem::path& outputPath, int width, int height, float fps,
+               RecordingPixelFormat pixelFormat, const std::filesystem::path& ffmpegPath, int poolSize);
+
+    /// Drain queued frames, close the output and join the thread.
+    void stop();
+
+    bool isActive() const { return active; }
+    const std::filesystem::path& getOutputPath() const { return outputPath; }
+    size_t getFrameByteSize() const { return getRecordingFrameByteSize(pixelFormat, width, height); }
+
+    /// Main thread: take a free frame buffer, or nullptr if the encoder is behind (caller drops the frame).
+    /// A non-zero `wait` blocks up to that long for a buffer to come back.
+    FrameBuffer acquireFrame(std::chrono::milliseconds wait = std::chrono::milliseconds(0));
+
+    /// Main thread: queue a filled buffer for encoding.
+    void submitFrame(FrameBuffer frame);
+
+    /// Main thread: queue a repeat of the previous frame (counted as dropped if nothing was written yet,
+    /// or if MAX_PENDING_DUPLICATE_FRAMES repeats are already waiting).
+    void submitDuplicateFrame();
+
+    /// Main thread: record a frame that was dropped before reaching the encoder.
+    void noteDroppedFrame();
+
+    uint64_t getFramesWritten() const { return framesWritten.load(); }
+    uint64_t getFramesDuplicated() const { return framesDuplicated.load(); }
+    uint64_t getFramesDropped() const { return framesDropped.load(); }
+
+    /// Frames (and repeats) waiting for the encoder thread
+    int getQueueDepth() const { return queueDepth.load(); }
+
+    double getMeanEncodeLatencyMs() const;
+    double getMaxEncodeLatencyMs() const { return maxLatencyMicros.load() / 1000.0; }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    /// A null buffer repeats the last written frame `repeats` times (consecutive repeats share an entry)
+    struct QueuedFrame {
+        FrameBuffer buffer;
+        Clock::time_point submitTime;
+        int repeats { 0 };
+    };
+
+    void threadedFunction() override;
+    bool writeFrame(const std::vector<uint8_t>& frame);
+    void writeY4mFrame(const std::vector<uint8_t>& frame);
+    void consumePendingSigpipe();
+    void closeOutput();
+
+    std::filesystem::path outputPath;
+    int width { 0 };
+    int height { 0 };
+    RecordingPixelFormat pixelFormat { RecordingPixelFormat::RGB24 };
+    bool useFfmpeg { false };
+    bool active { false };
+
+    FILE* output { nullptr };   // ffmpeg stdin pipe, or the y4m file
+    bool pipeBroken { false };  // Encoder thread only: ffmpeg exited, later frames are dropped
+    std::vector<uint8_t> yuvScratch;   // y4m only: RGB24 -> 4:4:4, or NV12 -> I420
+
+    std::condition_variable queueCondition;
+    std::condition_variable frameFreedCondition;
+    std::deque<FrameBuffer> freeFrames;
+    std::deque<QueuedFrame> queuedFrames;
+    FrameBuffer lastFrame;   // Encoder thread only; returned to freeFrames when the next frame is written
+    bool stopRequested { false };
+    int pendingDuplicates { 0 };
+    std::atomic<int> queueDepth { 0 };
+    std::atomic<uint64_t> framesWritten { 0 };
+    std::atomic<uint64_t> framesDuplicated { 0 };
+    std::atomic<uint64_t> framesDropped { 0 };
+    std::atomic<uint64_t> totalLatencyMicros { 0 };
+    std::atomic<uint64_t> maxLatencyMicros { 0 };
+};
+
+} // namespace ofxMarkSynth
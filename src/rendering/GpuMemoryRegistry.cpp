@@ -0,0 +1,251 @@
+//
+//  GpuMemoryRegistry.cpp
+//  ofxMarkSynth
+//
+
+#include "rendering/GpuMemoryRegistry.hpp"
+
+#include "ofLog.h"
+#include "ofUtils.h"
+#include "nlohmann/json.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+
+namespace ofxMarkSynth {
+
+namespace {
+
+constexpr double BYTES_PER_MB = 1024.0 * 1024.0;
+
+double toMB(size_t bytes) {
+    return static_cast<double>(bytes) / BYTES_PER_MB;
+}
+
+} // namespace
+
+GpuMemoryRegistry::Registration& GpuMemoryRegistry::Registration::operator=(Registration&& other) noexcept {
+    if (this != &other) {
+        release();
+        id = other.id;
+        other.id = 0;
+    }
+    return *this;
+}
+
+void GpuMemoryRegistry::Registration::release() {
+    if (id == 0) return;
+    GpuMemoryRegistry::instance().remove(id);
+    id = 0;
+}
+
+GpuMemoryRegistry& GpuMemoryRegistry::instance() {
+    static GpuMemoryRegistry registry;
+    return registry;
+}
+
+void GpuMemoryRegistry::setBudget(size_t budgetBytes_, BudgetPolicy policy_) {
+    std::lock_guard<std::mutex> lock(mutex);
+    budgetBytes = budgetBytes_;
+    policy = policy_;
+}
+
+size_t GpuMemoryRegistry::getBudgetBytes() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return budgetBytes;
+}
+
+GpuMemoryRegistry::BudgetPolicy GpuMemoryRegistry::getBudgetPolicy() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return policy;
+}
+
+float GpuMemoryRegistry::admit(const std::string& owner, const std::string& label, size_t bytes, bool essential) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (budgetBytes == 0 || totalBytes + bytes <= budgetBytes) return 1.0f;
+
+    const size_t remaining = budgetBytes > totalBytes ? budgetBytes - totalBytes : 0;
+    const std::string what = owner + "/" + label;
+
+    switch (policy) {
+        case BudgetPolicy::Warn:
+            ofLogWarning("GpuMemoryRegistry") << what << " (" << toMB(bytes) << " MB) exceeds budget: "
+                                              << toMB(totalBytes) << " of " << toMB(budgetBytes) << " MB in use";
+            return 1.0f;
+
+        case BudgetPolicy::Downscale: {
+            // Bytes scale with area, so the linear scale is the square root of the byte ratio
+            float scale = std::sqrt(static_cast<float>(remaining) / static_cast<float>(bytes));
+            if (scale >= MIN_DOWNSCALE) {
+                ofLogWarning("GpuMemoryRegistry") << what << " downscaled by " << scale << " to fit budget";
+                return scale;
+            }
+            if (essential) {
+                ofLogError("GpuMemoryRegistry") << what << " over budget even at minimum scale; allocating at " << MIN_DOWNSCALE;
+                return MIN_DOWNSCALE;
+            }
+            ofLogWarning("GpuMemoryRegistry") << what << " refused: over budget even at minimum scale";
+            return 0.0f;
+        }
+
+        case BudgetPolicy::Refuse:
+            if (essential) {
+                ofLogError("GpuMemoryRegistry") << what << " (" << toMB(bytes) << " MB) exceeds budget but is required";
+                return 1.0f;
+            }
+            ofLogWarning("GpuMemoryRegistry") << what << " (" << toMB(bytes) << " MB) refused: over budget";
+            return 0.0f;
+    }
+    return 1.0f;
+}
+
+GpuMemoryRegistry::Registration GpuMemoryRegistry::add(const std::string& owner, const std::string& label,
+                                                       int width, int height, GLint internalFormat, int copies, int depth) {
+    Allocation allocation;
+    allocation.owner = owner;
+    allocation.label = label;
+    allocation.width = width;
+    allocation.height = height;
+    allocation.depth = depth;
+    allocation.internalFormat = internalFormat;
+    allocation.copies = copies;
+    allocation.bytes = estimateBytes(width, height, internalFormat, copies, depth);
+
+    std::lock_guard<std::mutex> lock(mutex);
+    allocation.id = nextId++;
+    totalBytes += allocation.bytes;
+    const uint64_t id = allocation.id;
+    allocations.emplace(id, std::move(allocation));
+    return Registration(id);
+}
+
+GpuMemoryRegistry::Registration GpuMemoryRegistry::addFbo(const std::string& owner, const std::string& label,
+                                                          const ofFbo& fbo, int copies) {
+    if (!fbo.isAllocated()) return Registration();
+    const auto& textureData = fbo.getTexture().getTextureData();
+    return add(owner, label, static_cast<int>(fbo.getWidth()), static_cast<int>(fbo.getHeight()),
+               textureData.glInternalFormat, copies);
+}
+
+void GpuMemoryRegistry::remove(uint64_t id) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = allocations.find(id);
+    if (it == allocations.end()) return;
+    totalBytes -= std::min(totalBytes, it->second.bytes);
+    allocations.erase(it);
+}
+
+size_t GpuMemoryRegistry::getTotalBytes() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return totalBytes;
+}
+
+std::vector<GpuMemoryRegistry::Allocation> GpuMemoryRegistry::getAllocations() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    std::vector<Allocation> result;
+    result.reserve(allocations.size());
+    for (const auto& [id, allocation] : allocations) {
+        result.push_back(allocation);
+    }
+    std::sort(result.begin(), result.end(), [](const Allocation& a, const Allocation& b) {
+        return a.bytes > b.bytes;
+    });
+    return result;
+}
+
+std::map<std::string, size_t> GpuMemoryRegistry::getBytesByOwner() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    std::map<std::string, size_t> result;
+    for (const auto& [id, allocation] : allocations) {
+        result[allocation.owner] += allocation.bytes;
+    }
+    return result;
+}
+
+void GpuMemoryRegistry::logSummary() const {
+    const size_t budget = getBudgetBytes();
+    ofLogNotice("GpuMemoryRegistry") << "Total " << toMB(getTotalBytes()) << " MB"
+                                     << (budget > 0 ? " of " + ofToString(toMB(budget), 1) + " MB budget" : "");
+    for (const auto& [owner, bytes] : getBytesByOwner()) {
+        ofLogNotice("GpuMemoryRegistry") << "  " << owner << ": " << toMB(bytes) << " MB";
+    }
+}
+
+bool GpuMemoryRegistry::exportJson(const std::filesystem::path& path) const {
+    nlohmann::ordered_json j;
+    j["totalBytes"] = getTotalBytes();
+    j["budgetBytes"] = getBudgetBytes();
+    j["allocations"] = nlohmann::ordered_json::array();
+    for (const auto& allocation : getAllocations()) {
+        j["allocations"].push_back({
+            { "owner", allocation.owner },
+            { "label", allocation.label },
+            { "width", allocation.width },
+            { "height", allocation.height },
+            { "depth", allocation.depth },
+            { "format", formatName(allocation.internalFormat) },
+            { "copies", allocation.copies },
+            { "bytes", allocation.bytes }
+        });
+    }
+
+    std::ofstream out(path);
+    if (!out.is_open()) {
+        ofLogError("GpuMemoryRegistry") << "exportJson: failed to open " << path;
+        return false;
+    }
+    out << j.dump(2);
+    return true;
+}
+
+size_t GpuMemoryRegistry::bytesPerTexel(GLint internalFormat) {
+    switch (internalFormat) {
+        case GL_R8: return 1;
+        case GL_RG8: return 2;
+        case GL_RGB8:
+        case GL_RGBA8:
+        case GL_RGB:
+        case GL_RGBA: return 4;
+        case GL_R16F: return 2;
+        case GL_RG16F: return 4;
+        case GL_RGB16F:
+        case GL_RGBA16F: return 8;
+        case GL_R32F: return 4;
+        case GL_RG32F: return 8;
+        case GL_RGB32F:
+        case GL_RGBA32F: return 16;
+        case GL_DEPTH_COMPONENT24:
+        case GL_DEPTH24_STENCIL8:
+        case GL_DEPTH_COMPONENT32F: return 4;
+        default: return 4;
+    }
+}
+
+size_t GpuMemoryRegistry::estimateBytes(int width, int height, GLint internalFormat, int copies, int depth) {
+    return static_cast<size_t>(std::max(0, width)) * static_cast<size_t>(std::max(0, height))
+        * static_cast<size_t>(std::max(1, depth)) * static_cast<size_t>(std::max(1, copies))
+        * bytesPerTexel(internalFormat);
+}
+
+std::string GpuMemoryRegistry::formatName(GLint internalFormat) {
+    switch (internalFormat) {
+        case GL_R8: return "R8";
+        case GL_RG8: return "RG8";
+        case GL_RGB8: return "RGB8";
+        case GL_RGBA8: return "RGBA8";
+        case GL_RGB: return "RGB";
+        case GL_RGBA: return "RGBA";
+        case GL_R16F: return "R16F";
+        case GL_RG16F: return "RG16F";
+        case GL_RGB16F: return "RGB16F";
+        case GL_RGBA16F: return "RGBA16F";
+        case GL_R32F: return "R32F";
+        case GL_RG32F: return "RG32F";
+        case GL_RGB32F: return "RGB32F";
+        case GL_RGBA32F: return "RGBA32F";
+        default: return ofToString(internalFormat);
+    }
+}
+
+} // namespace ofxMarkSynth
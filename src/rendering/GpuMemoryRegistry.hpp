@@ -0,0 +1,104 @@
+//
+//  GpuMemoryRegistry.hpp
+//  ofxMarkSynth
+//
+//  Process-wide accounting of FBO/texture allocations (owner, label, size, format, estimated
+//  bytes) with an optional VRAM budget. Owners ask admit() before allocating and keep the
+//  returned Registration alive as long as the GPU resource; it unregisters on destruction.
+//
+
+#pragma once
+
+#include "ofGLUtils.h"
+#include "ofFbo.h"
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace ofxMarkSynth {
+
+class GpuMemoryRegistry {
+public:
+    enum class BudgetPolicy {
+        Warn,       // Allocate anyway, log once per over-budget allocation
+        Downscale,  // Shrink allocations (down to MIN_DOWNSCALE) to fit; refuse optional ones that still don't fit
+        Refuse      // Refuse optional allocations that don't fit; essential ones are allocated with an error
+    };
+
+    static constexpr float MIN_DOWNSCALE = 0.25f;
+
+    struct Allocation {
+        uint64_t id { 0 };
+        std::string owner;
+        std::string label;
+        int width { 0 };
+        int height { 0 };
+        int depth { 1 };
+        GLint internalFormat { 0 };
+        int copies { 1 };          // e.g. 2 for a PingPongFbo
+        size_t bytes { 0 };
+    };
+
+    /// Move-only handle that unregisters its allocation when destroyed or reassigned.
+    class Registration {
+    public:
+        Registration() = default;
+        ~Registration() { release(); }
+        Registration(const Registration&) = delete;
+        Registration& operator=(const Registration&) = delete;
+        Registration(Registration&& other) noexcept : id(other.id) { other.id = 0; }
+        Registration& operator=(Registration&& other) noexcept;
+
+        void release();
+        bool isValid() const { return id != 0; }
+
+    private:
+        friend class GpuMemoryRegistry;
+        explicit Registration(uint64_t id_) : id(id_) {}
+        uint64_t id { 0 };
+    };
+
+    static GpuMemoryRegistry& instance();
+
+    /// 0 disables the budget.
+    void setBudget(size_t budgetBytes_, BudgetPolicy policy_);
+    size_t getBudgetBytes() const;
+    BudgetPolicy getBudgetPolicy() const;
+
+    /// Scale factor (applied to width and height) for a planned allocation of `bytes`:
+    /// 1 when it fits or no budget is set, < 1 to downscale, 0 to refuse.
+    /// Essential allocations (the Synth cannot run without them) are never refused.
+    float admit(const std::string& owner, const std::string& label, size_t bytes, bool essential);
+
+    Registration add(const std::string& owner, const std::string& label,
+                     int width, int height, GLint internalFormat, int copies = 1, int depth = 1);
+    Registration addFbo(const std::string& owner, const std::string& label, const ofFbo& fbo, int copies = 1);
+
+    size_t getTotalBytes() const;
+    std::vector<Allocation> getAllocations() const;
+    std::map<std::string, size_t> getBytesByOwner() const;
+
+    void logSummary() const;
+    bool exportJson(const std::filesystem::path& path) const;
+
+    /// Estimated bytes per texel. RGB formats count as RGBA, as drivers pad them.
+    static size_t bytesPerTexel(GLint internalFormat);
+    static size_t estimateBytes(int width, int height, GLint internalFormat, int copies = 1, int depth = 1);
+    static std::string formatName(GLint internalFormat);
+
+private:
+    GpuMemoryRegistry() = default;
+    void remove(uint64_t id);
+
+    mutable std::mutex mutex;
+    std::map<uint64_t, Allocation> allocations;
+    uint64_t nextId { 1 };
+    size_t totalBytes { 0 };
+    size_t budgetBytes { 0 };
+    BudgetPolicy policy { BudgetPolicy::Warn };
+};
+
+} // namespace ofxMarkSynth
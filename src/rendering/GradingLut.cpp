@@ -0,0 +1,172 @@
+//
+//  GradingLut.cpp
+//  ofxMarkSynth
+//
+
+#include "rendering/GradingLut.hpp"
+
+#include "ofLog.h"
+#include "glm/glm.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace ofxMarkSynth {
+
+namespace {
+
+// Clamps in the chain put kinks inside LUT cells; a few 8-bit steps there is expected.
+constexpr float VALIDATION_WARN_ERROR = 4.0f / 255.0f;
+
+glm::vec3 adjustSaturation(glm::vec3 color, float saturation) {
+    float gray = glm::dot(color, glm::vec3 { 0.299f, 0.587f, 0.114f });
+    return glm::mix(glm::vec3 { gray }, color, saturation);
+}
+
+glm::vec3 adjustBrightness(glm::vec3 color, float brightness) {
+    return glm::clamp(color + brightness, 0.0f, 1.0f);
+}
+
+glm::vec3 adjustHue(glm::vec3 color, float hue) {
+    float angle = hue * 6.2831853f;
+    float cosA = std::cos(angle);
+    float sinA = std::sin(angle);
+    // Column-major, as GLSL mat3(vec3, vec3, vec3)
+    glm::mat3 rot {
+        glm::vec3 { 0.299f + 0.701f * cosA + 0.168f * sinA, 0.587f - 0.587f * cosA + 0.330f * sinA, 0.114f - 0.114f * cosA - 0.497f * sinA },
+        glm::vec3 { 0.299f - 0.299f * cosA - 0.328f * sinA, 0.587f + 0.413f * cosA + 0.035f * sinA, 0.114f - 0.114f * cosA + 0.292f * sinA },
+        glm::vec3 { 0.299f - 0.3f * cosA + 1.25f * sinA,    0.587f - 0.588f * cosA - 1.05f * sinA, 0.114f + 0.886f * cosA - 0.203f * sinA }
+    };
+    return glm::clamp(rot * color, 0.0f, 1.0f);
+}
+
+} // anonymous namespace
+
+GradingLut::~GradingLut() {
+    if (textureId != 0) {
+        glDeleteTextures(1, &textureId);
+        textureId = 0;
+    }
+}
+
+glm::vec3 GradingLut::gradeBakedReference(glm::vec3 ldrColor, const DisplayController::Settings& display) {
+    glm::vec3 c = (ldrColor - 0.5f) * display.contrast + 0.5f;
+    c = adjustSaturation(c, display.saturation);
+    c = adjustBrightness(c, display.brightness);
+    return adjustHue(c, display.hueShift);
+}
+
+glm::vec3 GradingLut::gradeReference(glm::vec3 ldrColor, const DisplayController::Settings& display) {
+    return glm::pow(gradeBakedReference(ldrColor, display), glm::vec3 { 1.0f / display.gamma });
+}
+
+bool GradingLut::gradingEquals(const DisplayController::Settings& a, const DisplayController::Settings& b) {
+    // Tonemap type, exposure and white point are applied before the LUT, gamma after it.
+    return a.contrast == b.contrast &&
+           a.saturation == b.saturation &&
+           a.brightness == b.brightness &&
+           a.hueShift == b.hueShift;
+}
+
+void GradingLut::update(const DisplayController::Settings& display) {
+    if (hasCachedSettings && textureId != 0 && gradingEquals(display, cachedSettings)) return;
+
+    generate(display);
+    upload();
+    cachedSettings = display;
+    hasCachedSettings = true;
+
+    // validate() samples the whole cube, so only run it when the message will be shown
+    if (ofGetLogLevel("GradingLut") <= OF_LOG_VERBOSE) {
+        ofLogVerbose("GradingLut") << "Regenerated grading LUT; max interpolation error " << validate();
+    }
+}
+
+void GradingLut::generate(const DisplayController::Settings& display) {
+    constexpr int N = LUT_SIZE;
+    constexpr float STEP = 1.0f / static_cast<float>(N - 1);
+    lutData.resize(static_cast<size_t>(N * N * N * 3));
+
+    size_t i = 0;
+    for (int b = 0; b < N; ++b) {
+        for (int g = 0; g < N; ++g) {
+            for (int r = 0; r < N; ++r) {
+                glm::vec3 graded = gradeBakedReference({ r * STEP, g * STEP, b * STEP }, display);
+                lutData[i++] = graded.r;
+                lutData[i++] = graded.g;
+                lutData[i++] = graded.b;
+            }
+        }
+    }
+}
+
+void GradingLut::upload() {
+    constexpr int N = LUT_SIZE;
+    const bool isNew = (textureId == 0);
+    if (isNew) {
+        glGenTextures(1, &textureId);
+    }
+
+    GLint prevTexture = 0;
+    glGetIntegerv(GL_TEXTURE_BINDING_3D, &prevTexture);
+    glBindTexture(GL_TEXTURE_3D, textureId);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
+    if (isNew) {
+        glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
+        glTexImage3D(GL_TEXTURE_3D, 0, GL_RGB16F, N, N, N, 0, GL_RGB, GL_FLOAT, lutData.data());
+        textureMemory = GpuMemoryRegistry::instance().add("CompositeRenderer", "grading LUT", N, N, GL_RGB16F, 1, N);
+    } else {
+        glTexSubImage3D(GL_TEXTURE_3D, 0, 0, 0, 0, N, N, N, GL_RGB, GL_FLOAT, lutData.data());
+    }
+
+    glBindTexture(GL_TEXTURE_3D, static_cast<GLuint>(prevTexture));
+}
+
+glm::vec3 GradingLut::sample(glm::vec3 ldrColor) const {
+    constexpr int N = LUT_SIZE;
+    if (lutData.empty()) return ldrColor;
+
+    glm::vec3 p = glm::clamp(ldrColor, 0.0f, 1.0f) * static_cast<float>(N - 1);
+    glm::ivec3 i0 = glm::min(glm::ivec3(glm::floor(p)), glm::ivec3(N - 2));
+    glm::vec3 f = p - glm::vec3(i0);
+
+    auto at = [this](int r, int g, int b) {
+        const size_t idx = static_cast<size_t>(((b * N + g) * N + r) * 3);
+        return glm::vec3 { lutData[idx], lutData[idx + 1], lutData[idx + 2] };
+    };
+
+    glm::vec3 c00 = glm::mix(at(i0.x, i0.y, i0.z),         at(i0.x + 1, i0.y, i0.z),         f.x);
+    glm::vec3 c10 = glm::mix(at(i0.x, i0.y + 1, i0.z),     at(i0.x + 1, i0.y + 1, i0.z),     f.x);
+    glm::vec3 c01 = glm::mix(at(i0.x, i0.y, i0.z + 1),     at(i0.x + 1, i0.y, i0.z + 1),     f.x);
+    glm::vec3 c11 = glm::mix(at(i0.x, i0.y + 1, i0.z + 1), at(i0.x + 1, i0.y + 1, i0.z + 1), f.x);
+    return glm::mix(glm::mix(c00, c10, f.y), glm::mix(c01, c11, f.y), f.z);
+}
+
+float GradingLut::validate(int samplesPerAxis) const {
+    if (!hasCachedSettings || lutData.empty() || samplesPerAxis < 1) return 0.0f;
+
+    float maxError = 0.0f;
+    const float step = 1.0f / static_cast<float>(samplesPerAxis);
+    for (int b = 0; b < samplesPerAxis; ++b) {
+        for (int g = 0; g < samplesPerAxis; ++g) {
+            for (int r = 0; r < samplesPerAxis; ++r) {
+                glm::vec3 c { (r + 0.5f) * step, (g + 0.5f) * step, (b + 0.5f) * step };
+                glm::vec3 lut = glm::pow(sample(c), glm::vec3 { 1.0f / cachedSettings.gamma });
+                glm::vec3 diff = glm::abs(lut - gradeReference(c, cachedSettings));
+                maxError = std::max({ maxError, diff.r, diff.g, diff.b });
+            }
+        }
+    }
+
+    if (maxError > VALIDATION_WARN_ERROR) {
+        ofLogWarning("GradingLut") << "LUT interpolation error " << maxError << " exceeds " << VALIDATION_WARN_ERROR;
+    }
+    return maxError;
+}
+
+} // namespace ofxMarkSynth
@@ -0,0 +1,62 @@
+//
+//  GradingLut.hpp
+//  ofxMarkSynth
+//
+//  Post-tonemap display grading (contrast, saturation, brightness, hue shift)
+//  baked into a small 3D LUT so output shading is a single texture fetch.
+//  Gamma stays a per-pixel pow() after the fetch: pow(x, 1/gamma) is too steep near
+//  black for trilinear interpolation, while the rest of the chain is piecewise affine.
+//
+
+#pragma once
+
+#include "controller/DisplayController.hpp"
+#include "rendering/GpuMemoryRegistry.hpp"
+#include "ofGLUtils.h"
+#include "glm/vec3.hpp"
+#include <vector>
+
+namespace ofxMarkSynth {
+
+class GradingLut {
+public:
+    static constexpr int LUT_SIZE = 33;
+
+    GradingLut() = default;
+    ~GradingLut();
+    GradingLut(const GradingLut&) = delete;
+    GradingLut& operator=(const GradingLut&) = delete;
+
+    /// Regenerate (CPU) and re-upload the LUT if any grading setting changed. Cheap when unchanged.
+    void update(const DisplayController::Settings& display);
+
+    GLuint getTextureId() const { return textureId; }
+    bool isAllocated() const { return textureId != 0; }
+
+    /// CPU reference of the full grading chain (including gamma), matching the original
+    /// per-pixel shader. Input is the tonemapped LDR colour.
+    static glm::vec3 gradeReference(glm::vec3 ldrColor, const DisplayController::Settings& display);
+
+    /// The part of gradeReference() that is baked into the LUT (everything before gamma).
+    static glm::vec3 gradeBakedReference(glm::vec3 ldrColor, const DisplayController::Settings& display);
+
+    /// Trilinear lookup into the CPU copy of the LUT (what the GPU sampler does), before gamma.
+    glm::vec3 sample(glm::vec3 ldrColor) const;
+
+    /// Max abs error of LUT + gamma against gradeReference() over a regular grid
+    /// offset from the LUT lattice (worst case for interpolation).
+    float validate(int samplesPerAxis = 16) const;
+
+private:
+    static bool gradingEquals(const DisplayController::Settings& a, const DisplayController::Settings& b);
+    void generate(const DisplayController::Settings& display);
+    void upload();
+
+    GLuint textureId { 0 };
+    GpuMemoryRegistry::Registration textureMemory;
+    std::vector<float> lutData; // RGB, r fastest
+    DisplayController::Settings cachedSettings {};
+    bool hasCachedSettings { false };
+};
+
+} // namespace ofxMarkSynth
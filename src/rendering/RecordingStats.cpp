@@ -0,0 +1,56 @@
+//
+//  RecordingStats.cpp
+//  ofxMarkSynth
+//
+
+#include "rendering/RecordingStats.hpp"
+#include "ofJson.h"
+#include "ofLog.h"
+#include <cctype>
+
+namespace ofxMarkSynth {
+
+std::optional<RecordingBackpressurePolicy> parseRecordingBackpressurePolicy(const std::string& name) {
+    std::string s;
+    for (char c : name) s.push_back(static_cast<char>(std::tolower(static_cast<unsigned char>(c))));
+
+    if (s == "drop") return RecordingBackpressurePolicy::Drop;
+    if (s == "block") return RecordingBackpressurePolicy::Block;
+    if (s == "duplicate" || s == "dup") return RecordingBackpressurePolicy::Duplicate;
+    return std::nullopt;
+}
+
+const char* getRecordingBackpressurePolicyName(RecordingBackpressurePolicy policy) {
+    switch (policy) {
+        case RecordingBackpressurePolicy::Drop: return "drop";
+        case RecordingBackpressurePolicy::Block: return "block";
+        case RecordingBackpressurePolicy::Duplicate: return "duplicate";
+    }
+    return "drop";
+}
+
+bool RecordingStats::writeSidecar(const std::filesystem::path& path, const std::filesystem::path& videoPath) const {
+    ofJson j;
+    j["video"] = videoPath.filename().string();
+    j["policy"] = getRecordingBackpressurePolicyName(policy);
+    j["durationSec"] = durationSec;
+    j["framesCaptured"] = framesCaptured;
+    j["framesWritten"] = framesWritten;
+    j["framesDuplicated"] = framesDuplicated;
+    j["framesDropped"] = framesDropped;
+    j["framesBlocked"] = framesBlocked;
+    j["blockedMs"] = blockedMs;
+    j["maxQueueDepth"] = maxQueueDepth;
+    j["meanEncodeLatencyMs"] = meanEncodeLatencyMs;
+    j["maxEncodeLatencyMs"] = maxEncodeLatencyMs;
+
+    if (!ofSavePrettyJson(path, j)) {
+        ofLogError("RecordingStats") << "Failed to write " << path;
+        return false;
+    }
+    ofLogNotice("RecordingStats") << "Take stats: " << framesWritten << " written, " << framesDuplicated << " duplicated, "
+                                  << framesDropped << " dropped of " << framesCaptured << " (" << path.filename().string() << ")";
+    return true;
+}
+
+} // namespace ofxMarkSynth
@@ -0,0 +1,56 @@
+//
+//  RecordingStats.hpp
+//  ofxMarkSynth
+//
+//  What a recorder does when the encoder can't keep up, and per-take accounting of how often it
+//  happened: queue depth, encode latency and dropped/duplicated/blocked frames. Written next to
+//  each take as a JSON sidecar.
+//
+
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string>
+
+namespace ofxMarkSynth {
+
+enum class RecordingBackpressurePolicy {
+    Drop,        // Lose the frame; the take gets shorter than wall-clock time
+    Block,       // Stall the render loop until a readback or encoder buffer frees up
+    Duplicate    // Repeat the previous frame in its place, keeping the take in step with the audio
+};
+
+std::optional<RecordingBackpressurePolicy> parseRecordingBackpressurePolicy(const std::string& name);
+const char* getRecordingBackpressurePolicyName(RecordingBackpressurePolicy policy);
+
+struct RecordingStats {
+    RecordingBackpressurePolicy policy { RecordingBackpressurePolicy::Drop };
+
+    /// Every frame offered to the recorder. Once a take has stopped,
+    /// framesCaptured == framesWritten + framesDuplicated + framesDropped.
+    uint64_t framesCaptured { 0 };
+    uint64_t framesWritten { 0 };
+    uint64_t framesDuplicated { 0 };
+    uint64_t framesDropped { 0 };
+
+    /// Frames where the render loop waited (Block policy), and the total wait
+    uint64_t framesBlocked { 0 };
+    double blockedMs { 0.0 };
+
+    /// Readbacks in flight plus frames waiting for the encoder
+    int queueDepth { 0 };
+    int maxQueueDepth { 0 };
+
+    /// From handing a frame to the encoder until it's written out
+    double meanEncodeLatencyMs { 0.0 };
+    double maxEncodeLatencyMs { 0.0 };
+
+    double durationSec { 0.0 };
+
+    /// Write as JSON (alongside the video's path) to `path`.
+    bool writeSidecar(const std::filesystem::path& path, const std::filesystem::path& videoPath) const;
+};
+
+} // namespace ofxMarkSynth
@@ -14,6 +14,16 @@ constexpr float DEFAULT_VIDEO_FPS = 30.0f;
 constexpr int DEFAULT_VIDEO_BITRATE = 8000;
 constexpr const char* DEFAULT_VIDEO_CODEC = "h264_videotoolbox";
 
+// Video recording (Linux: ffmpeg pipe fed from a PBO ring)
+constexpr const char* LINUX_VIDEO_CODEC = "libx264";
+constexpr const char* LINUX_VIDEO_PRESET = "veryfast";
+constexpr int DEFAULT_RECORDER_PBO_COUNT = 4;
+constexpr int MIN_RECORDER_PBO_COUNT = 3;
+constexpr int MAX_RECORDER_PBO_COUNT = 6;
+constexpr int YUV_VALIDATION_TOLERANCE = 2;  // Max GPU vs CPU reference difference (8-bit levels)
+constexpr int RECORDER_BLOCK_TIMEOUT_MS = 1000;  // Block policy: longest wait for an encoder buffer before dropping
+constexpr int MAX_PENDING_DUPLICATE_FRAMES = 30;  // Duplicate policy: repeats waiting for the encoder; more are dropped
+
 // Side panel update timeouts (seconds)
 constexpr float LEFT_PANEL_TIMEOUT_SECS = 7.0f;
 constexpr float RIGHT_PANEL_TIMEOUT_SECS = 11.0f;
@@ -22,6 +32,20 @@ constexpr float RIGHT_PANEL_TIMEOUT_SECS = 11.0f;
 constexpr int PBO_FRAMES_TO_WAIT = 2;
 constexpr int PBO_MAX_FRAMES_BEFORE_ABANDON = 10;
 
+// Async image saver queueing
+constexpr int IMAGE_SAVER_PBO_COUNT = 3;           // Concurrent readbacks
+constexpr int IMAGE_SAVER_MAX_QUEUED_REQUESTS = 4;  // Staging FBO copies waiting for a free PBO
+
+// Tiled (oversize) still capture
+constexpr int TILED_STILL_TILE_SIZE = 2048;
+constexpr int TILED_STILL_PBO_COUNT = 3;
+constexpr int DEFAULT_TILED_STILL_SCALE = 4;
+constexpr int MAX_TILED_STILL_SCALE = 16;
+
+// Config thumbnails (written next to the config JSON when a config is left)
+constexpr int CONFIG_THUMBNAIL_SIZE = 256;              // Square, centre-cropped
+constexpr float CONFIG_THUMBNAIL_MIN_RUNNING_SECS = 10.0f;  // Don't replace a thumbnail with a barely-started config
+
 // Side panel random position bounds (fraction of composite)
 constexpr float PANEL_ORIGIN_MIN_FRAC = 0.25f;  // 1/4 from edge
 constexpr float PANEL_ORIGIN_MAX_FRAC = 0.75f;  // 3/4 from edge
@@ -0,0 +1,88 @@
+//
+//  RgbToYuvShader.h
+//  ofxMarkSynth
+//
+//  Converts an RGB texture into a single-channel (R8) target laid out byte-for-byte as an
+//  I420 or NV12 frame: `width` x `height * 3 / 2` texels, read back with GL_RED. Output row r
+//  matches source row r, as with a direct RGB readback.
+//  BT.709 limited range with 2x2 box-filtered chroma; convertRgbToYuv420Reference() is the CPU reference.
+//
+
+#pragma once
+
+#include "Shader.h"
+#include "rendering/YuvConversion.hpp"
+
+namespace ofxMarkSynth {
+
+class RgbToYuvShader : public ::Shader {
+
+public:
+  /// Draw a rectangle covering the whole target between begin() and end().
+  void begin(const ofTexture& rgbTexture, RecordingPixelFormat format) {
+    shader.begin();
+    shader.setUniformTexture("u_rgb", rgbTexture, 0);
+    shader.setUniform2i("u_size", static_cast<int>(rgbTexture.getWidth()), static_cast<int>(rgbTexture.getHeight()));
+    shader.setUniform1i("u_nv12", format == RecordingPixelFormat::NV12 ? 1 : 0);
+  }
+
+  void end() {
+    shader.end();
+  }
+
+  std::string getFragmentShader() override {
+    return GLSL(
+      uniform sampler2D u_rgb;
+      uniform ivec2 u_size;
+      uniform int u_nv12;
+
+      out vec4 fragColor;
+
+      float luma(vec3 c) {
+        return 16.0 + 219.0 * dot(c, vec3(0.2126, 0.7152, 0.0722));
+      }
+
+      float cb(vec3 c) {
+        return 128.0 + 224.0 * dot(c, vec3(-0.114572, -0.385428, 0.5));
+      }
+
+      float cr(vec3 c) {
+        return 128.0 + 224.0 * dot(c, vec3(0.5, -0.454153, -0.045847));
+      }
+
+      vec3 chromaSource(int cx, int cy) {
+        ivec2 p = ivec2(cx * 2, cy * 2);
+        return 0.25 * (texelFetch(u_rgb, p, 0).rgb
+                       + texelFetch(u_rgb, p + ivec2(1, 0), 0).rgb
+                       + texelFetch(u_rgb, p + ivec2(0, 1), 0).rgb
+                       + texelFetch(u_rgb, p + ivec2(1, 1), 0).rgb);
+      }
+
+      void main() {
+        ivec2 o = ivec2(gl_FragCoord.xy);
+        float value;
+
+        if (o.y < u_size.y) {
+          value = luma(texelFetch(u_rgb, o, 0).rgb);
+        } else if (u_nv12 == 1) {
+          // Interleaved UV rows: even bytes Cb, odd bytes Cr
+          vec3 c = chromaSource(o.x / 2, o.y - u_size.y);
+          value = (o.x % 2 == 0) ? cb(c) : cr(c);
+        } else {
+          // Planar U then V, each (w/2 x h/2) packed into rows of width w
+          int chromaWidth = u_size.x / 2;
+          int chromaCount = chromaWidth * (u_size.y / 2);
+          int index = (o.y - u_size.y) * u_size.x + o.x;
+          bool isV = index >= chromaCount;
+          if (isV) index -= chromaCount;
+          vec3 c = chromaSource(index % chromaWidth, index / chromaWidth);
+          value = isV ? cr(c) : cb(c);
+        }
+
+        fragColor = vec4(clamp(value, 0.0, 255.0) / 255.0, 0.0, 0.0, 1.0);
+      }
+    );
+  }
+};
+
+} // namespace ofxMarkSynth
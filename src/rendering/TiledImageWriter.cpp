@@ -0,0 +1,86 @@
+//
+//  TiledImageWriter.cpp
+//  ofxMarkSynth
+//
+
+#include "rendering/TiledImageWriter.hpp"
+#include "ofLog.h"
+#include <fcntl.h>
+#include <string>
+#include <unistd.h>
+
+namespace ofxMarkSynth {
+
+static bool writeAll(int fd, const uint8_t* data, size_t size, off_t offset) {
+    while (size > 0) {
+        const ssize_t written = pwrite(fd, data, size, offset);
+        if (written <= 0) return false;
+        data += written;
+        size -= static_cast<size_t>(written);
+        offset += written;
+    }
+    return true;
+}
+
+TiledImageWriter::~TiledImageWriter() {
+    close();
+}
+
+bool TiledImageWriter::open(const std::filesystem::path& path_, int width_, int height_) {
+    close();
+
+    path = path_;
+    width = width_;
+    height = height_;
+    failed = false;
+
+    std::error_code ec;
+    std::filesystem::create_directories(path.parent_path(), ec);
+
+    fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        ofLogError("TiledImageWriter") << "Failed to open " << path;
+        return false;
+    }
+
+    const std::string header = "P6\n" + std::to_string(width) + " " + std::to_string(height) + "\n255\n";
+    headerSize = header.size();
+    const off_t fileSize = static_cast<off_t>(headerSize + static_cast<size_t>(width) * static_cast<size_t>(height) * 3);
+    if (!writeAll(fd, reinterpret_cast<const uint8_t*>(header.data()), header.size(), 0) || ftruncate(fd, fileSize) != 0) {
+        ofLogError("TiledImageWriter") << "Failed to size " << path << " for " << width << "x" << height;
+        ::close(fd);
+        fd = -1;
+        return false;
+    }
+    return true;
+}
+
+bool TiledImageWriter::writeTile(int x0, int y0, int tileWidth, int tileHeight, const uint8_t* rgb) {
+    if (fd < 0 || x0 < 0 || y0 < 0 || x0 + tileWidth > width || y0 + tileHeight > height) return false;
+
+    const size_t rowBytes = static_cast<size_t>(tileWidth) * 3;
+    for (int row = 0; row < tileHeight; ++row) {
+        const size_t pixelIndex = static_cast<size_t>(y0 + row) * static_cast<size_t>(width) + static_cast<size_t>(x0);
+        const off_t offset = static_cast<off_t>(headerSize + pixelIndex * 3);
+        if (!writeAll(fd, rgb + row * rowBytes, rowBytes, offset)) {
+            failed = true;
+            return false;
+        }
+    }
+    return true;
+}
+
+bool TiledImageWriter::close() {
+    if (fd < 0) return !failed;
+
+    const bool ok = (::close(fd) == 0) && !failed;
+    fd = -1;
+    if (ok) {
+        ofLogNotice("TiledImageWriter") << "Wrote " << width << "x" << height << " image to " << path;
+    } else {
+        ofLogError("TiledImageWriter") << "Failed writing " << path;
+    }
+    return ok;
+}
+
+} // namespace ofxMarkSynth
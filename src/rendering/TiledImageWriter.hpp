@@ -0,0 +1,48 @@
+//
+//  TiledImageWriter.hpp
+//  ofxMarkSynth
+//
+//  Writes an 8-bit RGB binary PPM (P6) whose pixels arrive as independent tiles, in any order
+//  and from any thread. Every pixel's file offset is known from the header, so tiles are written
+//  with positional writes and the full image never exists in memory.
+//
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+
+namespace ofxMarkSynth {
+
+class TiledImageWriter {
+public:
+    TiledImageWriter() = default;
+
+    /// Closes the file (logging the outcome) if still open.
+    ~TiledImageWriter();
+
+    TiledImageWriter(const TiledImageWriter&) = delete;
+    TiledImageWriter& operator=(const TiledImageWriter&) = delete;
+
+    /// Create the file, write the header and size it for width x height pixels.
+    bool open(const std::filesystem::path& path, int width, int height);
+
+    /// Thread-safe. `rgb` is tightly packed, top row first.
+    bool writeTile(int x0, int y0, int tileWidth, int tileHeight, const uint8_t* rgb);
+
+    bool close();
+
+    bool isOpen() const { return fd >= 0; }
+    const std::filesystem::path& getPath() const { return path; }
+
+private:
+    std::filesystem::path path;
+    int fd { -1 };
+    int width { 0 };
+    int height { 0 };
+    size_t headerSize { 0 };
+    std::atomic<bool> failed { false };
+};
+
+} // namespace ofxMarkSynth
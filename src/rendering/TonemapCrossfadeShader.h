@@ -2,26 +2,149 @@
 //  TonemapCrossfadeShader.h
 //  ofxMarkSynth
 //
-//  Two-input HDR crossfade + tonemapping shader.
+//  Two-input HDR crossfade + tonemapping shader, and a single-input variant
+//  used when there is nothing to crossfade. Post-tonemap grading is a single
+//  fetch from a GradingLut 3D texture, followed by gamma.
 //
 
 #pragma once
 
 #include "Shader.h"
+#include <string>
 
 namespace ofxMarkSynth {
 
-class TonemapCrossfadeShader : public ::Shader {
+// Stringify GLSL without the #version line that GLSL() prepends, so shared code can follow a GLSL() header.
+#define TONEMAP_GLSL_BODY(shader) #shader
+
+// Display uniforms, tonemap operators and LUT grading shared by both tonemap shaders.
+// Entry point: vec3 tonemapAndGrade(vec3 hdrColor).
+inline const std::string& tonemapGradeGlsl() {
+  static const std::string source = TONEMAP_GLSL_BODY(
+    uniform int u_tonemapType;
+    uniform float u_exposure;
+    uniform float u_gamma;
+    uniform float u_whitePoint;
+    uniform sampler3D u_gradingLut;
+    uniform float u_gradingLutScale;
+    uniform float u_gradingLutOffset;
+
+    vec3 acesTonemap(vec3 color) {
+      const float A = 2.51;
+      const float B = 0.03;
+      const float C = 2.43;
+      const float D = 0.59;
+      const float E = 0.14;
+      return clamp((color * (A * color + B)) / (color * (C * color + D) + E), 0.0, 1.0);
+    }
+
+    vec3 filmicTonemap(vec3 color) {
+      const float A = 0.15;
+      const float B = 0.50;
+      const float C = 0.10;
+      const float D = 0.20;
+      const float E = 0.02;
+      const float F = 0.30;
+      const float W = 11.2;
+
+      vec3 curr = ((color * (A * color + C * B) + D * E) / (color * (A * color + B) + D * F)) - E / F;
+      float whiteScale = 1.0 / (((W * (A * W + C * B) + D * E) / (W * (A * W + B) + D * F)) - E / F);
+      return curr * whiteScale;
+    }
+
+    vec3 reinhardTonemap(vec3 color) {
+      return color / (1.0 + color);
+    }
+
+    vec3 reinhardExtendedTonemap(vec3 color, float whitePoint) {
+      vec3 numerator = color * (1.0 + (color / (whitePoint * whitePoint)));
+      return numerator / (1.0 + color);
+    }
+
+    vec3 exposureTonemap(vec3 color, float exposure) {
+      return 1.0 - exp(-color * exposure);
+    }
+
+    vec3 sampleTexture(sampler2D tex, vec2 uv, int flipY) {
+      vec2 sampleUv = uv;
+      if (flipY == 1) {
+        sampleUv.y = 1.0 - sampleUv.y;
+      }
+      return texture(tex, sampleUv).rgb;
+    }
+
+    vec3 tonemapAndGrade(vec3 hdrColor) {
+      // Apply exposure
+      hdrColor *= u_exposure;
+
+      vec3 ldrColor;
+
+      // Apply selected tonemapping
+      if (u_tonemapType == 0) {
+        // Linear (clamp)
+        ldrColor = clamp(hdrColor, 0.0, 1.0);
+      } else if (u_tonemapType == 1) {
+        // Reinhard
+        ldrColor = reinhardTonemap(hdrColor);
+      } else if (u_tonemapType == 2) {
+        // Reinhard Extended
+        ldrColor = reinhardExtendedTonemap(hdrColor, u_whitePoint);
+      } else if (u_tonemapType == 3) {
+        // ACES
+        ldrColor = acesTonemap(hdrColor);
+      } else if (u_tonemapType == 4) {
+        // Filmic
+        ldrColor = filmicTonemap(hdrColor);
+      } else if (u_tonemapType == 5) {
+        // Exposure
+        ldrColor = exposureTonemap(hdrColor, u_exposure);
+      } else {
+        // Default to Reinhard
+        ldrColor = reinhardTonemap(hdrColor);
+      }
+
+      // Contrast, saturation, brightness and hue shift are baked into the LUT (texel-centre addressing)
+      vec3 lutCoord = clamp(ldrColor, 0.0, 1.0) * u_gradingLutScale + u_gradingLutOffset;
+      ldrColor = texture(u_gradingLut, lutCoord).rgb;
+
+      // Apply gamma correction
+      return pow(ldrColor, vec3(1.0 / u_gamma));
+    }
+  );
+  return source;
+}
+
+class TonemapShaderBase : public ::Shader {
+
+protected:
+  void setDisplayUniforms(int tonemapType,
+                          float exposure,
+                          float gamma,
+                          float whitePoint,
+                          GLuint gradingLutTextureId,
+                          int gradingLutSize,
+                          int gradingLutTextureLocation) {
+    shader.setUniform1i("u_tonemapType", tonemapType);
+    shader.setUniform1f("u_exposure", exposure);
+    shader.setUniform1f("u_gamma", gamma);
+    shader.setUniform1f("u_whitePoint", whitePoint);
+
+    const float lutSize = static_cast<float>(gradingLutSize);
+    shader.setUniform1f("u_gradingLutScale", (lutSize - 1.0f) / lutSize);
+    shader.setUniform1f("u_gradingLutOffset", 0.5f / lutSize);
+    shader.setUniformTexture("u_gradingLut", GL_TEXTURE_3D, static_cast<GLint>(gradingLutTextureId), gradingLutTextureLocation);
+  }
+};
+
+class TonemapCrossfadeShader : public TonemapShaderBase {
 
 public:
   void begin(int tonemapType,
              float exposure,
              float gamma,
              float whitePoint,
-             float contrast,
-             float saturation,
-             float brightness,
-             float hueShift,
+             GLuint gradingLutTextureId,
+             int gradingLutSize,
              float weightA,
              float weightB,
              bool flipTextureA,
@@ -30,14 +153,7 @@ public:
              const ofTexture& textureB) {
     shader.begin();
 
-    shader.setUniform1i("u_tonemapType", tonemapType);
-    shader.setUniform1f("u_exposure", exposure);
-    shader.setUniform1f("u_gamma", gamma);
-    shader.setUniform1f("u_whitePoint", whitePoint);
-    shader.setUniform1f("u_contrast", contrast);
-    shader.setUniform1f("u_saturation", saturation);
-    shader.setUniform1f("u_brightness", brightness);
-    shader.setUniform1f("u_hueShift", hueShift);
+    setDisplayUniforms(tonemapType, exposure, gamma, whitePoint, gradingLutTextureId, gradingLutSize, 2);
 
     shader.setUniform1f("u_weightA", weightA);
     shader.setUniform1f("u_weightB", weightB);
@@ -53,141 +169,67 @@ public:
   }
 
   std::string getFragmentShader() override {
-    return GLSL(
+    return std::string(GLSL(
       uniform sampler2D u_textureA;
       uniform sampler2D u_textureB;
-      uniform int u_tonemapType;
-      uniform float u_exposure;
-      uniform float u_gamma;
-      uniform float u_whitePoint;
-      uniform float u_contrast;
-      uniform float u_saturation;
-      uniform float u_brightness;
-      uniform float u_hueShift;
-
-       uniform float u_weightA;
-       uniform float u_weightB;
-
-
+      uniform float u_weightA;
+      uniform float u_weightB;
       uniform int u_flipTextureA;
       uniform int u_flipTextureB;
 
       in vec2 texCoordVarying;
       out vec4 fragColor;
+    )) + tonemapGradeGlsl() + TONEMAP_GLSL_BODY(
+      void main() {
+        vec3 hdrA = sampleTexture(u_textureA, texCoordVarying, u_flipTextureA);
+        vec3 hdrB = sampleTexture(u_textureB, texCoordVarying, u_flipTextureB);
 
-      vec3 acesTonemap(vec3 color) {
-        const float A = 2.51;
-        const float B = 0.03;
-        const float C = 2.43;
-        const float D = 0.59;
-        const float E = 0.14;
-        return clamp((color * (A * color + B)) / (color * (C * color + D) + E), 0.0, 1.0);
-      }
-
-      vec3 filmicTonemap(vec3 color) {
-        const float A = 0.15;
-        const float B = 0.50;
-        const float C = 0.10;
-        const float D = 0.20;
-        const float E = 0.02;
-        const float F = 0.30;
-        const float W = 11.2;
-
-        vec3 curr = ((color * (A * color + C * B) + D * E) / (color * (A * color + B) + D * F)) - E / F;
-        float whiteScale = 1.0 / (((W * (A * W + C * B) + D * E) / (W * (A * W + B) + D * F)) - E / F);
-        return curr * whiteScale;
-      }
+        float wA = max(u_weightA, 0.0);
+        float wB = max(u_weightB, 0.0);
+        float wSum = max(wA + wB, 1e-6);
+        vec3 hdrColor = (hdrA * wA + hdrB * wB) / wSum;
 
-      vec3 reinhardTonemap(vec3 color) {
-        return color / (1.0 + color);
+        fragColor = vec4(tonemapAndGrade(hdrColor), 1.0);
       }
+    );
+  }
+};
 
-      vec3 reinhardExtendedTonemap(vec3 color, float whitePoint) {
-        vec3 numerator = color * (1.0 + (color / (whitePoint * whitePoint)));
-        return numerator / (1.0 + color);
-      }
+// Single-input variant for steady-state output: one texture fetch, no crossfade weights.
+class TonemapShader : public TonemapShaderBase {
 
-      vec3 exposureTonemap(vec3 color, float exposure) {
-        return 1.0 - exp(-color * exposure);
-      }
+public:
+  void begin(int tonemapType,
+             float exposure,
+             float gamma,
+             float whitePoint,
+             GLuint gradingLutTextureId,
+             int gradingLutSize,
+             bool flipTexture,
+             const ofTexture& texture) {
+    shader.begin();
 
-      vec3 adjustSaturation(vec3 color, float saturation) {
-        float gray = dot(color, vec3(0.299, 0.587, 0.114));
-        return mix(vec3(gray), color, saturation);
-      }
+    setDisplayUniforms(tonemapType, exposure, gamma, whitePoint, gradingLutTextureId, gradingLutSize, 1);
 
-      vec3 adjustBrightness(vec3 color, float brightness) {
-        return clamp(color + brightness, 0.0, 1.0);
-      }
+    shader.setUniform1i("u_flipTexture", flipTexture ? 1 : 0);
+    shader.setUniformTexture("u_texture", texture, 0);
+  }
 
-      vec3 adjustHue(vec3 color, float hue) {
-        float angle = hue * 6.2831853; // hue in [0,1], convert to radians
-        float cosA = cos(angle);
-        float sinA = sin(angle);
-        mat3 rot = mat3(
-          vec3(0.299 + 0.701 * cosA + 0.168 * sinA, 0.587 - 0.587 * cosA + 0.330 * sinA, 0.114 - 0.114 * cosA - 0.497 * sinA),
-          vec3(0.299 - 0.299 * cosA - 0.328 * sinA, 0.587 + 0.413 * cosA + 0.035 * sinA, 0.114 - 0.114 * cosA + 0.292 * sinA),
-          vec3(0.299 - 0.3 * cosA + 1.25 * sinA,    0.587 - 0.588 * cosA - 1.05 * sinA, 0.114 + 0.886 * cosA - 0.203 * sinA)
-        );
-        return clamp(rot * color, 0.0, 1.0);
-      }
+  void end() {
+    shader.end();
+  }
 
-      vec3 sampleTexture(sampler2D tex, vec2 uv, int flipY) {
-        vec2 sampleUv = uv;
-        if (flipY == 1) {
-          sampleUv.y = 1.0 - sampleUv.y;
-        }
-        return texture(tex, sampleUv).rgb;
-      }
+  std::string getFragmentShader() override {
+    return std::string(GLSL(
+      uniform sampler2D u_texture;
+      uniform int u_flipTexture;
 
+      in vec2 texCoordVarying;
+      out vec4 fragColor;
+    )) + tonemapGradeGlsl() + TONEMAP_GLSL_BODY(
       void main() {
-        vec3 hdrA = sampleTexture(u_textureA, texCoordVarying, u_flipTextureA);
-        vec3 hdrB = sampleTexture(u_textureB, texCoordVarying, u_flipTextureB);
-
-        float wA = max(u_weightA, 0.0);
-        float wB = max(u_weightB, 0.0);
-        float wSum = max(wA + wB, 1e-6);
-        vec3 hdrColor = (hdrA * wA + hdrB * wB) / wSum;
-
-        // Apply exposure
-        hdrColor *= u_exposure;
-
-        vec3 ldrColor;
-
-        // Apply selected tonemapping
-        if (u_tonemapType == 0) {
-          // Linear (clamp)
-          ldrColor = clamp(hdrColor, 0.0, 1.0);
-        } else if (u_tonemapType == 1) {
-          // Reinhard
-          ldrColor = reinhardTonemap(hdrColor);
-        } else if (u_tonemapType == 2) {
-          // Reinhard Extended
-          ldrColor = reinhardExtendedTonemap(hdrColor, u_whitePoint);
-        } else if (u_tonemapType == 3) {
-          // ACES
-          ldrColor = acesTonemap(hdrColor);
-        } else if (u_tonemapType == 4) {
-          // Filmic
-          ldrColor = filmicTonemap(hdrColor);
-        } else if (u_tonemapType == 5) {
-          // Exposure
-          ldrColor = exposureTonemap(hdrColor, u_exposure);
-        } else {
-          // Default to Reinhard
-          ldrColor = reinhardTonemap(hdrColor);
-        }
-
-        // Apply contrast, saturation, brightness and hue-shift adjustments
-        ldrColor = (ldrColor - 0.5) * u_contrast + 0.5;
-        ldrColor = adjustSaturation(ldrColor, u_saturation);
-        ldrColor = adjustBrightness(ldrColor, u_brightness);
-        ldrColor = adjustHue(ldrColor, u_hueShift);
-
-        // Apply gamma correction
-        ldrColor = pow(ldrColor, vec3(1.0 / u_gamma));
-
-        fragColor = vec4(ldrColor, 1.0);
+        vec3 hdrColor = sampleTexture(u_texture, texCoordVarying, u_flipTexture);
+        fragColor = vec4(tonemapAndGrade(hdrColor), 1.0);
       }
     );
   }
@@ -8,10 +8,15 @@
 #include "rendering/VideoRecorder.hpp"
 #include "rendering/RenderingConstants.h"
 
-#ifdef TARGET_MAC
+#ifdef OFXMARKSYNTH_VIDEO_RECORDING
 
 #include "ofLog.h"
 #include "ofGraphics.h"
+#include "ofMesh.h"
+#include "ofUtils.h"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
 
 
 
@@ -19,10 +24,39 @@ namespace ofxMarkSynth {
 
 
 
-void VideoRecorder::setup(glm::vec2 compositeSize, const std::filesystem::path& ffmpegPath) {
+void VideoRecorder::setBackpressurePolicy(RecordingBackpressurePolicy policy) {
+    backpressurePolicy_ = policy;
+}
+
+void VideoRecorder::resetStats() {
+    framesCaptured_ = 0;
+    framesBlocked_ = 0;
+    blockedMicros_ = 0;
+    maxQueueDepth_ = 0;
+    startTimeSec_ = ofGetElapsedTimef();
+    stopTimeSec_ = -1.0f;
+}
+
+RecordingStats VideoRecorder::makeStats() const {
+    RecordingStats stats;
+    stats.policy = backpressurePolicy_;
+    stats.framesCaptured = framesCaptured_;
+    stats.framesBlocked = framesBlocked_;
+    stats.blockedMs = blockedMicros_ / 1000.0;
+    stats.maxQueueDepth = maxQueueDepth_;
+    const float endTimeSec = stopTimeSec_ >= 0.0f ? stopTimeSec_ : ofGetElapsedTimef();
+    stats.durationSec = std::max(0.0f, endTimeSec - startTimeSec_);
+    return stats;
+}
+
+#ifdef TARGET_MAC
+
+void VideoRecorder::setup(glm::vec2 compositeSize, const std::filesystem::path& ffmpegPath, int /*pboCount*/,
+                          RecordingPixelFormat /*pixelFormat*/) {
     compositeSize_ = compositeSize;
     
     compositeFbo_.allocate(compositeSize_.x, compositeSize_.y, GL_RGB);
+    compositeMemory_ = GpuMemoryRegistry::instance().addFbo("VideoRecorder", "composite", compositeFbo_);
     
     recorder_.setup(/*video*/true, /*audio*/false, compositeFbo_.getSize(),
                     DEFAULT_VIDEO_FPS, DEFAULT_VIDEO_BITRATE);
@@ -53,10 +87,13 @@ void VideoRecorder::startRecording(const std::string& outputPath) {
     }
     
     recorder_.setOutputPath(outputPath);
+    outputPath_ = outputPath;
     
     // Reset PBO state for new recording
     pboWriteIndex_ = 0;
     frameCount_ = 0;
+    framesWritten_ = 0;
+    resetStats();
     
     recorder_.startCustomRecord();
     ofLogNotice("VideoRecorder") << "Started recording to: " << outputPath;
@@ -67,6 +104,7 @@ void VideoRecorder::stopRecording() {
     
     flushPendingFrame();
     recorder_.stop();
+    stopTimeSec_ = ofGetElapsedTimef();
     ofLogNotice("VideoRecorder") << "Stopped recording";
 }
 
@@ -102,6 +140,8 @@ void VideoRecorder::captureFrameFromFbo(const ofFbo& sourceFbo) {
         return;
     }
 
+    framesCaptured_++;
+
     // Bind FBO for reading
     sourceFbo.bind();
 
@@ -123,6 +163,7 @@ void VideoRecorder::captureFrameFromFbo(const ofFbo& sourceFbo) {
         }
         pbos_[readIndex].unbind(GL_PIXEL_PACK_BUFFER);
         recorder_.addFrame(pixels_);
+        framesWritten_++;
     }
 
     pboWriteIndex_ = (pboWriteIndex_ + 1) % NUM_PBOS;
@@ -142,6 +183,7 @@ void VideoRecorder::flushPendingFrame() {
         memcpy(pixels_.getData(), ptr, width * height * 3);
         pbos_[readIndex].unmap();
         recorder_.addFrame(pixels_);
+        framesWritten_++;
     }
     pbos_[readIndex].unbind(GL_PIXEL_PACK_BUFFER);
 }
@@ -150,8 +192,336 @@ bool VideoRecorder::isRecording() const {
     return recorder_.isRecording();
 }
 
+RecordingStats VideoRecorder::getStats() const {
+    // ofxFFmpegRecorder queues and encodes internally, so only frames handed to it are visible here.
+    RecordingStats stats = makeStats();
+    stats.framesWritten = framesWritten_;
+    stats.framesDropped = framesCaptured_ > framesWritten_ && !recorder_.isRecording() ? framesCaptured_ - framesWritten_ : 0;
+    return stats;
+}
 
+#else // Linux
 
-} // namespace ofxMarkSynth
+template <typename F>
+auto VideoRecorder::blockFor(F&& waitFn) {
+    if (isBlocking_) return waitFn();   // Nested wait: already being timed
+
+    isBlocking_ = true;
+    const uint64_t startMicros = ofGetElapsedTimeMicros();
+    auto result = waitFn();
+    blockedMicros_ += ofGetElapsedTimeMicros() - startMicros;
+    framesBlocked_++;
+    isBlocking_ = false;
+    return result;
+}
+
+void VideoRecorder::setup(glm::vec2 compositeSize, const std::filesystem::path& ffmpegPath, int pboCount,
+                          RecordingPixelFormat pixelFormat) {
+    compositeSize_ = compositeSize;
+    ffmpegPath_ = ffmpegPath;
+
+    compositeFbo_.allocate(compositeSize_.x, compositeSize_.y, GL_RGB);
+    compositeMemory_ = GpuMemoryRegistry::instance().addFbo("VideoRecorder", "composite", compositeFbo_);
+
+    const int width = static_cast<int>(compositeSize_.x);
+    const int height = static_cast<int>(compositeSize_.y);
+    pixelFormat_ = pixelFormat;
+    if (pixelFormat_ != RecordingPixelFormat::RGB24 && (width % 2 != 0 || height % 2 != 0)) {
+        ofLogWarning("VideoRecorder") << getRecordingPixelFormatName(pixelFormat_) << " needs even dimensions, got "
+                                      << width << "x" << height << "; using RGB24";
+        pixelFormat_ = RecordingPixelFormat::RGB24;
+    }
+    if (pixelFormat_ != RecordingPixelFormat::RGB24) {
+        ofFboSettings settings;
+        settings.width = width;
+        settings.height = height + height / 2;
+        settings.internalformat = GL_R8;
+        settings.useDepth = false;
+        settings.useStencil = false;
+        settings.minFilter = GL_NEAREST;
+        settings.maxFilter = GL_NEAREST;
+        yuvFbo_.allocate(settings);
+        yuvShader_.load();
+        if (validateYuv()) {
+            yuvMemory_ = GpuMemoryRegistry::instance().addFbo("VideoRecorder", "yuv", yuvFbo_);
+        } else {
+            yuvFbo_.clear();
+            pixelFormat_ = RecordingPixelFormat::RGB24;
+        }
+    }
+
+    pboCount = std::clamp(pboCount, MIN_RECORDER_PBO_COUNT, MAX_RECORDER_PBO_COUNT);
+    const size_t pboSize = getRecordingFrameByteSize(pixelFormat_, width, height);
+    pboRing_ = std::vector<PboSlot>(pboCount);
+    for (auto& slot : pboRing_) {
+        slot.pbo.allocate(pboSize, GL_STREAM_READ);
+    }
+    pboReadIndex_ = 0;
+    pboPendingCount_ = 0;
+
+    isSetup_ = true;
+    ofLogNotice("VideoRecorder") << "Setup complete: " << compositeSize_.x << "x" << compositeSize_.y
+                                 << " " << getRecordingPixelFormatName(pixelFormat_) << " with " << pboCount << " PBOs";
+}
+
+void VideoRecorder::startRecording(const std::string& outputPath) {
+    if (!isSetup_) {
+        ofLogError("VideoRecorder") << "Cannot start recording: not setup";
+        return;
+    }
+
+    if (encoder_.isActive()) {
+        ofLogWarning("VideoRecorder") << "Already recording";
+        return;
+    }
+
+    // Frames in flight: the PBO ring plus as many again queued for the encoder, plus the one it keeps for repeats
+    const int poolSize = static_cast<int>(pboRing_.size()) * 2 + 1;
+    if (!encoder_.start(outputPath, compositeSize_.x, compositeSize_.y, DEFAULT_VIDEO_FPS, pixelFormat_, ffmpegPath_, poolSize)) {
+        ofLogError("VideoRecorder") << "Failed to start recording to: " << outputPath;
+        return;
+    }
+    outputPath_ = encoder_.getOutputPath();
+    resetStats();
+    ofLogNotice("VideoRecorder") << "Started recording to: " << outputPath_
+                                 << " (" << getRecordingBackpressurePolicyName(backpressurePolicy_) << " when behind)";
+}
+
+void VideoRecorder::stopRecording() {
+    if (!encoder_.isActive()) return;
+
+    drainPboRing(true);
+    encoder_.stop();
+    stopTimeSec_ = ofGetElapsedTimef();
+    ofLogNotice("VideoRecorder") << "Stopped recording";
+}
+
+void VideoRecorder::shutdown() {
+    if (encoder_.isActive()) {
+        ofLogNotice("VideoRecorder") << "Stopping recording on shutdown";
+        stopRecording();
+    }
+}
+
+void VideoRecorder::captureFrame(std::function<void(ofFbo& fbo)> renderCallback) {
+    if (!encoder_.isActive()) return;
+
+    compositeFbo_.begin();
+    renderCallback(compositeFbo_);
+    compositeFbo_.end();
+
+    captureFrameFromFbo(compositeFbo_);
+}
+
+void VideoRecorder::captureFrameFromFbo(const ofFbo& sourceFbo) {
+    if (!encoder_.isActive()) return;
+    if (!sourceFbo.isAllocated()) return;
+
+    const int width = sourceFbo.getWidth();
+    const int height = sourceFbo.getHeight();
+
+    if (width != static_cast<int>(compositeSize_.x) || height != static_cast<int>(compositeSize_.y)) {
+        ofLogError("VideoRecorder") << "captureFrameFromFbo: size mismatch, expected "
+                                    << compositeSize_.x << "x" << compositeSize_.y << " got "
+                                    << width << "x" << height;
+        return;
+    }
+
+    framesCaptured_++;
+
+    // Collect whatever finished since last frame first, freeing ring slots.
+    drainPboRing(false);
+
+    // Every slot still in flight: wait for the oldest (Block), or lose this frame rather than wait on the GPU.
+    if (pboPendingCount_ == pboRing_.size()) {
+        switch (backpressurePolicy_) {
+            case RecordingBackpressurePolicy::Block:
+                blockFor([this] { return drainOldestPboSlot(true); });
+                break;
+            case RecordingBackpressurePolicy::Duplicate:
+                pboRing_[(pboReadIndex_ + pboPendingCount_ - 1) % pboRing_.size()].duplicatesAfter++;
+                updateQueueDepth();
+                return;
+            case RecordingBackpressurePolicy::Drop:
+                encoder_.noteDroppedFrame();
+                updateQueueDepth();
+                return;
+        }
+    }
+
+    const ofFbo* readFbo = &sourceFbo;
+    GLenum readFormat = GL_RGB;
+    if (pixelFormat_ != RecordingPixelFormat::RGB24) {
+        renderYuv(sourceFbo);
+        readFbo = &yuvFbo_;
+        readFormat = GL_RED;
+    }
+
+    PboSlot& slot = pboRing_[(pboReadIndex_ + pboPendingCount_) % pboRing_.size()];
+
+    readFbo->bind();
+    slot.pbo.bind(GL_PIXEL_PACK_BUFFER);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glReadPixels(0, 0, readFbo->getWidth(), readFbo->getHeight(), readFormat, GL_UNSIGNED_BYTE, 0);
+    slot.pbo.unbind(GL_PIXEL_PACK_BUFFER);
+    readFbo->unbind();
+
+    slot.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    pboPendingCount_++;
+    updateQueueDepth();
+}
+
+void VideoRecorder::updateQueueDepth() {
+    maxQueueDepth_ = std::max(maxQueueDepth_, static_cast<int>(pboPendingCount_) + encoder_.getQueueDepth());
+}
+
+void VideoRecorder::renderYuv(const ofFbo& sourceFbo) {
+    yuvFbo_.begin();
+    ofPushStyle();
+    ofEnableBlendMode(OF_BLENDMODE_DISABLED);
+    yuvShader_.begin(sourceFbo.getTexture(), pixelFormat_);
+    ofDrawRectangle(0, 0, yuvFbo_.getWidth(), yuvFbo_.getHeight());
+    yuvShader_.end();
+    ofPopStyle();
+    yuvFbo_.end();
+}
+
+bool VideoRecorder::validateYuv() {
+    // Fill the composite FBO with a gradient that exercises all three channels and every chroma block
+    const float w = compositeFbo_.getWidth();
+    const float h = compositeFbo_.getHeight();
+    ofMesh gradient;
+    gradient.setMode(OF_PRIMITIVE_TRIANGLE_STRIP);
+    gradient.addVertex({ 0.0f, 0.0f, 0.0f });
+    gradient.addColor(ofFloatColor(0.0f, 0.0f, 1.0f));
+    gradient.addVertex({ w, 0.0f, 0.0f });
+    gradient.addColor(ofFloatColor(1.0f, 0.0f, 0.0f));
+    gradient.addVertex({ 0.0f, h, 0.0f });
+    gradient.addColor(ofFloatColor(0.0f, 1.0f, 0.0f));
+    gradient.addVertex({ w, h, 0.0f });
+    gradient.addColor(ofFloatColor(1.0f, 1.0f, 1.0f));
+
+    compositeFbo_.begin();
+    ofClear(0, 0, 0, 255);
+    gradient.draw();
+    compositeFbo_.end();
+    renderYuv(compositeFbo_);
+
+    const int width = static_cast<int>(w);
+    const int height = static_cast<int>(h);
+    const size_t byteSize = getRecordingFrameByteSize(pixelFormat_, width, height);
+    std::vector<uint8_t> rgb(static_cast<size_t>(width) * static_cast<size_t>(height) * 3);
+    std::vector<uint8_t> gpuYuv(byteSize);
+    std::vector<uint8_t> cpuYuv(byteSize);
+
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    compositeFbo_.bind();
+    glReadPixels(0, 0, width, height, GL_RGB, GL_UNSIGNED_BYTE, rgb.data());
+    compositeFbo_.unbind();
+    yuvFbo_.bind();
+    glReadPixels(0, 0, yuvFbo_.getWidth(), yuvFbo_.getHeight(), GL_RED, GL_UNSIGNED_BYTE, gpuYuv.data());
+    yuvFbo_.unbind();
+
+    convertRgbToYuv420Reference(rgb.data(), width, height, pixelFormat_, cpuYuv.data());
+
+    int maxError = 0;
+    for (size_t i = 0; i < byteSize; ++i) {
+        maxError = std::max(maxError, std::abs(static_cast<int>(gpuYuv[i]) - static_cast<int>(cpuYuv[i])));
+    }
+
+    if (maxError > YUV_VALIDATION_TOLERANCE) {
+        ofLogWarning("VideoRecorder") << "GPU " << getRecordingPixelFormatName(pixelFormat_)
+                                      << " conversion differs from the CPU reference by up to " << maxError
+                                      << " levels; using RGB24";
+        return false;
+    }
+    ofLogNotice("VideoRecorder") << "GPU " << getRecordingPixelFormatName(pixelFormat_)
+                                 << " conversion validated (max error " << maxError << ")";
+    return true;
+}
+
+void VideoRecorder::drainPboRing(bool wait) {
+    while (pboPendingCount_ > 0 && drainOldestPboSlot(wait)) {}
+}
+
+bool VideoRecorder::drainOldestPboSlot(bool wait) {
+    PboSlot& slot = pboRing_[pboReadIndex_];
+
+    if (slot.fence) {
+        const GLuint64 timeoutNs = wait ? 1000000000ULL : 0;
+        const GLenum result = glClientWaitSync(slot.fence, wait ? GL_SYNC_FLUSH_COMMANDS_BIT : 0, timeoutNs);
+        if (result == GL_TIMEOUT_EXPIRED && !wait) return false;
+        if (result == GL_WAIT_FAILED || result == GL_TIMEOUT_EXPIRED) {
+            ofLogWarning("VideoRecorder") << "Readback fence failed; losing frame";
+            handleLostFrame();
+            releasePboSlot(slot);
+            return true;
+        }
+    }
+
+    // Encoder behind: lose the frame (unless blocking), but still free the ring slot.
+    FramePipeEncoder::FrameBuffer frame = encoder_.acquireFrame();
+    if (!frame && backpressurePolicy_ == RecordingBackpressurePolicy::Block) {
+        frame = blockFor([this] { return encoder_.acquireFrame(std::chrono::milliseconds(RECORDER_BLOCK_TIMEOUT_MS)); });
+    }
+    if (frame) {
+        slot.pbo.bind(GL_PIXEL_PACK_BUFFER);
+        if (const void* ptr = slot.pbo.map(GL_READ_ONLY)) {
+            std::memcpy(frame->data(), ptr, encoder_.getFrameByteSize());
+            slot.pbo.unmap();
+            encoder_.submitFrame(std::move(frame));
+        } else {
+            handleLostFrame();
+        }
+        slot.pbo.unbind(GL_PIXEL_PACK_BUFFER);
+    } else {
+        handleLostFrame();
+    }
+
+    releasePboSlot(slot);
+    return true;
+}
+
+void VideoRecorder::handleLostFrame() {
+    if (backpressurePolicy_ == RecordingBackpressurePolicy::Duplicate) {
+        encoder_.submitDuplicateFrame();
+    } else {
+        encoder_.noteDroppedFrame();
+    }
+}
+
+void VideoRecorder::releasePboSlot(PboSlot& slot) {
+    if (slot.fence) {
+        glDeleteSync(slot.fence);
+        slot.fence = nullptr;
+    }
+    // Frames lost while this one was in flight follow it, so repeats land in the right place.
+    for (; slot.duplicatesAfter > 0; --slot.duplicatesAfter) {
+        encoder_.submitDuplicateFrame();
+    }
+    pboReadIndex_ = (pboReadIndex_ + 1) % pboRing_.size();
+    pboPendingCount_--;
+}
+
+bool VideoRecorder::isRecording() const {
+    return encoder_.isActive();
+}
+
+RecordingStats VideoRecorder::getStats() const {
+    RecordingStats stats = makeStats();
+    stats.framesWritten = encoder_.getFramesWritten();
+    stats.framesDuplicated = encoder_.getFramesDuplicated();
+    stats.framesDropped = encoder_.getFramesDropped();
+    stats.queueDepth = static_cast<int>(pboPendingCount_) + encoder_.getQueueDepth();
+    stats.meanEncodeLatencyMs = encoder_.getMeanEncodeLatencyMs();
+    stats.maxEncodeLatencyMs = encoder_.getMaxEncodeLatencyMs();
+    return stats;
+}
 
 #endif // TARGET_MAC
+
+
+
+} // namespace ofxMarkSynth
+
+#endif // OFXMARKSYNTH_VIDEO_RECORDING
@@ -3,21 +3,39 @@
 //  ofxMarkSynth
 //
 //  Handles video recording with async PBO-based pixel readback.
-//  macOS only (uses ofxFFmpegRecorder with VideoToolbox).
+//  macOS: ofxFFmpegRecorder with VideoToolbox.
+//  Linux: a fenced PBO ring feeding a FramePipeEncoder thread (ffmpeg pipe, or y4m without ffmpeg),
+//  optionally converting to YUV 4:2:0 on the GPU first to halve readback bandwidth. When the
+//  encoder falls behind, the backpressure policy decides whether frames are dropped, repeated or
+//  waited for; either way the take's RecordingStats account for every captured frame.
 //
 
 #pragma once
 
-#include "ofConstants.h"  // For TARGET_MAC definition
+#include "ofConstants.h"  // For TARGET_MAC / TARGET_LINUX definitions
 
-#ifdef TARGET_MAC
+#if defined(TARGET_MAC) || defined(TARGET_LINUX)
+#define OFXMARKSYNTH_VIDEO_RECORDING
+#endif
+
+#ifdef OFXMARKSYNTH_VIDEO_RECORDING
 
+#ifdef TARGET_MAC
 #include "ofxFFmpegRecorder.h"
+#else
+#include "rendering/FramePipeEncoder.hpp"
+#include "rendering/RgbToYuvShader.h"
+#endif
+#include "rendering/GpuMemoryRegistry.hpp"
+#include "rendering/RecordingStats.hpp"
+#include "rendering/RenderingConstants.h"
+#include "rendering/YuvConversion.hpp"
 #include "ofFbo.h"
 #include "ofBufferObject.h"
 #include "ofPixels.h"
 #include <filesystem>
 #include <functional>
+#include <vector>
 #include <glm/vec2.hpp>
 
 
@@ -27,56 +45,129 @@ namespace ofxMarkSynth {
 
 
 /// Handles video recording with async PBO-based pixel readback.
-/// macOS only (uses ofxFFmpegRecorder with VideoToolbox).
 class VideoRecorder {
 public:
     VideoRecorder() = default;
-    
+
     /// Initialize recorder resources
-    void setup(glm::vec2 compositeSize, const std::filesystem::path& ffmpegPath);
-    
+    /// @param pboCount Readback ring size (Linux only; clamped to MIN/MAX_RECORDER_PBO_COUNT)
+    /// @param pixelFormat Readback format (Linux only); I420/NV12 convert on the GPU before readback
+    void setup(glm::vec2 compositeSize, const std::filesystem::path& ffmpegPath,
+               int pboCount = DEFAULT_RECORDER_PBO_COUNT,
+               RecordingPixelFormat pixelFormat = RecordingPixelFormat::RGB24);
+
     /// Start recording to the specified path
     void startRecording(const std::string& outputPath);
-    
+
     /// Stop recording, flushing any pending frames
     void stopRecording();
-    
+
     /// Shutdown and cleanup (call on app exit)
     void shutdown();
-    
+
     /// Capture a frame. Call during draw() when recording.
     /// @param renderCallback Called with the recorder FBO to render content into
     void captureFrame(std::function<void(ofFbo& fbo)> renderCallback);
 
     /// Capture a frame from an existing FBO (no extra rendering).
     void captureFrameFromFbo(const ofFbo& sourceFbo);
-    
+
     /// Check if currently recording
     bool isRecording() const;
-    
+
+    /// Path actually being written (the Linux backend switches to .y4m when ffmpeg is missing)
+    const std::filesystem::path& getOutputPath() const { return outputPath_; }
+
     /// Get recorder FBO size (for computing render scale)
     glm::vec2 getSize() const { return compositeSize_; }
 
+    /// What to do when readback or encoding falls behind (Linux only; macOS frames are queued by
+    /// ofxFFmpegRecorder). Takes effect immediately.
+    void setBackpressurePolicy(RecordingBackpressurePolicy policy);
+    RecordingBackpressurePolicy getBackpressurePolicy() const { return backpressurePolicy_; }
+
+    /// Counters for the current take, or the last one once stopped
+    RecordingStats getStats() const;
+
 private:
-    static constexpr int NUM_PBOS { 2 };
-    
-    ofxFFmpegRecorder recorder_;
     glm::vec2 compositeSize_;
     ofFbo compositeFbo_;
-    
+    GpuMemoryRegistry::Registration compositeMemory_;
+    std::filesystem::path outputPath_;
+    bool isSetup_ { false };
+
+    RecordingBackpressurePolicy backpressurePolicy_ { RecordingBackpressurePolicy::Drop };
+    uint64_t framesCaptured_ { 0 };
+    uint64_t framesBlocked_ { 0 };
+    uint64_t blockedMicros_ { 0 };
+    int maxQueueDepth_ { 0 };
+    float startTimeSec_ { 0.0f };
+    float stopTimeSec_ { -1.0f };   // -1 while recording
+
+    void resetStats();
+    /// Stats common to both backends
+    RecordingStats makeStats() const;
+
+#ifdef TARGET_MAC
+    static constexpr int NUM_PBOS { 2 };
+
+    ofxFFmpegRecorder recorder_;
+
     ofBufferObject pbos_[NUM_PBOS];
     int pboWriteIndex_ { 0 };
     int frameCount_ { 0 };
+    uint64_t framesWritten_ { 0 };
     ofPixels pixels_;
-    
-    bool isSetup_ { false };
-    
+
     /// Flush the last pending frame from PBO before stopping
     void flushPendingFrame();
+#else
+    struct PboSlot {
+        ofBufferObject pbo;
+        GLsync fence { nullptr };
+        int duplicatesAfter { 0 };   // Frames lost while this readback was the newest (Duplicate policy)
+    };
+
+    std::filesystem::path ffmpegPath_;
+    FramePipeEncoder encoder_;
+    std::vector<PboSlot> pboRing_;
+    size_t pboReadIndex_ { 0 };     // Oldest in-flight readback
+    size_t pboPendingCount_ { 0 };
+
+    RecordingPixelFormat pixelFormat_ { RecordingPixelFormat::RGB24 };
+    RgbToYuvShader yuvShader_;
+    ofFbo yuvFbo_;                  // R8, width x height * 3/2, laid out as one I420/NV12 frame
+    GpuMemoryRegistry::Registration yuvMemory_;
+
+    /// Convert sourceFbo into yuvFbo_
+    void renderYuv(const ofFbo& sourceFbo);
+
+    /// One-off synchronous check (at setup) of the GPU conversion of a test gradient against
+    /// convertRgbToYuv420Reference(). Returns false if it's out of tolerance.
+    bool validateYuv();
+
+    bool isBlocking_ { false };
+
+    /// Hand completed readbacks (oldest first) to the encoder; stops at the first one still in flight
+    /// unless `wait` is set (used when stopping).
+    void drainPboRing(bool wait);
+    /// Returns false if the oldest readback is still in flight (only possible without `wait`).
+    bool drainOldestPboSlot(bool wait);
+    void releasePboSlot(PboSlot& slot);
+
+    /// Drop or repeat a frame that couldn't reach the encoder, per the policy.
+    void handleLostFrame();
+
+    /// Run a blocking wait, adding its duration to the blocked-frame stats.
+    template <typename F>
+    auto blockFor(F&& waitFn);
+
+    void updateQueueDepth();
+#endif
 };
 
 
 
 } // namespace ofxMarkSynth
 
-#endif // TARGET_MAC
+#endif // OFXMARKSYNTH_VIDEO_RECORDING
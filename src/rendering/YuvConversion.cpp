@@ -0,0 +1,139 @@
+//
+//  YuvConversion.cpp
+//  ofxMarkSynth
+//
+
+#include "rendering/YuvConversion.hpp"
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstring>
+
+namespace ofxMarkSynth {
+
+namespace {
+
+// BT.709 limited range; must match RgbToYuvShader exactly.
+uint8_t toByte(float v) {
+    return static_cast<uint8_t>(std::clamp(std::lround(v), 0L, 255L));
+}
+
+uint8_t lumaByte(float r, float g, float b) {
+    return toByte(16.0f + 219.0f * (0.2126f * r + 0.7152f * g + 0.0722f * b));
+}
+
+uint8_t cbByte(float r, float g, float b) {
+    return toByte(128.0f + 224.0f * (-0.114572f * r - 0.385428f * g + 0.5f * b));
+}
+
+uint8_t crByte(float r, float g, float b) {
+    return toByte(128.0f + 224.0f * (0.5f * r - 0.454153f * g - 0.045847f * b));
+}
+
+} // anonymous namespace
+
+std::optional<RecordingPixelFormat> parseRecordingPixelFormat(const std::string& name) {
+    std::string s;
+    for (char c : name) s.push_back(static_cast<char>(std::tolower(static_cast<unsigned char>(c))));
+
+    if (s == "rgb" || s == "rgb24") return RecordingPixelFormat::RGB24;
+    if (s == "i420" || s == "yuv420p") return RecordingPixelFormat::I420;
+    if (s == "nv12") return RecordingPixelFormat::NV12;
+    return std::nullopt;
+}
+
+const char* getRecordingPixelFormatName(RecordingPixelFormat format) {
+    switch (format) {
+        case RecordingPixelFormat::RGB24: return "RGB24";
+        case RecordingPixelFormat::I420: return "I420";
+        case RecordingPixelFormat::NV12: return "NV12";
+    }
+    return "RGB24";
+}
+
+const char* getFfmpegPixelFormat(RecordingPixelFormat format) {
+    switch (format) {
+        case RecordingPixelFormat::RGB24: return "rgb24";
+        case RecordingPixelFormat::I420: return "yuv420p";
+        case RecordingPixelFormat::NV12: return "nv12";
+    }
+    return "rgb24";
+}
+
+size_t getRecordingFrameByteSize(RecordingPixelFormat format, int width, int height) {
+    const size_t pixelCount = static_cast<size_t>(width) * static_cast<size_t>(height);
+    return format == RecordingPixelFormat::RGB24 ? pixelCount * 3 : pixelCount + pixelCount / 2;
+}
+
+void convertRgbToYuv420Reference(const uint8_t* rgb, int width, int height, RecordingPixelFormat format, uint8_t* out) {
+    const size_t pixelCount = static_cast<size_t>(width) * static_cast<size_t>(height);
+    const int chromaWidth = width / 2;
+    const int chromaHeight = height / 2;
+    constexpr float inv255 = 1.0f / 255.0f;
+
+    uint8_t* yPlane = out;
+    for (size_t i = 0; i < pixelCount; ++i) {
+        yPlane[i] = lumaByte(rgb[i * 3] * inv255, rgb[i * 3 + 1] * inv255, rgb[i * 3 + 2] * inv255);
+    }
+
+    uint8_t* chroma = out + pixelCount;
+    const size_t chromaCount = static_cast<size_t>(chromaWidth) * static_cast<size_t>(chromaHeight);
+    for (int cy = 0; cy < chromaHeight; ++cy) {
+        for (int cx = 0; cx < chromaWidth; ++cx) {
+            float r = 0.0f, g = 0.0f, b = 0.0f;
+            for (int dy = 0; dy < 2; ++dy) {
+                for (int dx = 0; dx < 2; ++dx) {
+                    const size_t p = (static_cast<size_t>(cy * 2 + dy) * width + (cx * 2 + dx)) * 3;
+                    r += rgb[p];
+                    g += rgb[p + 1];
+                    b += rgb[p + 2];
+                }
+            }
+            r *= 0.25f * inv255;
+            g *= 0.25f * inv255;
+            b *= 0.25f * inv255;
+
+            const size_t c = static_cast<size_t>(cy) * chromaWidth + cx;
+            if (format == RecordingPixelFormat::NV12) {
+                chroma[c * 2] = cbByte(r, g, b);
+                chroma[c * 2 + 1] = crByte(r, g, b);
+            } else {
+                chroma[c] = cbByte(r, g, b);
+                chroma[chromaCount + c] = crByte(r, g, b);
+            }
+        }
+    }
+}
+
+void convertRgbToYuv444(const uint8_t* rgb, int width, int height, uint8_t* out) {
+    const size_t pixelCount = static_cast<size_t>(width) * static_cast<size_t>(height);
+    constexpr float inv255 = 1.0f / 255.0f;
+
+    uint8_t* yPlane = out;
+    uint8_t* uPlane = yPlane + pixelCount;
+    uint8_t* vPlane = uPlane + pixelCount;
+    for (size_t i = 0; i < pixelCount; ++i) {
+        const float r = rgb[i * 3] * inv255;
+        const float g = rgb[i * 3 + 1] * inv255;
+        const float b = rgb[i * 3 + 2] * inv255;
+        yPlane[i] = lumaByte(r, g, b);
+        uPlane[i] = cbByte(r, g, b);
+        vPlane[i] = crByte(r, g, b);
+    }
+}
+
+void convertNv12ToI420(const uint8_t* nv12, int width, int height, uint8_t* out) {
+    const size_t pixelCount = static_cast<size_t>(width) * static_cast<size_t>(height);
+    const size_t chromaCount = pixelCount / 4;
+    std::memcpy(out, nv12, pixelCount);
+
+    const uint8_t* uv = nv12 + pixelCount;
+    uint8_t* u = out + pixelCount;
+    uint8_t* v = u + chromaCount;
+    for (size_t i = 0; i < chromaCount; ++i) {
+        u[i] = uv[i * 2];
+        v[i] = uv[i * 2 + 1];
+    }
+}
+
+} // namespace ofxMarkSynth
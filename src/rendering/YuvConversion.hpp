@@ -0,0 +1,42 @@
+//
+//  YuvConversion.hpp
+//  ofxMarkSynth
+//
+//  Pixel formats for recording readback, and the CPU reference for the RgbToYuvShader
+//  conversion (BT.709, limited range, 2x2 box-filtered chroma).
+//
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+
+namespace ofxMarkSynth {
+
+enum class RecordingPixelFormat {
+    RGB24,   // 3 bytes/pixel, colour conversion left to the encoder
+    I420,    // Planar Y, U, V at 4:2:0 (1.5 bytes/pixel)
+    NV12     // Planar Y, interleaved UV at 4:2:0 (1.5 bytes/pixel)
+};
+
+std::optional<RecordingPixelFormat> parseRecordingPixelFormat(const std::string& name);
+const char* getRecordingPixelFormatName(RecordingPixelFormat format);
+
+/// ffmpeg -pix_fmt name for raw frames in this format.
+const char* getFfmpegPixelFormat(RecordingPixelFormat format);
+
+/// Bytes in one frame of this format. YUV formats require even width and height.
+size_t getRecordingFrameByteSize(RecordingPixelFormat format, int width, int height);
+
+/// CPU reference: convert tightly packed RGB24 to I420 or NV12 (out must hold getRecordingFrameByteSize bytes).
+void convertRgbToYuv420Reference(const uint8_t* rgb, int width, int height, RecordingPixelFormat format, uint8_t* out);
+
+/// Convert tightly packed RGB24 to planar 4:4:4 Y, U, V with the same matrix (out must hold 3 bytes per pixel).
+void convertRgbToYuv444(const uint8_t* rgb, int width, int height, uint8_t* out);
+
+/// Copy an NV12 frame into I420 layout (chroma de-interleave only, no colour conversion).
+void convertNv12ToI420(const uint8_t* nv12, int width, int height, uint8_t* out);
+
+} // namespace ofxMarkSynth
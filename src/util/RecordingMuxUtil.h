@@ -14,6 +14,7 @@
 #include <vector>
 
 #include "ofMain.h"
+#include "rendering/RenderingConstants.h"
 
 #include <fcntl.h>
 #include <sys/types.h>
@@ -22,9 +23,15 @@
 
 namespace ofxMarkSynth {
 
+// The y4m fallback (no ffmpeg while recording) holds raw frames that can't be stream-copied into mp4
+inline bool isRawY4mVideo(const std::filesystem::path& videoPath) {
+  return videoPath.extension() == ".y4m";
+}
+
 inline std::filesystem::path getMuxedVideoPath(const std::filesystem::path& videoPath) {
   auto out = videoPath;
-  out.replace_filename(videoPath.stem().string() + "-muxed" + videoPath.extension().string());
+  const std::string extension = isRawY4mVideo(videoPath) ? ".mp4" : videoPath.extension().string();
+  out.replace_filename(videoPath.stem().string() + "-muxed" + extension);
   return out;
 }
 
@@ -34,6 +41,12 @@ inline std::filesystem::path getMuxLogPath(const std::filesystem::path& videoPat
   return out;
 }
 
+inline std::filesystem::path getRecordingStatsPath(const std::filesystem::path& videoPath) {
+  auto out = videoPath;
+  out.replace_filename(videoPath.stem().string() + "-stats.json");
+  return out;
+}
+
 inline bool spawnDetachedMuxProcess(const std::filesystem::path& ffmpegPath,
                                    const std::filesystem::path& videoPath,
                                    const std::filesystem::path& audioPath,
@@ -137,12 +150,25 @@ inline bool spawnDetachedMuxProcess(const std::filesystem::path& ffmpegPath,
       "-y",
       "-i", videoPath.string(),
       "-i", audioPath.string(),
-      "-c:v", "copy",
+  };
+  if (isRawY4mVideo(videoPath)) {
+    // y4m is already BT.709 limited range (see FramePipeEncoder); encode as the ffmpeg pipe would
+    args.insert(args.end(), {
+        "-c:v", LINUX_VIDEO_CODEC,
+        "-preset", LINUX_VIDEO_PRESET,
+        "-b:v", std::to_string(DEFAULT_VIDEO_BITRATE) + "k",
+        "-pix_fmt", "yuv420p",
+        "-color_range", "tv", "-colorspace", "bt709", "-color_primaries", "bt709", "-color_trc", "bt709",
+    });
+  } else {
+    args.insert(args.end(), { "-c:v", "copy" });
+  }
+  args.insert(args.end(), {
       "-c:a", "aac",
       "-b:a", bitrateArg,
       "-shortest",
       outputPath.string(),
-  };
+  });
 
   std::vector<char*> argv;
   argv.reserve(args.size() + 1);
@@ -18,6 +18,12 @@
 
 #include "config/ModFactory.hpp"
 #include "core/FontStash2Cache.hpp"
+#include "core/MemoryBank.hpp"
+#include "rendering/AsyncImageSaver.hpp"
+#include "rendering/GpuMemoryRegistry.hpp"
+#include "rendering/RecordingStats.hpp"
+#include "rendering/RenderingConstants.h"
+#include "rendering/YuvConversion.hpp"
 #include "util/SessionConfigUtil.h"
 
 namespace ofxMarkSynth {
@@ -135,6 +141,27 @@ inline std::optional<int> parseTonemapTypeString(const std::string& tonemapStr)
   return std::nullopt;
 }
 
+inline std::optional<GpuMemoryRegistry::BudgetPolicy> parseGpuMemoryBudgetPolicyString(const std::string& policyStr) {
+  const std::string s = normalizeEnumKey(policyStr);
+
+  if (s == "warn") return GpuMemoryRegistry::BudgetPolicy::Warn;
+  if (s == "downscale") return GpuMemoryRegistry::BudgetPolicy::Downscale;
+  if (s == "refuse") return GpuMemoryRegistry::BudgetPolicy::Refuse;
+
+  return std::nullopt;
+}
+
+inline std::optional<ExrCompression> parseExrCompressionString(const std::string& compressionStr) {
+  const std::string s = normalizeEnumKey(compressionStr);
+
+  if (s == "none") return ExrCompression::None;
+  if (s == "zips") return ExrCompression::Zips;
+  if (s == "zip") return ExrCompression::Zip;
+  if (s == "piz") return ExrCompression::Piz;
+
+  return std::nullopt;
+}
+
 inline void applySessionRuntimeSettings(const ofJson& sessionJson) {
   const float frameRate = getFloatValue(sessionJson, "frameRate").value_or(30.0f);
   ofSetFrameRate(frameRate);
@@ -161,6 +188,19 @@ inline void applySessionRuntimeSettings(const ofJson& sessionJson) {
       ofLogToConsole();
     }
   }
+
+  // GPU memory budget applies process-wide, before any FBOs are allocated
+  const float gpuMemoryBudgetMB = getFloatValue(sessionJson, "gpuMemoryBudgetMB").value_or(0.0f);
+  auto gpuMemoryBudgetPolicy = GpuMemoryRegistry::BudgetPolicy::Warn;
+  if (auto policyStrOpt = getStringValue(sessionJson, "gpuMemoryBudgetPolicy"); policyStrOpt && !policyStrOpt->empty()) {
+    if (auto policyOpt = parseGpuMemoryBudgetPolicyString(*policyStrOpt)) {
+      gpuMemoryBudgetPolicy = *policyOpt;
+    } else {
+      ofLogWarning("SessionResourceUtil") << "Unknown gpuMemoryBudgetPolicy: " << *policyStrOpt;
+    }
+  }
+  GpuMemoryRegistry::instance().setBudget(static_cast<size_t>(std::max(0.0f, gpuMemoryBudgetMB) * 1024.0f * 1024.0f),
+                                          gpuMemoryBudgetPolicy);
 }
 
 inline ResourceManager buildResourceManagerFromSessionConfig(const SessionConfig& sessionConfig) {
@@ -257,6 +297,29 @@ inline ResourceManager buildResourceManagerFromSessionConfig(const SessionConfig
   resources.add("compositePanelGapPx", *compositePanelGapPxOpt);
   resources.add("recorderCompositeSize", *recorderCompositeSizeOpt);
   resources.add("ffmpegBinaryPath", expandUserPath(*ffmpegBinaryPathStrOpt));
+  resources.add("recorderPboCount", getIntValue(sessionJson, "recorderPboCount").value_or(DEFAULT_RECORDER_PBO_COUNT));
+
+  RecordingPixelFormat recorderPixelFormat = RecordingPixelFormat::RGB24;
+  if (auto pixelFormatStrOpt = getStringValue(sessionJson, "recorderPixelFormat"); pixelFormatStrOpt && !pixelFormatStrOpt->empty()) {
+    if (auto formatOpt = parseRecordingPixelFormat(*pixelFormatStrOpt)) {
+      recorderPixelFormat = *formatOpt;
+    } else {
+      ofLogWarning("SessionResourceUtil") << "Unknown recorderPixelFormat: '" << *pixelFormatStrOpt
+                                          << "' (expected rgb, i420, nv12)";
+    }
+  }
+  resources.add("recorderPixelFormat", recorderPixelFormat);
+
+  RecordingBackpressurePolicy recorderBackpressurePolicy = RecordingBackpressurePolicy::Drop;
+  if (auto policyStrOpt = getStringValue(sessionJson, "recorderBackpressurePolicy"); policyStrOpt && !policyStrOpt->empty()) {
+    if (auto policyOpt = parseRecordingBackpressurePolicy(*policyStrOpt)) {
+      recorderBackpressurePolicy = *policyOpt;
+    } else {
+      ofLogWarning("SessionResourceUtil") << "Unknown recorderBackpressurePolicy: '" << *policyStrOpt
+                                          << "' (expected drop, block, duplicate)";
+    }
+  }
+  resources.add("recorderBackpressurePolicy", recorderBackpressurePolicy);
 
   // Startup performance config name (may be empty)
   if (auto startupNameOpt = getStringValue(sessionJson, "startupPerformanceConfigName")) {
@@ -290,6 +353,42 @@ inline ResourceManager buildResourceManagerFromSessionConfig(const SessionConfig
   resources.add("autoSnapshotsIntervalSec", autoSnapshotsIntervalSec);
   resources.add("autoSnapshotsJitterSec", autoSnapshotsJitterSec);
 
+  ExrCompression snapshotExrCompression = ExrCompression::Zip;
+  if (auto compressionStrOpt = getStringValue(sessionJson, "snapshotExrCompression"); compressionStrOpt && !compressionStrOpt->empty()) {
+    if (auto compressionOpt = parseExrCompressionString(*compressionStrOpt)) {
+      snapshotExrCompression = *compressionOpt;
+    } else {
+      ofLogWarning("SessionResourceUtil") << "Unknown snapshotExrCompression: '" << *compressionStrOpt
+                                          << "' (expected none, zips, zip, piz)";
+    }
+  }
+  resources.add("snapshotExrCompression", snapshotExrCompression);
+
+  // Oversize still ('L'): multiple of the composite size
+  resources.add("tiledStillScale", std::clamp(getIntValue(sessionJson, "tiledStillScale").value_or(DEFAULT_TILED_STILL_SCALE),
+                                              1, MAX_TILED_STILL_SCALE));
+
+  // Memory bank: number of slots (texture array layers) and slot size
+  resources.add("memoryBankSlotCount", std::clamp(getIntValue(sessionJson, "memoryBankSlotCount").value_or(MemoryBank::DEFAULT_SLOT_COUNT),
+                                                  MemoryBank::MIN_SLOT_COUNT, MemoryBank::MAX_SLOT_COUNT));
+  resources.add("memoryBankSlotSize", getVec2Value(sessionJson, "memoryBankSlotSize").value_or(glm::vec2 { 1024, 1024 }));
+  resources.add("memoryArchiveRamMB", std::max(0, getIntValue(sessionJson, "memoryArchiveRamMB").value_or(256)));
+  resources.add("memoryArchiveMaxDiskEntries", std::max(0, getIntValue(sessionJson, "memoryArchiveMaxDiskEntries").value_or(4000)));
+
+  // Debug view (Gui FBO tab) refresh
+  const float debugViewRefreshHz = getFloatValue(sessionJson, "debugViewRefreshHz").value_or(5.0f);
+  const bool debugViewRoundRobin = getBoolValue(sessionJson, "debugViewRoundRobin").value_or(false);
+  resources.add("debugViewRefreshHz", debugViewRefreshHz);
+  resources.add("debugViewRoundRobin", debugViewRoundRobin);
+
+  // Per-Mod update telemetry
+  const bool telemetryEnabled = getBoolValue(sessionJson, "telemetryEnabled").value_or(false);
+  resources.add("telemetryEnabled", telemetryEnabled);
+
+  // Loop rate while fully hibernated (0 keeps the normal rate), and the rate to restore on wake
+  resources.add("deepIdleFrameRate", std::max(0.0f, getFloatValue(sessionJson, "deepIdleFrameRate").value_or(5.0f)));
+  resources.add("frameRate", getFloatValue(sessionJson, "frameRate").value_or(30.0f));
+
   // === TEXT/FONT RESOURCES ===
   const auto fontFileOpt = getStringValue(sessionJson, "fontFile");
   const auto textSourcesDirOpt = getStringValue(sessionJson, "textSourcesDir");
@@ -0,0 +1,150 @@
+//
+//  DensityMetricsTest.cpp
+//  ofxMarkSynth
+//
+//  Checks the vectorized DensityMetrics paths against scalar references: the original two-pass
+//  RGB8 code, and a half-float version of it that decodes halves bit by bit. Pixel counts cover
+//  the 16-pixel SIMD steps, the BLOCK_PIXELS blocks and their scalar tails.
+//
+
+#include "rendering/DensityMetrics.hpp"
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <vector>
+
+using namespace ofxMarkSynth;
+
+namespace {
+
+constexpr float ACTIVE_EPSILON = 0.02f;
+constexpr double VARIANCE_ABS = 1e-6;
+constexpr double VARIANCE_REL = 1e-4;
+constexpr double ACTIVE_FRACTION_ABS = 1e-3;  // Pixels within float rounding of the epsilon may flip
+
+const size_t PIXEL_COUNTS[] = { 1, 2, 7, 15, 16, 17, 31, 33, 1000, 1023, 1024, 1025, 2049, 3 * 1024 + 5, 256 * 256, 100003 };
+
+int failures = 0;
+
+void check(bool ok, const char* what, size_t pixelCount, double actual, double expected) {
+    if (ok) return;
+    failures++;
+    std::printf("FAIL %s (%zu pixels): %.9g, expected %.9g\n", what, pixelCount, actual, expected);
+}
+
+void compare(const char* name, size_t pixelCount, const DensityMetrics& actual, const DensityMetrics& expected) {
+    const double varianceTolerance = VARIANCE_ABS + VARIANCE_REL * expected.variance;
+    check(std::abs(actual.variance - expected.variance) <= varianceTolerance, name, pixelCount, actual.variance, expected.variance);
+    check(std::abs(actual.activeFraction - expected.activeFraction) <= ACTIVE_FRACTION_ABS, name, pixelCount,
+          actual.activeFraction, expected.activeFraction);
+}
+
+float halfToFloat(uint16_t h) {
+    const int exponent = (h >> 10) & 0x1f;
+    const int mantissa = h & 0x3ff;
+    float value;
+    if (exponent == 0) {
+        value = std::ldexp(static_cast<float>(mantissa), -24);
+    } else {
+        value = std::ldexp(static_cast<float>(mantissa | 0x400), exponent - 25);
+    }
+    return (h & 0x8000) ? -value : value;
+}
+
+// computeDensityMetricsRgb8Reference with half-float input
+DensityMetrics rgb16fReference(const uint16_t* rgb, size_t pixelCount, float activeEpsilon) {
+    const auto luma = [rgb](size_t i) {
+        return 0.2126f * halfToFloat(rgb[3 * i + 0]) + 0.7152f * halfToFloat(rgb[3 * i + 1]) + 0.0722f * halfToFloat(rgb[3 * i + 2]);
+    };
+    double mean = 0.0;
+    for (size_t i = 0; i < pixelCount; ++i) mean += luma(i);
+    mean /= static_cast<double>(pixelCount);
+
+    double var = 0.0;
+    size_t activeCount = 0;
+    for (size_t i = 0; i < pixelCount; ++i) {
+        const float d = luma(i) - static_cast<float>(mean);
+        var += static_cast<double>(d) * static_cast<double>(d);
+        if (std::abs(d) > activeEpsilon) activeCount++;
+    }
+
+    DensityMetrics out;
+    out.variance = static_cast<float>(var / static_cast<double>(pixelCount));
+    out.activeFraction = static_cast<float>(activeCount) / static_cast<float>(pixelCount);
+    return out;
+}
+
+void testRgb8(std::mt19937& rng) {
+    std::uniform_int_distribution<int> byte(0, 255);
+    for (size_t pixelCount : PIXEL_COUNTS) {
+        std::vector<uint8_t> uniform(pixelCount * 3);
+        for (size_t i = 0; i < pixelCount; ++i) {
+            uniform[3 * i + 0] = 200;
+            uniform[3 * i + 1] = 40;
+            uniform[3 * i + 2] = 90;
+        }
+        compare("rgb8 uniform", pixelCount, computeDensityMetricsRgb8(uniform.data(), pixelCount, ACTIVE_EPSILON),
+                computeDensityMetricsRgb8Reference(uniform.data(), pixelCount, ACTIVE_EPSILON));
+
+        std::vector<uint8_t> random(pixelCount * 3);
+        for (auto& v : random) v = static_cast<uint8_t>(byte(rng));
+        compare("rgb8 random", pixelCount, computeDensityMetricsRgb8(random.data(), pixelCount, ACTIVE_EPSILON),
+                computeDensityMetricsRgb8Reference(random.data(), pixelCount, ACTIVE_EPSILON));
+
+        // Mostly flat with sparse marks, like an early composite
+        std::vector<uint8_t> sparse(pixelCount * 3, 8);
+        for (size_t i = 0; i < pixelCount; i += 37) {
+            sparse[3 * i + 1] = static_cast<uint8_t>(byte(rng));
+        }
+        compare("rgb8 sparse", pixelCount, computeDensityMetricsRgb8(sparse.data(), pixelCount, ACTIVE_EPSILON),
+                computeDensityMetricsRgb8Reference(sparse.data(), pixelCount, ACTIVE_EPSILON));
+    }
+}
+
+void testRgb16f(std::mt19937& rng) {
+    // Positive halves below 2.0, subnormals included
+    std::uniform_int_distribution<int> exponent(0, 15);
+    std::uniform_int_distribution<int> mantissa(0, 0x3ff);
+    const auto randomHalf = [&] { return static_cast<uint16_t>((exponent(rng) << 10) | mantissa(rng)); };
+
+    for (size_t pixelCount : PIXEL_COUNTS) {
+        std::vector<uint16_t> uniform(pixelCount * 3);
+        for (size_t i = 0; i < pixelCount; ++i) {
+            uniform[3 * i + 0] = 0x3c00;  // 1.0
+            uniform[3 * i + 1] = 0x3800;  // 0.5
+            uniform[3 * i + 2] = 0x0001;  // Smallest subnormal
+        }
+        compare("rgb16f uniform", pixelCount, computeDensityMetricsRgb16f(uniform.data(), pixelCount, ACTIVE_EPSILON),
+                rgb16fReference(uniform.data(), pixelCount, ACTIVE_EPSILON));
+
+        std::vector<uint16_t> random(pixelCount * 3);
+        for (auto& v : random) v = randomHalf();
+        compare("rgb16f random", pixelCount, computeDensityMetricsRgb16f(random.data(), pixelCount, ACTIVE_EPSILON),
+                rgb16fReference(random.data(), pixelCount, ACTIVE_EPSILON));
+    }
+}
+
+void testEmpty() {
+    const DensityMetrics rgb8 = computeDensityMetricsRgb8(nullptr, 0, ACTIVE_EPSILON);
+    const DensityMetrics rgb16f = computeDensityMetricsRgb16f(nullptr, 0, ACTIVE_EPSILON);
+    check(rgb8.variance == 0.0f && rgb8.activeFraction == 0.0f, "rgb8 empty", 0, rgb8.variance, 0.0);
+    check(rgb16f.variance == 0.0f && rgb16f.activeFraction == 0.0f, "rgb16f empty", 0, rgb16f.variance, 0.0);
+}
+
+} // namespace
+
+int main() {
+    std::mt19937 rng(1234);
+    testEmpty();
+    testRgb8(rng);
+    testRgb16f(rng);
+
+    if (failures > 0) {
+        std::printf("%d DensityMetrics check(s) failed\n", failures);
+        return 1;
+    }
+    std::printf("DensityMetrics: all checks passed\n");
+    return 0;
+}